@@ -0,0 +1,809 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+/**
+ * Benchmarks for libdstructs. Every operation of every container is run at
+ * sizes 10, 100, ... up to a maximum, and reported as one CSV row per
+ * container, operation and size:
+ *
+ * container,op,size,ops,ns_per_op,p50_ns,p90_ns,p99_ns,max_ns
+ *
+ * Cheap operations are timed in batches of BATCH, so the latency columns are
+ * percentiles of the mean time per operation over each batch; small containers
+ * are filled and emptied repeatedly to reach MIN_OPS. Operations that visit the
+ * whole container are timed one at a time once it holds MIN_VISITS elements,
+ * and repeated only as often as WORK allows. With -H file, a latency histogram
+ * with power-of-two buckets is also written to file, one row per non-empty
+ * bucket:
+ *
+ * container,op,size,lo_ns,hi_ns,count
+ *
+ * Usage: bench [-m max_size] [-f filter] [-H histogram.csv]
+ *
+ * max_size defaults to 10^6 and may be up to 10^8. -f runs only the benchmarks
+ * whose "container,op" contains filter.
+ **/
+#define _POSIX_C_SOURCE 199309L  /* For clock_gettime(...) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vector.h"
+#include "list.h"
+#include "ulist.h"
+#include "queue.h"
+#include "cqueue.h"
+#include "stack.h"
+#include "tree.h"
+#include "hashtable.h"
+#include "heap.h"
+#include "priority-queue.h"
+#include "set.h"
+#include "template.h"
+
+
+#define BATCH 32           /* Cheap operations timed together */
+#define WORK 10000000L     /* Element visits allowed per O(n) benchmark */
+#define MIN_OPS 100000     /* Fewest operations timed per O(1) benchmark */
+#define MIN_VISITS 1024    /* Fewest element visits per O(n) sample */
+#define MAX_REPS 100000    /* Most repetitions of an O(n) operation */
+#define DEF_SIZE 1000000   /* Default largest size */
+#define MAX_SIZE 100000000 /* Largest size accepted by -m */
+#define BUCKETS 40         /* Histogram buckets: [2^b, 2^(b+1)) ns */
+
+
+/**
+ * A container as seen by the benchmarks. add(...) and rem(...) work at the
+ * container's natural ends (push and pop, or enqueue and dequeue), named by
+ * addop and remop; containers without ends remove whichever element is
+ * cheapest to find. Operations a container lacks are NULL. linear is set if
+ * get(...) walks the container rather than indexing it; keyed containers'
+ * get(...) looks up the element equal to index instead. contains(...) tests
+ * membership of an element.
+ **/
+typedef struct adapter_s {
+   const char *name;
+   const char *addop;
+   const char *remop;
+   int linear;
+   void* (*init)(int n);
+   void (*free)(void* c);
+   int (*size)(void* c);
+   void (*add)(void* c, void* elem);
+   void* (*rem)(void* c);
+   void* (*get)(void* c, int index);
+   int (*indexof)(void* c, void* elem);
+   void (*apply)(void* c, void (*funct)(void* const));
+   void** (*toarr)(void* c);
+   size_t (*view)(void* c);
+   int (*contains)(void* c, void* elem);
+} adapter_t;
+
+
+/**
+ * State of one benchmark run. vals holds the integers 0 to n-1 and elems
+ * points at them. Containers are always drained before they are freed, so
+ * the elements are never freed themselves.
+ *
+ * Every TICK(...) counts a completed operation; once batch of them have
+ * completed, their mean duration is recorded as a sample.
+ **/
+typedef struct run_s {
+   const adapter_t *a;
+   int n;
+   int *vals;
+   void **elems;
+   long ops;
+   int batch;
+   int pending;
+   double mark;
+   double total;
+   double *samples;
+   long nsamples;
+   long cap;
+} run_t;
+
+
+/* A benchmark: the operation's name and the function running it */
+typedef struct op_s {
+   const char *name;
+   void (*run)(run_t* const r, void* c);
+} op_t;
+
+
+/* Count a completed operation */
+#define TICK(r) do { if(++(r)->pending == (r)->batch) __sample(r); } while(0)
+
+
+/* Keeps the optimizer from discarding results */
+static volatile long sink;
+
+/* State of the index generator */
+static unsigned long seed = 88172645UL;
+
+
+
+/** Timing **/
+
+/**
+ * Current time in nanoseconds.
+ **/
+static double __now(void) {
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+
+/**
+ * Record the mean duration of the pending operations as one sample.
+ **/
+static void __sample(run_t* const r) {
+   double now, *samples;
+
+   now = __now();
+
+   if(r->nsamples == r->cap) {
+      r->cap = (r->cap ? r->cap * 2 : 1024);
+      samples = realloc(r->samples, sizeof(double) * r->cap);
+
+      if(!samples) {
+         fprintf(stderr, "bench: out of memory\n");
+         exit(EXIT_FAILURE);
+      }
+
+      r->samples = samples;
+   }
+
+   r->samples[r->nsamples++] = (now - r->mark) / r->pending;
+   r->total += now - r->mark;
+   r->ops += r->pending;
+   r->pending = 0;
+   r->mark = __now();
+}
+
+
+/**
+ * Start timing, recording a sample every batch operations.
+ **/
+static void __begin(run_t* const r, int batch) {
+   r->batch = batch;
+   r->pending = 0;
+   r->mark = __now();
+}
+
+
+/**
+ * Stop timing, recording any partial batch.
+ **/
+static void __end(run_t* const r) {
+   if(r->pending)
+      __sample(r);
+}
+
+
+/**
+ * A pseudo-random index in [0, n) (xorshift). Cheap enough to call inside a
+ * timed loop.
+ **/
+static int __rand(int n) {
+   seed ^= (seed << 13) & 0xffffffffUL;
+   seed ^= seed >> 17;
+   seed ^= (seed << 5) & 0xffffffffUL;
+
+   return (int) (seed % (unsigned long) n);
+}
+
+
+/**
+ * Repetitions of an operation visiting all n elements that fit in WORK.
+ **/
+static int __reps(int n) {
+   long reps;
+
+   reps = WORK / n;
+
+   return (int) (reps < 1 ? 1 : reps > MAX_REPS ? MAX_REPS : reps);
+}
+
+
+/**
+ * Batch size for an operation visiting all n elements, so that a sample
+ * covers at least MIN_VISITS element visits.
+ **/
+static int __batch(int n) {
+   return (n >= MIN_VISITS ? 1 : MIN_VISITS / n);
+}
+
+
+/**
+ * Rounds of n operations needed to time at least MIN_OPS of them.
+ **/
+static int __rounds(int n) {
+   return (n >= MIN_OPS ? 1 : MIN_OPS / n);
+}
+
+
+/* Element function for the apply benchmarks */
+static void __visit(void* const elem) {
+   sink += *(int*) elem;
+}
+
+
+
+/** Operations **/
+
+/* Fill a container with the run's n elements, untimed */
+static void __fill(run_t* const r, void* c) {
+   int i;
+
+   for(i = 0; i < r->n; i++)
+      r->a->add(c, r->elems[i]);
+}
+
+/* Empty a container, untimed */
+static void __drain(run_t* const r, void* c) {
+   while(r->a->size(c) > 0)
+      r->a->rem(c);
+}
+
+static void op_add(run_t* const r, void* c) {
+   int i, k, rounds;
+
+   rounds = __rounds(r->n);
+
+   for(k = 0; k < rounds; k++) {
+      __begin(r, BATCH);
+
+      for(i = 0; i < r->n; i++) {
+         r->a->add(c, r->elems[i]);
+         TICK(r);
+      }
+
+      __end(r);
+      __drain(r, c);
+   }
+}
+
+static void op_rem(run_t* const r, void* c) {
+   int i, k, rounds;
+
+   rounds = __rounds(r->n);
+
+   for(k = 0; k < rounds; k++) {
+      __fill(r, c);
+      __begin(r, BATCH);
+
+      for(i = 0; i < r->n; i++) {
+         sink += *(int*) r->a->rem(c);
+         TICK(r);
+      }
+
+      __end(r);
+   }
+}
+
+static void op_get(run_t* const r, void* c) {
+   int i, reps;
+
+   __fill(r, c);
+   reps = (r->a->linear ? __reps(r->n) : r->n > MIN_OPS ? r->n : MIN_OPS);
+
+   __begin(r, (r->a->linear ? __batch(r->n) : BATCH));
+
+   for(i = 0; i < reps; i++) {
+      sink += *(int*) r->a->get(c, __rand(r->n));
+      TICK(r);
+   }
+
+   __end(r);
+}
+
+static void op_indexof(run_t* const r, void* c) {
+   int i, reps;
+
+   __fill(r, c);
+   reps = __reps(r->n);
+
+   __begin(r, __batch(r->n));
+
+   for(i = 0; i < reps; i++) {
+      sink += r->a->indexof(c, r->elems[__rand(r->n)]);
+      TICK(r);
+   }
+
+   __end(r);
+}
+
+static void op_contains(run_t* const r, void* c) {
+   int i, reps;
+
+   __fill(r, c);
+   reps = (r->n > MIN_OPS ? r->n : MIN_OPS);
+
+   __begin(r, BATCH);
+
+   for(i = 0; i < reps; i++) {
+      sink += r->a->contains(c, r->elems[__rand(r->n)]);
+      TICK(r);
+   }
+
+   __end(r);
+}
+
+static void op_apply(run_t* const r, void* c) {
+   int i, reps;
+
+   __fill(r, c);
+   reps = __reps(r->n);
+
+   __begin(r, __batch(r->n));
+
+   for(i = 0; i < reps; i++) {
+      r->a->apply(c, __visit);
+      TICK(r);
+   }
+
+   __end(r);
+}
+
+static void op_toarr(run_t* const r, void* c) {
+   int i, reps;
+
+   __fill(r, c);
+   reps = __reps(r->n);
+
+   __begin(r, __batch(r->n));
+
+   for(i = 0; i < reps; i++) {
+      free(r->a->toarr(c));
+      TICK(r);
+   }
+
+   __end(r);
+}
+
+static void op_view(run_t* const r, void* c) {
+   int i;
+
+   __fill(r, c);
+   __begin(r, BATCH);
+
+   for(i = 0; i < MIN_OPS; i++) {
+      sink += (long) r->a->view(c);
+      TICK(r);
+   }
+
+   __end(r);
+}
+
+
+
+/** Adapters **/
+
+static void* a_v_init(int n) { (void) n; return v_init(int); }
+static void* a_vi_init(int n) {
+   vect_t *v;
+
+   (void) n;
+
+   /* Integer callbacks let v_indexof(...) use the vectorized search */
+   if((v = v_init_inline(int)))
+      v_setops(v, &ds_ops_int);
+
+   return v;
+}
+static void a_v_free(void* c) { v_free(c); }
+static int a_v_size(void* c) { return v_size(c); }
+static void a_v_add(void* c, void* e) { v_push(c, e); }
+static void* a_v_rem(void* c) { return v_reml(c); }
+static void* a_v_get(void* c, int i) { return v_get(c, i); }
+static int a_v_indexof(void* c, void* e) { return v_indexof(c, e); }
+static void a_v_apply(void* c, void (*f)(void* const)) { v_apply(c, f); }
+static void** a_v_toarr(void* c) { return v_toarr(c); }
+static size_t a_v_view(void* c) { return v_span(c).len; }
+
+/* The typed vector; rem(...) hands back a copy kept in a scratch int */
+DS_VECTOR_DEFINE(bench_int, int)
+
+static int scratch;
+
+static void* a_tv_init(int n) { (void) n; return bench_int_vec_init(); }
+static void a_tv_free(void* c) { bench_int_vec_free(c); }
+static int a_tv_size(void* c) { return (int) bench_int_vec_size(c); }
+static void a_tv_add(void* c, void* e) { bench_int_vec_push(c, *(int*) e); }
+static void* a_tv_rem(void* c) {
+   return (bench_int_vec_pop(c, &scratch) ? &scratch : NULL);
+}
+static void* a_tv_get(void* c, int i) { return bench_int_vec_get(c, i); }
+static int a_tv_indexof(void* c, void* e) {
+   return (int) bench_int_vec_indexof(c, *(int*) e);
+}
+static void a_tv_apply(void* c, void (*f)(void* const)) {
+   ds_idx_t i;
+
+   for(i = 0; i < bench_int_vec_size(c); i++)
+      (f)(bench_int_vec_get(c, i));
+}
+static size_t a_tv_view(void* c) { return bench_int_vec_span(c).len; }
+
+static void* a_ll_init(int n) { (void) n; return ll_init(int); }
+static void* a_ll_slab_init(int n) { (void) n; return ll_init_slab(int, 0); }
+static void a_ll_free(void* c) { ll_free(c); }
+static int a_ll_size(void* c) { return ll_size(c); }
+static void a_ll_add(void* c, void* e) { ll_addl(c, e); }
+static void* a_ll_rem(void* c) { return ll_remf(c); }
+static void* a_ll_get(void* c, int i) { return ll_get(c, i); }
+static int a_ll_indexof(void* c, void* e) { return ll_indexof(c, e); }
+static void a_ll_apply(void* c, void (*f)(void* const)) { ll_apply(c, f); }
+static void** a_ll_toarr(void* c) { return ll_toarr(c); }
+
+static void* a_ul_init(int n) { (void) n; return ul_init(int); }
+static void a_ul_free(void* c) { ul_free(c); }
+static int a_ul_size(void* c) { return ul_size(c); }
+static void a_ul_add(void* c, void* e) { ul_addl(c, e); }
+static void* a_ul_rem(void* c) { return ul_remf(c); }
+static void* a_ul_get(void* c, int i) { return ul_get(c, i); }
+static int a_ul_indexof(void* c, void* e) { return ul_indexof(c, e); }
+static void a_ul_apply(void* c, void (*f)(void* const)) { ul_apply(c, f); }
+static void** a_ul_toarr(void* c) { return ul_toarr(c); }
+
+static void* a_q_init(int n) { (void) n; return q_init(int); }
+static void a_q_free(void* c) { q_free(c); }
+static int a_q_size(void* c) { return q_size(c); }
+static void a_q_add(void* c, void* e) { q_enq(c, e); }
+static void* a_q_rem(void* c) { return q_deq(c); }
+static void** a_q_toarr(void* c) { return q_toarr(c); }
+static size_t a_q_view(void* c) {
+   ds_span2_t view;
+
+   view = q_view(c);
+
+   return view.seg[0].len + view.seg[1].len;
+}
+
+static void* a_cq_init(int n) { return cq_init(int, (size_t) n); }
+static void a_cq_free(void* c) { cq_free(c); }
+static int a_cq_size(void* c) { return cq_size(c); }
+static void a_cq_add(void* c, void* e) { cq_tryenq(c, e); }
+static void* a_cq_rem(void* c) { return cq_trydeq(c); }
+
+static void* a_s_init(int n) { (void) n; return s_init(int); }
+static void a_s_free(void* c) { s_free(c); }
+static int a_s_size(void* c) { return s_size(c); }
+static void a_s_add(void* c, void* e) { s_push(c, e); }
+static void* a_s_rem(void* c) { return s_pop(c); }
+static void** a_s_toarr(void* c) { return s_toarr(c); }
+static size_t a_s_view(void* c) { return s_view(c).len; }
+
+static void* a_bst_init(int n) {
+   (void) n;
+
+   return bst_init_cmp(int, ds_cmp_int);
+}
+static void a_bst_free(void* c) { bst_free(c); }
+static int a_bst_size(void* c) { return bst_size(c); }
+static void a_bst_add(void* c, void* e) { bst_add(c, e); }
+static void* a_bst_rem(void* c) { return bst_rem(c, bst_root(c)); }
+static int a_bst_contains(void* c, void* e) { return bst_contains(c, e); }
+static void a_bst_apply(void* c, void (*f)(void* const)) { bst_apply(c, f); }
+static void** a_bst_toarr(void* c) { return bst_toarr(c); }
+
+/* Keys are the values themselves; rem(...) takes the next key, cyclically */
+static int ht_keys, ht_next;
+
+static void* a_ht_init(int n) {
+   ht_keys = n;
+   ht_next = 0;
+
+   return ht_init_ops(int, &ds_ops_int);
+}
+static void a_ht_free(void* c) { ht_free(c); }
+static int a_ht_size(void* c) { return ht_size(c); }
+static void a_ht_add(void* c, void* e) { ht_add(c, e, e); }
+static void* a_ht_rem(void* c) {
+   int key;
+
+   do {
+      key = ht_next;
+      ht_next = (ht_next + 1) % ht_keys;
+   } while(!ht_contains(c, &key));
+
+   return ht_rem(c, &key);
+}
+static void* a_ht_get(void* c, int i) { return ht_get(c, &i); }
+static int a_ht_contains(void* c, void* e) { return ht_contains(c, e); }
+static void a_ht_apply(void* c, void (*f)(void* const)) { ht_apply(c, f); }
+
+static void* a_hp_init(int n) { (void) n; return hp_init(int, ds_cmp_int); }
+static void a_hp_free(void* c) { hp_free(c); }
+static int a_hp_size(void* c) { return hp_size(c); }
+static void a_hp_add(void* c, void* e) { hp_push(c, e); }
+static void* a_hp_rem(void* c) { return hp_pop(c); }
+static void** a_hp_toarr(void* c) { return hp_toarr(c); }
+
+static void* a_pq_init(int n) { (void) n; return pq_init(int, ds_cmp_int); }
+static void a_pq_free(void* c) { pq_free(c); }
+static int a_pq_size(void* c) { return pq_size(c); }
+static void a_pq_add(void* c, void* e) { pq_enq(c, e); }
+static void* a_pq_rem(void* c) { return pq_deq(c); }
+static void** a_pq_toarr(void* c) { return pq_toarr(c); }
+
+/* Sets copy their elements; rem(...) hands back the last one in scratch */
+static void* a_set_init(int n) {
+   (void) n;
+
+   return set_init_ops(int, &ds_ops_int);
+}
+static void a_set_free(void* c) { set_free(c); }
+static int a_set_size(void* c) { return (int) set_size(c); }
+static void a_set_add(void* c, void* e) { set_add(c, e); }
+static void* a_set_rem(void* c) {
+   ds_span_t view;
+
+   view = set_view(c);
+
+   if(!view.len) return NULL;
+
+   scratch = *(int*) ((char*) view.data + (view.len - 1) * view.stride);
+   set_rem(c, &scratch);
+
+   return &scratch;
+}
+static int a_set_contains(void* c, void* e) { return set_contains(c, e); }
+static void a_set_apply(void* c, void (*f)(void* const)) {
+   ds_span_t view;
+   size_t i;
+
+   view = set_view(c);
+
+   for(i = 0; i < view.len; i++)
+      (f)((char*) view.data + i * view.stride);
+}
+static size_t a_set_view(void* c) { return set_view(c).len; }
+
+
+static const adapter_t adapters[] = {
+   { "vector", "push", "pop", 0, a_v_init, a_v_free, a_v_size, a_v_add,
+     a_v_rem, a_v_get, a_v_indexof, a_v_apply, a_v_toarr, a_v_view, NULL },
+   { "vector-inline", "push", "pop", 0, a_vi_init, a_v_free, a_v_size,
+     a_v_add, a_v_rem, a_v_get, a_v_indexof, a_v_apply, a_v_toarr,
+     a_v_view, NULL },
+   { "vector-typed", "push", "pop", 0, a_tv_init, a_tv_free, a_tv_size,
+     a_tv_add, a_tv_rem, a_tv_get, a_tv_indexof, a_tv_apply, NULL,
+     a_tv_view, NULL },
+   { "list", "enq", "deq", 1, a_ll_init, a_ll_free, a_ll_size, a_ll_add,
+     a_ll_rem, a_ll_get, a_ll_indexof, a_ll_apply, a_ll_toarr, NULL, NULL },
+   { "list-slab", "enq", "deq", 1, a_ll_slab_init, a_ll_free, a_ll_size,
+     a_ll_add, a_ll_rem, a_ll_get, a_ll_indexof, a_ll_apply, a_ll_toarr,
+     NULL, NULL },
+   { "ulist", "enq", "deq", 1, a_ul_init, a_ul_free, a_ul_size, a_ul_add,
+     a_ul_rem, a_ul_get, a_ul_indexof, a_ul_apply, a_ul_toarr, NULL, NULL },
+   { "queue", "enq", "deq", 0, a_q_init, a_q_free, a_q_size, a_q_add,
+     a_q_rem, NULL, NULL, NULL, a_q_toarr, a_q_view, NULL },
+   { "cqueue", "enq", "deq", 0, a_cq_init, a_cq_free, a_cq_size, a_cq_add,
+     a_cq_rem, NULL, NULL, NULL, NULL, NULL, NULL },
+   { "stack", "push", "pop", 0, a_s_init, a_s_free, a_s_size, a_s_add,
+     a_s_rem, NULL, NULL, NULL, a_s_toarr, a_s_view, NULL },
+   { "bst", "add", "rem", 0, a_bst_init, a_bst_free, a_bst_size, a_bst_add,
+     a_bst_rem, NULL, NULL, a_bst_apply, a_bst_toarr, NULL, a_bst_contains },
+   { "hashtable", "add", "rem", 0, a_ht_init, a_ht_free, a_ht_size,
+     a_ht_add, a_ht_rem, a_ht_get, NULL, a_ht_apply, NULL, NULL,
+     a_ht_contains },
+   { "heap", "push", "pop", 0, a_hp_init, a_hp_free, a_hp_size, a_hp_add,
+     a_hp_rem, NULL, NULL, NULL, a_hp_toarr, NULL, NULL },
+   { "priority-queue", "enq", "deq", 0, a_pq_init, a_pq_free, a_pq_size,
+     a_pq_add, a_pq_rem, NULL, NULL, NULL, a_pq_toarr, NULL, NULL },
+   { "set", "add", "rem", 0, a_set_init, a_set_free, a_set_size, a_set_add,
+     a_set_rem, NULL, NULL, a_set_apply, NULL, a_set_view, a_set_contains }
+};
+
+#define NADAPTERS ((int) (sizeof(adapters) / sizeof(adapters[0])))
+
+
+
+/** Reporting **/
+
+static int __cmp_double(const void* a, const void* b) {
+   double x, y;
+
+   x = *(const double*) a;
+   y = *(const double*) b;
+
+   return (x > y) - (x < y);
+}
+
+/* The p'th percentile of sorted samples */
+static double __pct(run_t* const r, double p) {
+   long i;
+
+   i = (long) (p / 100.0 * (double) (r->nsamples - 1) + 0.5);
+
+   return r->samples[i];
+}
+
+
+/**
+ * Print the CSV row (and histogram rows) of a finished run.
+ **/
+static void __report(run_t* const r, const char* op, FILE* hist) {
+   long counts[BUCKETS];
+   double lo;
+   long i;
+   int b;
+
+   if(!r->nsamples) return;
+
+   qsort(r->samples, (size_t) r->nsamples, sizeof(double), __cmp_double);
+
+   printf("%s,%s,%d,%ld,%.2f,%.2f,%.2f,%.2f,%.2f\n", r->a->name, op, r->n,
+          r->ops, r->total / (double) r->ops, __pct(r, 50), __pct(r, 90),
+          __pct(r, 99), r->samples[r->nsamples - 1]);
+
+   if(!hist) return;
+
+   memset(counts, 0, sizeof(counts));
+
+   for(i = 0; i < r->nsamples; i++) {
+      for(b = 0, lo = 2; b < BUCKETS - 1 && r->samples[i] >= lo; b++)
+         lo *= 2;
+
+      counts[b]++;
+   }
+
+   for(b = 0, lo = 1; b < BUCKETS; b++, lo *= 2)
+      if(counts[b])
+         fprintf(hist, "%s,%s,%d,%.0f,%.0f,%ld\n", r->a->name, op, r->n,
+                 (b ? lo : 0), lo * 2, counts[b]);
+}
+
+
+/**
+ * Run one operation of one container at one size, if the container
+ * supports it and it passes the filter.
+ **/
+static void __run(run_t* const r, const op_t* const op, const char* filter,
+                  FILE* hist) {
+   char name[64];
+   void *c;
+
+   sprintf(name, "%s,%s", r->a->name, op->name);
+
+   if(filter && !strstr(name, filter)) return;
+
+   if(!(c = r->a->init(r->n))) {
+      fprintf(stderr, "bench: cannot create %s of %d\n", r->a->name, r->n);
+      return;
+   }
+
+   r->ops = 0;
+   r->total = 0;
+   r->nsamples = 0;
+
+   op->run(r, c);
+
+   /* Drain, so that freeing the container leaves the elements alone */
+   __drain(r, c);
+
+   r->a->free(c);
+
+   __report(r, op->name, hist);
+   fflush(stdout);
+}
+
+
+int main(int argc, char** argv) {
+   const adapter_t *a;
+   const char *filter;
+   FILE *hist;
+   run_t r;
+   op_t ops[8];
+   long max;
+   int i, k, nops;
+
+   max = DEF_SIZE;
+   filter = NULL;
+   hist = NULL;
+
+   for(i = 1; i < argc; i++) {
+      if(!strcmp(argv[i], "-m") && i + 1 < argc)
+         max = atol(argv[++i]);
+      else if(!strcmp(argv[i], "-f") && i + 1 < argc)
+         filter = argv[++i];
+      else if(!strcmp(argv[i], "-H") && i + 1 < argc) {
+         if(!(hist = fopen(argv[++i], "w"))) {
+            perror(argv[i]);
+            return EXIT_FAILURE;
+         }
+      }
+      else {
+         fprintf(stderr, "usage: %s [-m max_size] [-f filter] "
+                 "[-H histogram.csv]\n", argv[0]);
+         return EXIT_FAILURE;
+      }
+   }
+
+   if(max < 10 || max > MAX_SIZE) {
+      fprintf(stderr, "bench: max_size must be from 10 to %d\n", MAX_SIZE);
+      return EXIT_FAILURE;
+   }
+
+   memset(&r, 0, sizeof(r));
+   r.vals = malloc(sizeof(int) * max);
+   r.elems = malloc(sizeof(void*) * max);
+
+   if(!r.vals || !r.elems) {
+      fprintf(stderr, "bench: out of memory\n");
+      return EXIT_FAILURE;
+   }
+
+   for(i = 0; i < max; i++) {
+      r.vals[i] = i;
+      r.elems[i] = &r.vals[i];
+   }
+
+   printf("container,op,size,ops,ns_per_op,p50_ns,p90_ns,p99_ns,max_ns\n");
+
+   if(hist)
+      fprintf(hist, "container,op,size,lo_ns,hi_ns,count\n");
+
+   for(r.n = 10; r.n <= max; r.n *= 10) {
+      for(k = 0; k < NADAPTERS; k++) {
+         a = r.a = &adapters[k];
+         nops = 0;
+
+         ops[nops].name = a->addop;
+         ops[nops++].run = op_add;
+         ops[nops].name = a->remop;
+         ops[nops++].run = op_rem;
+
+         if(a->get) { ops[nops].name = "get"; ops[nops++].run = op_get; }
+         if(a->indexof) {
+            ops[nops].name = "indexof";
+            ops[nops++].run = op_indexof;
+         }
+         if(a->contains) {
+            ops[nops].name = "contains";
+            ops[nops++].run = op_contains;
+         }
+         if(a->apply) {
+            ops[nops].name = "apply";
+            ops[nops++].run = op_apply;
+         }
+         if(a->toarr) {
+            ops[nops].name = "toarr";
+            ops[nops++].run = op_toarr;
+         }
+         if(a->view) { ops[nops].name = "view"; ops[nops++].run = op_view; }
+
+         for(i = 0; i < nops; i++)
+            __run(&r, &ops[i], filter, hist);
+      }
+   }
+
+   if(hist) fclose(hist);
+
+   free(r.samples);
+   free(r.vals);
+   free(r.elems);
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_ALLOC_H__
+#define __LIBDSTRUCTS_ALLOC_H__   /* Guard against multiple inclusion */
+
+#include <stddef.h>     /* For size_t */
+
+
+/**
+ * Memory allocator hooks. A container created with one of the *_init_alloc
+ * variants obtains all of its memory through these hooks: the container
+ * itself, its buffers and nodes, and the release of any element it owns. The
+ * allocator is referred to, not copied, so it must outlive the container.
+ * Passing NULL where an allocator is expected selects malloc(...) and
+ * friends.
+ *
+ * alloc(ctx, size) returns size bytes suitably aligned for any type, or NULL.
+ * realloc(ctx, ptr, old, size) resizes the old bytes at ptr to size bytes,
+ *    preserving the contents, and returns NULL (leaving ptr intact) on
+ *    failure.
+ * free(ctx, ptr, size) releases size bytes at ptr.
+ *
+ * ctx is passed through untouched.
+ **/
+typedef struct ds_allocator_s {
+   void* (*alloc)(void* ctx, size_t size);
+   void* (*realloc)(void* ctx, void* ptr, size_t old, size_t size);
+   void (*free)(void* ctx, void* ptr, size_t size);
+   void *ctx;
+} ds_allocator_t;
+
+
+/**
+ * Arena (bump) allocator public, opaque data type. Allocation carves memory
+ * off large blocks; freeing is a no-op unless it undoes the most recent
+ * allocation. ds_arena_reset(...) releases everything allocated from the
+ * arena at once, and any container built on it along with it.
+ **/
+typedef struct __ds_arena_s ds_arena_t;
+
+
+/** FUNCTION PROTOTYPES **/
+
+extern   ds_arena_t*       ds_arena_init     (size_t block);
+extern   void              ds_arena_free     (ds_arena_t* const arena);
+extern   void              ds_arena_reset    (ds_arena_t* const arena);
+
+extern   void*             ds_arena_alloc    (ds_arena_t* const arena,
+                                              size_t size);
+extern   size_t            ds_arena_used     (ds_arena_t* const arena);
+extern   ds_allocator_t*   ds_arena_allocator(ds_arena_t* const arena);
+
+#endif   /* __LIBDSTRUCTS_ALLOC_H__ */
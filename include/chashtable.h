@@ -0,0 +1,78 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_CHASHTABLE_H__
+#define __LIBDSTRUCTS_CHASHTABLE_H__   /* Guard against multiple inclusion */
+
+#include "compare.h"    /* For ds_hash_t, ds_eq_t */
+
+
+/**
+ * Concurrent hashtable public, opaque data type. Contents only accessable
+ * through function calls.
+ *
+ * A cht_t maps keys to caller-owned values, like ht_t, but may be shared by
+ * any number of threads. The table is split into shards, each with its own
+ * lock, so writers only contend when their keys land in the same shard.
+ * Lookups take no lock at all and never wait for writers. A shard that fills
+ * up grows a few buckets at a time over the writes that follow, rather than
+ * all at once. All cht_* functions except __cht_init(...) and cht_free(...)
+ * are thread-safe.
+ *
+ * Values may be NULL, so the table doubles as a concurrent set: add keys
+ * with NULL values and test them with cht_contains(...).
+ **/
+typedef struct __cht_s cht_t;
+
+
+/* Wrapper macro for a hashtable hashing and comparing keys bytewise */
+#define cht_init(type) (__cht_init(sizeof(type), NULL, NULL))
+
+/* Wrapper macro for a hashtable with user supplied hash/equality functions */
+#define cht_init_fn(type, hash, eq) (__cht_init(sizeof(type), (hash), (eq)))
+
+/* Wrapper macro for a hashtable using a set of callbacks (ds_ops_t*) */
+#define cht_init_ops(type, ops) \
+   (__cht_init(sizeof(type), (ops)->hash, (ops)->eq))
+
+/* Semantic macro for determining if a hashtable is empty */
+#define cht_empty(H) (cht_size(H) == 0)
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __cht_init(...) is not intended for use by the user. Use the wrapper
+ * macros cht_init(...), cht_init_fn(...) or cht_init_ops(...) instead.
+ **/
+extern   cht_t*   __cht_init     (size_t __key_size, ds_hash_t hash,
+                                  ds_eq_t eq);
+extern   void     cht_free       (cht_t* const ht);
+
+extern   int      cht_size       (cht_t* const ht);
+
+extern   int      cht_add        (cht_t* const ht, void* const key,
+                                  void* const val);
+extern   void*    cht_put        (cht_t* const ht, void* const key,
+                                  void* const val);
+
+extern   int      cht_contains   (cht_t* const ht, void* const key);
+extern   void*    cht_get        (cht_t* const ht, void* const key);
+extern   void*    cht_rem        (cht_t* const ht, void* const key);
+
+#endif   /* __LIBDSTRUCTS_CHASHTABLE_H__ */
@@ -0,0 +1,98 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_COMPARE_H__
+#define __LIBDSTRUCTS_COMPARE_H__   /* Guard against multiple inclusion */
+
+#include <stddef.h>     /* For size_t */
+
+
+/**
+ * Callback types shared by the containers. Each callback is handed the size
+ * of an element (the size given to the container's init macro) so that one
+ * function can serve elements of any size.
+ **/
+
+/* Hash function: returns a hash of the size bytes at elem */
+typedef unsigned long (*ds_hash_t)(const void* elem, size_t size);
+
+/* Equality function: returns nonzero if a and b are equal */
+typedef int (*ds_eq_t)(const void* a, const void* b, size_t size);
+
+/* Comparison function: returns <0, 0 or >0 as a orders before, with or after b */
+typedef int (*ds_cmp_t)(const void* a, const void* b, size_t size);
+
+
+/**
+ * A set of element callbacks, registered with a container through its setops
+ * function or ops init macro. Any member may be NULL. Containers test
+ * equality with eq, or with cmp returning zero (0) when eq is NULL, and fall
+ * back to comparing bytes when both are NULL.
+ *
+ * Containers recognize the built-in callbacks below and inline them into
+ * their search loops instead of calling through the pointer.
+ **/
+typedef struct ds_ops_s {
+   ds_cmp_t cmp;
+   ds_eq_t eq;
+   ds_hash_t hash;
+} ds_ops_t;
+
+
+/** FUNCTION PROTOTYPES **/
+
+/* Built-in callbacks operating on raw bytes */
+extern   unsigned long  ds_hash_mem (const void* elem, size_t size);
+extern   int            ds_eq_mem   (const void* a, const void* b,
+                                     size_t size);
+extern   int            ds_cmp_mem  (const void* a, const void* b,
+                                     size_t size);
+
+/**
+ * Built-in callbacks for scalar elements: int, unsigned int, 64-bit signed and
+ * unsigned integers, float and double. The size argument is ignored. Floating
+ * point comparisons order NaN after every number; floating point equality is
+ * that of ==, so 0.0 equals -0.0 and NaN equals nothing.
+ **/
+extern   int   ds_cmp_int     (const void* a, const void* b, size_t size);
+extern   int   ds_cmp_uint    (const void* a, const void* b, size_t size);
+extern   int   ds_cmp_i64     (const void* a, const void* b, size_t size);
+extern   int   ds_cmp_u64     (const void* a, const void* b, size_t size);
+extern   int   ds_cmp_float   (const void* a, const void* b, size_t size);
+extern   int   ds_cmp_double  (const void* a, const void* b, size_t size);
+
+extern   int   ds_eq_int      (const void* a, const void* b, size_t size);
+extern   int   ds_eq_uint     (const void* a, const void* b, size_t size);
+extern   int   ds_eq_i64      (const void* a, const void* b, size_t size);
+extern   int   ds_eq_u64      (const void* a, const void* b, size_t size);
+extern   int   ds_eq_float    (const void* a, const void* b, size_t size);
+extern   int   ds_eq_double   (const void* a, const void* b, size_t size);
+
+extern   unsigned long  ds_hash_float  (const void* elem, size_t size);
+extern   unsigned long  ds_hash_double (const void* elem, size_t size);
+
+/* Ready-made callback sets for each element type */
+extern   const ds_ops_t ds_ops_mem;
+extern   const ds_ops_t ds_ops_int;
+extern   const ds_ops_t ds_ops_uint;
+extern   const ds_ops_t ds_ops_i64;
+extern   const ds_ops_t ds_ops_u64;
+extern   const ds_ops_t ds_ops_float;
+extern   const ds_ops_t ds_ops_double;
+
+#endif   /* __LIBDSTRUCTS_COMPARE_H__ */
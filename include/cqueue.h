@@ -0,0 +1,58 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_CQUEUE_H__
+#define __LIBDSTRUCTS_CQUEUE_H__   /* Guard against multiple inclusion */
+
+
+/**
+ * Concurrent queue public, opaque data type. Contents only accessable through
+ * function calls.
+ *
+ * A cq_t is a bounded, lock-free, multi-producer/multi-consumer queue. Any
+ * number of threads may enqueue and dequeue at the same time. Unlike the rest
+ * of the library, all cq_* functions except __cq_init(...) and cq_free(...)
+ * are thread-safe.
+ **/
+typedef struct __cq_s cq_t;
+
+
+/* Wrapper macro for __cq_init(size_t __elem_size, size_t cap); cap may be at
+ * most INT_MAX / 2 + 1 */
+#define cq_init(type, cap) (__cq_init(sizeof(type), (cap)))
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __cq_init(...) is not intended for use by the user. Use the wrapper
+ * macro cq_init(...) instead.
+ **/
+extern   cq_t*    __cq_init      (size_t __elem_size, size_t cap);
+extern   void     cq_free        (cq_t* const q);
+
+extern   int      cq_size        (cq_t* const q);
+extern   int      cq_cap         (cq_t* const q);
+
+extern   int      cq_tryenq      (cq_t* const q, void* const elem);
+extern   void*    cq_trydeq      (cq_t* const q);
+
+extern   int      cq_enq_batch   (cq_t* const q, void** const elems, int n);
+extern   int      cq_deq_batch   (cq_t* const q, void** const elems, int n);
+
+#endif   /* __LIBDSTRUCTS_CQUEUE_H__ */
@@ -0,0 +1,77 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_HASHTABLE_H__
+#define __LIBDSTRUCTS_HASHTABLE_H__   /* Guard against multiple inclusion */
+
+#include "compare.h"    /* For ds_hash_t, ds_eq_t */
+
+
+/**
+ * Hashtable public, opaque data type. Contents only accessable through
+ * function calls.
+ *
+ * A hashtable maps keys to caller-owned values. Keys are copied into the
+ * table, so the key passed to any function may be reused or discarded once
+ * the call returns.
+ **/
+typedef struct __ht_s ht_t;
+
+
+/* Wrapper macro for a hashtable hashing and comparing keys bytewise */
+#define ht_init(type) (__ht_init(sizeof(type), NULL, NULL))
+
+/* Wrapper macro for a hashtable with user supplied hash/equality functions */
+#define ht_init_fn(type, hash, eq) (__ht_init(sizeof(type), (hash), (eq)))
+
+/* Wrapper macro for a hashtable using a set of callbacks (ds_ops_t*) */
+#define ht_init_ops(type, ops) \
+   (__ht_init(sizeof(type), (ops)->hash, (ops)->eq))
+
+/* Semantic macro for determining if a hashtable is empty */
+#define ht_empty(H) (ht_size(H) == 0)
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __ht_init(...) is not intended for use by the user. Use the wrapper
+ * macros ht_init(...), ht_init_fn(...) or ht_init_ops(...) instead.
+ **/
+extern   ht_t*    __ht_init   (size_t __key_size, ds_hash_t hash,
+                               ds_eq_t eq);
+extern   void     ht_free     (ht_t* const ht);
+
+extern   int      ht_size     (ht_t* const ht);
+extern   int      ht_cap      (ht_t* const ht);
+extern   int      ht_reserve  (ht_t* const ht, int n);
+extern   int      ht_rehash   (ht_t* const ht);
+
+extern   int      ht_add      (ht_t* const ht, void* const key,
+                               void* const val);
+extern   void*    ht_put      (ht_t* const ht, void* const key,
+                               void* const val);
+
+extern   void     ht_clear    (ht_t* const ht);
+extern   int      ht_contains (ht_t* const ht, void* const key);
+extern   void*    ht_get      (ht_t* const ht, void* const key);
+extern   void*    ht_rem      (ht_t* const ht, void* const key);
+
+extern   void     ht_apply    (ht_t* const ht, void (*funct)(void* const));
+
+#endif   /* __LIBDSTRUCTS_HASHTABLE_H__ */
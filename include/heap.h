@@ -0,0 +1,79 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_HEAP_H__
+#define __LIBDSTRUCTS_HEAP_H__   /* Guard against multiple inclusion */
+
+#include "compare.h"    /* For ds_cmp_t */
+#include "vector.h"     /* For vect_t */
+
+
+/**
+ * Heap public, opaque data type. Contents only accessable through function
+ * calls.
+ *
+ * A heap is an array-backed d-ary min-heap: hp_top(...) is the element that
+ * orders first under the heap's comparator. Every element added to a heap is
+ * given a handle, a small non-negative integer that stays valid until the
+ * element leaves the heap. Handles are used to change an element's priority
+ * with hp_decrease(...) or hp_update(...).
+ **/
+typedef struct __heap_s heap_t;
+
+
+/* Default number of children per node; four keeps siblings in a cache line */
+#define HP_ARITY 4
+
+/* Wrapper macro for __hp_init(...) with the default arity */
+#define hp_init(type, cmp) (__hp_init(sizeof(type), (cmp), HP_ARITY))
+
+/* Wrapper macro for __hp_init(...) with a chosen arity */
+#define hp_init_arity(type, cmp, d) (__hp_init(sizeof(type), (cmp), (d)))
+
+/* Semantic macro for determining if a heap is empty */
+#define hp_empty(H) (hp_size(H) == 0)
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __hp_init(...) is not intended for use by the user. Use the wrapper
+ * macros hp_init(...) or hp_init_arity(...) instead.
+ **/
+extern   heap_t*  __hp_init   (size_t __elem_size, ds_cmp_t cmp, int arity);
+extern   void     hp_free     (heap_t* const heap);
+
+extern   int      hp_size     (heap_t* const heap);
+extern   int      hp_reserve  (heap_t* const heap, int n);
+
+extern   int      hp_push     (heap_t* const heap, void* const elem);
+extern   int      hp_heapify  (heap_t* const heap, vect_t* const v);
+
+extern   void*    hp_top      (heap_t* const heap);
+extern   int      hp_top_hdl  (heap_t* const heap);
+extern   void*    hp_get      (heap_t* const heap, int hdl);
+
+extern   void*    hp_pop      (heap_t* const heap);
+extern   void*    hp_rem      (heap_t* const heap, int hdl);
+
+extern   void*    hp_decrease (heap_t* const heap, int hdl, void* const elem);
+extern   int      hp_update   (heap_t* const heap, int hdl);
+
+extern   void**   hp_toarr    (heap_t* const heap);
+
+#endif   /* __LIBDSTRUCTS_HEAP_H__ */
@@ -0,0 +1,61 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_INDEX_H__
+#define __LIBDSTRUCTS_INDEX_H__   /* Guard against multiple inclusion */
+
+#include <stddef.h>     /* For ptrdiff_t, size_t */
+
+
+/**
+ * Index and size type of the array-backed containers: vectors, stacks and
+ * queues. It is signed so that -1 can still report a NULL container or a
+ * missing element, and as wide as a pointer, so a container may hold as many
+ * elements as fit in the address space.
+ *
+ * Building with -DDSTRUCTS_INT_INDEX restores the old int indices, for
+ * callers that need the ABI of earlier releases. Library and callers must
+ * agree on the flag.
+ **/
+#ifdef DSTRUCTS_INT_INDEX
+
+#include <limits.h>     /* For INT_MAX */
+
+typedef int ds_idx_t;
+
+#define DS_IDX_MAX INT_MAX
+
+#else
+
+typedef ptrdiff_t ds_idx_t;
+
+#define DS_IDX_MAX ((ds_idx_t) ((size_t) -1 >> 1))
+
+#endif   /* DSTRUCTS_INT_INDEX */
+
+
+/* Storage class of functions defined in headers, such as in template.h */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define __DS_INLINE static inline
+#elif defined(__GNUC__)
+#define __DS_INLINE static __inline__
+#else
+#define __DS_INLINE static
+#endif
+
+#endif   /* __LIBDSTRUCTS_INDEX_H__ */
@@ -0,0 +1,141 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_LAYOUT_H__
+#define __LIBDSTRUCTS_LAYOUT_H__   /* Guard against multiple inclusion */
+
+/**
+ * Internal definitions of the vector, stack, queue and list. The library's
+ * own sources include this header; callers only see it through
+ * DSTRUCTS_INLINE (see vector.h), which inlines the hot accessors into the
+ * calling code. The members are not part of the API and may change between
+ * releases, so code built with DSTRUCTS_INLINE must be rebuilt along with the
+ * library, and with the same DSTRUCTS_STATS and DSTRUCTS_INT_INDEX flags.
+ **/
+
+#include "compare.h"    /* For ds_ops_t */
+#include "alloc.h"      /* For ds_allocator_t */
+#include "stats.h"      /* For __DS_STATS */
+#include "index.h"      /* For ds_idx_t */
+
+
+/**
+ * Internal vector definition. A vector either stores caller-owned pointers
+ * (the default) or stores the elements themselves back to back (inline
+ * mode). __stride is the number of bytes a single slot occupies in
+ * __elements. Inline vectors keep one extra slot past __cap as scratch space
+ * for elements handed back by v_rem(...) and v_set(...).
+ *
+ * __growth and __chunk select how the vector expands (see v_growth(...)).
+ * __mapped is the length of the mapping when __elements was obtained from
+ * mmap(...) rather than malloc(...), and zero (0) otherwise. A vector opened
+ * by v_open_mmap(...) instead keeps the start of its file's mapping in
+ * __file (NULL otherwise), __mapped long, and its elements start past the
+ * snapshot header; it leaves the mapping for the heap the first time it is
+ * resized.
+ *
+ * __alloc is the allocator everything is obtained from, or NULL for the C
+ * library. Vectors with an allocator are never mapped.
+ *
+ * __ops holds the element callbacks and __kind their classification (see
+ * ops.h). __DS_STATS must stay the first member.
+ **/
+struct __vect_s {
+   __DS_STATS
+   char *__elements;
+   char *__file;
+   ds_allocator_t *__alloc;
+   size_t __elem_size;
+   size_t __stride;
+   size_t __mapped;
+   ds_ops_t __ops;
+   int __kind;
+   int __inl;
+   int __growth;
+   ds_idx_t __chunk;
+   ds_idx_t __cap;
+   ds_idx_t __size;
+};
+
+
+/**
+ * Internal stack definition. Built upon a vector; the top of the stack is
+ * the last element of the vector, so pushing and popping never shift
+ * elements.
+ *
+ * __DS_STATS must stay the first member. The stack's counters are those of
+ * its vector, copied over after every operation.
+ **/
+struct stack_s {
+   __DS_STATS
+   struct __vect_s *__vector;
+   ds_allocator_t *__alloc;
+};
+
+
+/**
+ * Internal definition of a queue. Built upon a circular buffer of pointers.
+ * __head is the slot holding the next element to dequeue; the queue occupies
+ * __size slots from there, wrapping around at __cap. A fixed queue never
+ * grows; q_enq(...) fails once it is full. __alloc is the allocator everything
+ * is obtained from, or NULL for the C library. __DS_STATS must stay the first
+ * member.
+ **/
+struct que_s {
+   __DS_STATS
+   void **__elements;
+   ds_allocator_t *__alloc;
+   size_t __elem_size;
+   ds_idx_t __head;
+   ds_idx_t __size;
+   ds_idx_t __cap;
+   int __fixed;
+};
+
+/**
+ * Internal linkedlist definition. If __pool is set, nodes are taken from and
+ * returned to the pool instead of the system allocator. __own_pool indicates
+ * the pool was created by (and is destroyed with) this list. __ops holds the
+ * element callbacks and __kind their classification (see ops.h). __alloc is
+ * the allocator the list, its nodes and its freed elements go through, or
+ * NULL for the C library. __first and __last point to __ll_node_t nodes.
+ * __DS_STATS must stay the first member.
+ **/
+struct __llist_s {
+   __DS_STATS
+   void *__first;
+   void *__last;
+   struct __ll_pool_s *__pool;
+   ds_allocator_t *__alloc;
+   size_t __elem_size;
+   ds_ops_t __ops;
+   int __kind;
+   int __own_pool;
+   int __size;
+};
+
+
+/* Internal linkedlist node definition */
+typedef struct __ll_node_s {
+   void *element;
+   int pooled;
+   struct __ll_node_s *prev;
+   struct __ll_node_s *next;
+} __ll_node_t;
+
+#endif   /* __LIBDSTRUCTS_LAYOUT_H__ */
@@ -19,6 +19,9 @@
 #ifndef __LIBDSTRUCTS_LIST_H__
 #define __LIBDSTRUCTS_LIST_H__   /* Guard against multiple inclusion */
 
+#include "compare.h"    /* For ds_ops_t */
+#include "alloc.h"      /* For ds_allocator_t */
+
 
 /**
  * Linkedlist public, opaque data type. Contents only accessable through
@@ -28,15 +31,45 @@ typedef struct __llist_s llist_t;
 
 
 /**
- * Linkedlist iterator public, opaque data type. Contents only accessable
- * through function calls.
+ * Linkedlist iterator public data type. Contents only accessable through
+ * function calls. Unlike the list itself, its size is known, so an iterator
+ * may be declared on the stack and set up with ll_itr_init(...); such an
+ * iterator needs no allocation and is never freed.
+ *
+ * The cursor sits between the nodes __prev and __next. __last is the node
+ * most recently returned by li_next(...) or li_prev(...), or NULL if there is
+ * no such element to remove.
+ **/
+typedef struct __ll_iter_s {
+   llist_t *__list;
+   void *__next;
+   void *__prev;
+   void *__last;
+} ll_itr_t;
+
+
+/**
+ * Linkedlist node pool public, opaque data type. A pool hands out list nodes
+ * from large slabs and recycles removed nodes instead of freeing them.
  **/
-typedef struct __ll_iter_s ll_itr_t;
+typedef struct __ll_pool_s ll_pool_t;
 
 
 /* Wrapper macro for __ll_init(size_t __alloc_size) */
 #define ll_init(type) (__ll_init(sizeof(type)))
 
+/* Wrapper macro for a list with a private pool of n nodes per slab */
+#define ll_init_slab(type, n) (__ll_init_pool(sizeof(type), NULL, (n)))
+
+/* Wrapper macro for a list drawing nodes from a shared pool */
+#define ll_init_pool(type, pool) (__ll_init_pool(sizeof(type), (pool), 0))
+
+/* Wrapper macro for __ll_from_arr(size_t __elem_size, void** arr, int n) */
+#define ll_from_arr(type, arr, n) (__ll_from_arr(sizeof(type), (arr), (n)))
+
+/* Wrapper macro for a list drawing memory from an allocator */
+#define ll_init_alloc(type, alloc) (__ll_init_alloc(sizeof(type), (alloc)))
+
 /* Semantic macro for determining if a list is empty */
 #define ll_empty(L) (!ll_first(L))
 
@@ -44,16 +77,32 @@ typedef struct __ll_iter_s ll_itr_t;
 /** FUNCTION PROTOTYPES **/
 
 /**
- * NOTE: __ll_init(...) is not intended for use by the user. Use the wrapper
- * macro ll_init(...) instead.
+ * NOTE: __ll_init(...), __ll_init_alloc(...), __ll_init_pool(...) and
+ * __ll_from_arr(...) are not intended for use by the user. Use the wrapper
+ * macros ll_init(...), ll_init_alloc(...), ll_init_slab(...),
+ * ll_init_pool(...) and ll_from_arr(...) instead.
  **/
 extern   llist_t*          __ll_init   (size_t __elem_size);
+extern   llist_t*          __ll_init_alloc (size_t __elem_size,
+                                            ds_allocator_t* const alloc);
+extern   llist_t*          __ll_init_pool (size_t __elem_size,
+                                           ll_pool_t* const pool,
+                                           size_t slab_nodes);
+extern   llist_t*          __ll_from_arr (size_t __elem_size,
+                                          void** const arr, int n);
 extern   void              ll_free     (llist_t* const list);
 
+extern   ll_pool_t*        ll_pool_init(size_t slab_nodes);
+extern   ll_pool_t*        ll_pool_init_alloc(size_t slab_nodes,
+                                              ds_allocator_t* const alloc);
+extern   void              ll_pool_free(ll_pool_t* const pool);
+
 extern   int   ll_size     (llist_t* const list);
+extern   int   ll_setops   (llist_t* const list, const ds_ops_t* const ops);
 
 extern   void  ll_addf     (llist_t* const list, void* const elem);
 extern   void  ll_addl     (llist_t* const list, void* const elem);
+extern   int   ll_append_arr(llist_t* const list, void** const arr, int n);
 extern   int   ll_add      (llist_t* const list, int index,
                             void* const elem);
 
@@ -66,6 +115,12 @@ extern   void* ll_last     (llist_t* const list);
 
 extern   int   ll_indexof  (llist_t* const list, void* const elem);
 extern   void  ll_apply    (llist_t* const list, void (*funct)(void* const));
+extern   void  ll_apply_ctx(llist_t* const list,
+                            void (*funct)(void* const, void*), void* ctx);
+extern   void* ll_visit    (llist_t* const list,
+                            int (*visit)(void* const, void*), void* ctx);
+extern   void  ll_apply_par(llist_t* const list, void (*funct)(void* const),
+                            int nthreads);
 
 extern   void* ll_rem      (llist_t* const list, int index);
 extern   void* ll_remf     (llist_t* const list);
@@ -73,10 +128,13 @@ extern   void* ll_reml     (llist_t* const list);
 extern   void* ll_set      (llist_t* const list, int index, void* const elem);
 
 extern   void**   ll_toarr (llist_t* const list);
+extern   int      ll_save  (llist_t* const list, const char* path);
 
 
 /* Linkedlist Iterator Functions */
 extern   ll_itr_t*   ll_itr      (llist_t* const list, int index);
+extern   int         ll_itr_init (ll_itr_t* const itr, llist_t* const list,
+                                  int index);
 extern   void        li_free     (ll_itr_t* const itr);
 
 extern   int         li_hasnext  (ll_itr_t* const itr);
@@ -84,5 +142,8 @@ extern   int         li_hasprev  (ll_itr_t* const itr);
 extern   void*       li_next     (ll_itr_t* const itr);
 extern   void*       li_prev     (ll_itr_t* const itr);
 
+extern   int         li_add      (ll_itr_t* const itr, void* const elem);
+extern   void*       li_rem      (ll_itr_t* const itr);
+
 #endif   /* __LIBDSTRUCTS_LIST_H__ */
 
@@ -0,0 +1,56 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_MATRIX_H__
+#define __LIBDSTRUCTS_MATRIX_H__   /* Guard against multiple inclusion */
+
+#include "index.h"      /* For ds_idx_t */
+
+
+/**
+ * Dense matrix public, opaque data type. Contents only accessable through
+ * function calls.
+ *
+ * A mat_t holds rows * cols doubles in one row-major buffer, so mat_row(...)
+ * hands out a plain array of a row's elements. mat_mul(...) and
+ * mat_transpose(...) work through the matrices in cache-sized tiles. For
+ * matrices that are mostly zeros, such as the adjacency matrix of a large
+ * graph, see sparse-matrix.h.
+ **/
+typedef struct __mat_s mat_t;
+
+
+/** FUNCTION PROTOTYPES **/
+
+extern   mat_t*   mat_init       (ds_idx_t rows, ds_idx_t cols);
+extern   void     mat_free       (mat_t* const m);
+
+extern   ds_idx_t mat_rows       (mat_t* const m);
+extern   ds_idx_t mat_cols       (mat_t* const m);
+
+extern   double   mat_get        (mat_t* const m, ds_idx_t i, ds_idx_t j);
+extern   int      mat_set        (mat_t* const m, ds_idx_t i, ds_idx_t j,
+                                  double val);
+extern   double*  mat_row        (mat_t* const m, ds_idx_t i);
+extern   void     mat_fill       (mat_t* const m, double val);
+
+extern   mat_t*   mat_transpose  (mat_t* const m);
+extern   mat_t*   mat_mul        (mat_t* const a, mat_t* const b);
+extern   int      mat_mulv       (mat_t* const m, const double* x, double* y);
+
+#endif   /* __LIBDSTRUCTS_MATRIX_H__ */
@@ -0,0 +1,47 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_PRIORITY_QUEUE_H__
+#define __LIBDSTRUCTS_PRIORITY_QUEUE_H__   /* Guard against multiple inclusion */
+
+#include "compare.h"    /* For ds_cmp_t */
+
+
+/**
+ * Priority queue public, opaque data type. Contents only accessable through
+ * function calls. The head of the queue is the element that orders first
+ * under the queue's comparator.
+ **/
+typedef struct pq_s pq_t;
+
+
+/* Wrapper macro for __pq_init(...) */
+#define pq_init(type, cmp) (__pq_init(sizeof(type), (cmp)))
+#define pq_empty(Q) (!pq_head(Q))
+
+extern pq_t*   __pq_init   (size_t __elem_size, ds_cmp_t cmp);
+extern void    pq_free     (pq_t* const q);
+
+extern int     pq_size     (pq_t* const q);
+extern void*   pq_head     (pq_t* const q);
+extern int     pq_enq      (pq_t* const q, void* const elem);
+extern void*   pq_deq      (pq_t* const q);
+extern void*   pq_decrease (pq_t* const q, int hdl, void* const elem);
+extern void**  pq_toarr    (pq_t* const q);
+
+#endif   /* __LIBDSTRUCTS_PRIORITY_QUEUE_H__ */
@@ -19,6 +19,10 @@
 #ifndef __LIBDSTRUCTS_QUEUE_H__
 #define __LIBDSTRUCTS_QUEUE_H__
 
+#include "span.h"       /* For ds_span2_t */
+#include "alloc.h"      /* For ds_allocator_t */
+#include "index.h"      /* For ds_idx_t */
+
 
 /**
  * Queue public, opaque data type. Contents only accessable through function
@@ -27,19 +31,51 @@
 typedef struct que_s que_t;
 
 
-/* Wrapper macro for __q_init(...) */
+/* Wrapper macros for __q_init(...), __q_init_fixed(...), __q_init_alloc(...) */
 #define q_init(type) (__q_init(sizeof(type)))
+#define q_init_fixed(type, cap) (__q_init_fixed(sizeof(type), (cap)))
+#define q_init_alloc(type, alloc) (__q_init_alloc(sizeof(type), (alloc)))
 #define q_empty(Q) (!q_head(Q))
 
 extern que_t*  __q_init (size_t __elem_size);
+extern que_t*  __q_init_fixed (size_t __elem_size, ds_idx_t cap);
+extern que_t*  __q_init_alloc (size_t __elem_size,
+                               ds_allocator_t* const alloc);
 extern void    q_free   (que_t* const q);
 
-extern int     q_size   (que_t* const q);
+extern ds_idx_t q_size  (que_t* const q);
+extern ds_idx_t q_cap   (que_t* const q);
 extern void*   q_head   (que_t* const q);
 extern void*   q_tail   (que_t* const q);
-extern void    q_enq    (que_t* const q, void* const elem);
+extern int     q_enq    (que_t* const q, void* const elem);
 extern void*   q_deq    (que_t* const q);
 extern void**  q_toarr  (que_t* const q);
+extern int     q_save   (que_t* const q, const char* path);
+extern ds_span2_t q_view (que_t* const q);
+
+
+/* Inline accessors; see vector.h */
+#ifdef DSTRUCTS_INLINE
+
+#include "layout.h"     /* For struct que_s */
+
+__DS_INLINE ds_idx_t __q_size_inline(que_t* const q) {
+   return (q ? q->__size : -1);
+}
+
+__DS_INLINE ds_idx_t __q_cap_inline(que_t* const q) {
+   return (q ? q->__cap : -1);
+}
+
+__DS_INLINE void* __q_head_inline(que_t* const q) {
+   return (q && q->__size ? q->__elements[q->__head] : NULL);
+}
+
+#define q_size(Q) (__q_size_inline(Q))
+#define q_cap(Q) (__q_cap_inline(Q))
+#define q_head(Q) (__q_head_inline(Q))
+
+#endif   /* DSTRUCTS_INLINE */
 
 #endif   /* __LIBDSTRUCTS_QUEUE_H__ */
 
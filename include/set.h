@@ -0,0 +1,100 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_SET_H__
+#define __LIBDSTRUCTS_SET_H__   /* Guard against multiple inclusion */
+
+#include "compare.h"    /* For ds_hash_t, ds_eq_t, ds_ops_t */
+#include "span.h"       /* For ds_span_t */
+#include "index.h"      /* For ds_idx_t */
+#include "vector.h"     /* For vect_t */
+#include "list.h"       /* For llist_t */
+
+
+/**
+ * Set public, opaque data type. Contents only accessable through function
+ * calls.
+ *
+ * A set holds distinct elements, copied into the set, and finds them by
+ * hashing. The elements are kept back to back in a single buffer, so
+ * set_view(...) can walk them without touching the hash index.
+ **/
+typedef struct __set_s set_t;
+
+
+/**
+ * Operand of the bulk set operations: a vector, list or set, made with
+ * set_src_v(...), set_src_ll(...) or set_src_set(...). Contents are not
+ * meant to be accessed directly.
+ **/
+typedef struct __set_src_s {
+   void *__c;
+   int __kind;
+   int __sorted;
+} set_src_t;
+
+
+/* Wrapper macro for a set hashing and comparing elements bytewise */
+#define set_init(type) (__set_init(sizeof(type), NULL, NULL))
+
+/* Wrapper macro for a set with user supplied hash/equality functions */
+#define set_init_fn(type, hash, eq) (__set_init(sizeof(type), (hash), (eq)))
+
+/* Wrapper macro for a set using a set of callbacks (ds_ops_t*) */
+#define set_init_ops(type, ops) \
+   (__set_init(sizeof(type), (ops)->hash, (ops)->eq))
+
+/* Semantic macro for determining if a set is empty */
+#define set_empty(S) (set_size(S) == 0)
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __set_init(...) is not intended for use by the user. Use the wrapper
+ * macros set_init(...), set_init_fn(...) or set_init_ops(...) instead.
+ **/
+extern   set_t*   __set_init     (size_t __elem_size, ds_hash_t hash,
+                                  ds_eq_t eq);
+extern   void     set_free       (set_t* const s);
+
+extern   ds_idx_t set_size       (set_t* const s);
+extern   int      set_reserve    (set_t* const s, ds_idx_t n);
+
+extern   int      set_add        (set_t* const s, void* const elem);
+extern   int      set_rem        (set_t* const s, void* const elem);
+extern   int      set_contains   (set_t* const s, void* const elem);
+extern   void     set_clear      (set_t* const s);
+extern   ds_span_t set_view      (set_t* const s);
+
+
+/* Bulk Set Operations */
+extern   set_src_t   set_src_v      (vect_t* const v, int sorted);
+extern   set_src_t   set_src_ll     (llist_t* const list, int sorted);
+extern   set_src_t   set_src_set    (set_t* const s);
+
+extern   vect_t*     set_union      (set_src_t a, set_src_t b,
+                                     const ds_ops_t* const ops);
+extern   vect_t*     set_intersect  (set_src_t a, set_src_t b,
+                                     const ds_ops_t* const ops);
+extern   vect_t*     set_difference (set_src_t a, set_src_t b,
+                                     const ds_ops_t* const ops);
+extern   int         set_is_subset  (set_src_t a, set_src_t b,
+                                     const ds_ops_t* const ops);
+
+#endif   /* __LIBDSTRUCTS_SET_H__ */
@@ -0,0 +1,56 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_SPAN_H__
+#define __LIBDSTRUCTS_SPAN_H__   /* Guard against multiple inclusion */
+
+#include <stddef.h>     /* For size_t */
+
+
+/**
+ * Borrowed, read-only view of a run of contiguous elements inside a
+ * container. data points at the first element and len counts the elements;
+ * stride is the distance in bytes from one element to the next, which is the
+ * element size for inline vectors and sizeof(void*) for containers that hold
+ * pointers. An empty view has len zero (0) and may have a NULL data pointer.
+ *
+ * A view owns nothing; it must not be freed, and it is only valid until the
+ * next call that modifies the container it was taken from.
+ **/
+typedef struct ds_span_s {
+   void *data;
+   size_t len;
+   size_t stride;
+} ds_span_t;
+
+
+/**
+ * Borrowed view of a container whose elements live in at most two contiguous
+ * runs, such as a ring buffer that has wrapped around. The elements in order
+ * are those of seg[0] followed by those of seg[1]; seg[1] is empty whenever
+ * the contents are contiguous.
+ **/
+typedef struct ds_span2_s {
+   ds_span_t seg[2];
+} ds_span2_t;
+
+
+/* Address of the i'th element of a view */
+#define ds_span_at(S, i) ((void*)((char*)(S).data + (i) * (S).stride))
+
+#endif   /* __LIBDSTRUCTS_SPAN_H__ */
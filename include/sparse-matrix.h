@@ -0,0 +1,70 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_SPARSE_MATRIX_H__
+#define __LIBDSTRUCTS_SPARSE_MATRIX_H__   /* Guard against multiple inclusion */
+
+#include "index.h"      /* For ds_idx_t */
+
+
+/**
+ * Sparse matrix public, opaque data type. Contents only accessable through
+ * function calls.
+ *
+ * An spm_t stores only the nonzeros of a matrix of doubles, so its memory is
+ * proportional to their number rather than to rows * cols. A matrix starts
+ * out in coordinate format (SPM_COO), where spm_add(...) appends entries in
+ * any order. spm_compress(...) then sorts them into compressed sparse rows
+ * (SPM_CSR), which suits multiplying and walking rows, or compressed sparse
+ * columns (SPM_CSC), which suits walking columns. Entries added more than once
+ * are summed. A compressed matrix can be converted to the other compressed
+ * format, but no longer takes new entries.
+ **/
+typedef struct __spm_s spm_t;
+
+
+/* Storage formats of a sparse matrix */
+#define SPM_COO   0     /* Unsorted (row, column, value) triplets */
+#define SPM_CSR   1     /* Compressed sparse rows */
+#define SPM_CSC   2     /* Compressed sparse columns */
+
+
+/** FUNCTION PROTOTYPES **/
+
+extern   spm_t*   spm_init       (ds_idx_t rows, ds_idx_t cols);
+extern   void     spm_free       (spm_t* const m);
+
+extern   ds_idx_t spm_rows       (spm_t* const m);
+extern   ds_idx_t spm_cols       (spm_t* const m);
+extern   ds_idx_t spm_nnz        (spm_t* const m);
+extern   int      spm_format     (spm_t* const m);
+extern   int      spm_reserve    (spm_t* const m, ds_idx_t nnz);
+
+extern   int      spm_add        (spm_t* const m, ds_idx_t i, ds_idx_t j,
+                                  double val);
+extern   int      spm_compress   (spm_t* const m, int format);
+
+extern   double   spm_get        (spm_t* const m, ds_idx_t i, ds_idx_t j);
+extern   ds_idx_t spm_line       (spm_t* const m, ds_idx_t k,
+                                  const ds_idx_t** idx, const double** vals);
+
+extern   int      spm_mulv       (spm_t* const m, const double* x, double* y);
+extern   int      spm_mulv_par   (spm_t* const m, const double* x, double* y,
+                                  int nthreads);
+
+#endif   /* __LIBDSTRUCTS_SPARSE_MATRIX_H__ */
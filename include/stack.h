@@ -19,6 +19,10 @@
 #ifndef __LIBDSTRUCTS_STACK_H__
 #define __LIBDSTRUCTS_STACK_H__
 
+#include "span.h"       /* For ds_span_t */
+#include "alloc.h"      /* For ds_allocator_t */
+#include "index.h"      /* For ds_idx_t */
+
 
 /**
  * Stack public, opaque data type. Contents only accessable through function
@@ -27,18 +31,42 @@
 typedef struct stack_s stack_t;
 
 
-/* Wrapper macro for __s_init(...) */
+/* Wrapper macros for __s_init(...) and __s_init_alloc(...) */
 #define s_init(type) (__s_init(sizeof(type)))
+#define s_init_alloc(type, alloc) (__s_init_alloc(sizeof(type), (alloc)))
 #define s_empty(S) (!s_top(S))
 
 extern stack_t*  __s_init (size_t __elem_size);
+extern stack_t*  __s_init_alloc (size_t __elem_size,
+                                 ds_allocator_t* const alloc);
 extern void    s_free   (stack_t* const s);
 
-extern int     s_size   (stack_t* const s);
+extern ds_idx_t s_size  (stack_t* const s);
+extern int     s_reserve(stack_t* const s, ds_idx_t n);
 extern void*   s_top    (stack_t* const s);
-extern void    s_push   (stack_t* const s, void* const elem);
+extern int     s_push   (stack_t* const s, void* const elem);
 extern void*   s_pop    (stack_t* const s);
 extern void**  s_toarr  (stack_t* const s);
+extern ds_span_t s_view (stack_t* const s);
+
+
+/* Inline accessors; see vector.h */
+#ifdef DSTRUCTS_INLINE
+
+#include "vector.h"     /* For __v_last_inline(...) */
+
+__DS_INLINE ds_idx_t __s_size_inline(stack_t* const s) {
+   return (s ? s->__vector->__size : -1);
+}
+
+__DS_INLINE void* __s_top_inline(stack_t* const s) {
+   return (s ? __v_last_inline(s->__vector) : NULL);
+}
+
+#define s_size(S) (__s_size_inline(S))
+#define s_top(S) (__s_top_inline(S))
+
+#endif   /* DSTRUCTS_INLINE */
 
 #endif   /* __LIBDSTRUCTS_STACK_H__ */
 
@@ -0,0 +1,78 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_STATS_H__
+#define __LIBDSTRUCTS_STATS_H__   /* Guard against multiple inclusion */
+
+
+/**
+ * Instrumentation counters of a container. They are only kept when the
+ * library is built with -DDSTRUCTS_STATS; otherwise the containers carry no
+ * counters at all and ds_stats_get(...) reports none.
+ *
+ * allocs       - blocks obtained: the container itself, buffers and nodes.
+ * reallocs     - buffers resized in place or moved.
+ * bytes_copied - bytes moved by shifting elements, splitting or merging
+ *                nodes, and growing buffers. A realloc(...) counts the bytes
+ *                in use, whether or not it had to move them.
+ * cmps         - element comparisons made by searches.
+ * walks        - traversals: searches and lookups by position that visit
+ *                elements or nodes one after another.
+ * steps        - elements or nodes visited by those traversals; steps / walks
+ *                is the average traversal length.
+ * peak_size    - the most elements held at once.
+ * peak_cap     - the largest capacity reached, for containers with one.
+ **/
+typedef struct ds_stats_s {
+   unsigned long allocs;
+   unsigned long reallocs;
+   unsigned long bytes_copied;
+   unsigned long cmps;
+   unsigned long walks;
+   unsigned long steps;
+   unsigned long peak_size;
+   unsigned long peak_cap;
+} ds_stats_t;
+
+
+/**
+ * Leading member of every instrumented container. Defined here rather than
+ * in the library's internal headers because layout.h needs it too.
+ **/
+#ifdef DSTRUCTS_STATS
+#define __DS_STATS ds_stats_t __stats;
+#else
+#define __DS_STATS
+#endif
+
+
+/* Average traversal length of a ds_stats_t* */
+#define ds_stats_avg_walk(S) \
+   ((S)->walks ? (double) (S)->steps / (double) (S)->walks : 0.0)
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: ds_stats_get(...) accepts a vect_t*, stack_t*, llist_t*, ulist_t* or
+ * que_t*.
+ **/
+extern   int   ds_stats_get   (const void* const container,
+                               ds_stats_t* const stats);
+
+#endif   /* __LIBDSTRUCTS_STATS_H__ */
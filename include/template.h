@@ -0,0 +1,892 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_TEMPLATE_H__
+#define __LIBDSTRUCTS_TEMPLATE_H__   /* Guard against multiple inclusion */
+
+#include <stdlib.h>     /* For malloc(...), realloc(...), free(...) */
+#include <string.h>     /* For memcmp(...), memcpy(...), memmove(...) */
+#include "compare.h"    /* For ds_hash_mem(...) */
+#include "index.h"      /* For ds_idx_t, DS_IDX_MAX, __DS_INLINE */
+#include "span.h"       /* For ds_span_t, ds_span2_t */
+
+
+/**
+ * Typed containers. Each DS_*_DEFINE(...) macro below expands to a container
+ * type and its functions specialized for one element type. Elements are
+ * stored inline and copied by assignment, and their size is known to the
+ * compiler, so copying or comparing an element compiles to a few loads and
+ * stores rather than calls sized at run time.
+ *
+ * The containers copy the behavior of the untyped ones (vect_t above all),
+ * with three differences: elements are passed in by value and handed back
+ * through a T* (either a pointer into the container, valid until it is next
+ * modified, or an out parameter that may be NULL); elements are never freed,
+ * since the container owns their storage; and memory always comes from the
+ * C library.
+ *
+ * Expand each macro once per element type at file scope, for example in a
+ * header shared by the files that use the container:
+ *
+ *    DS_VECTOR_DEFINE(int32, int32_t)
+ *
+ *    int32_vec_t *v = int32_vec_init();
+ *    int32_vec_push(v, 42);
+ *
+ * The functions are static, and inline where the compiler supports it, so
+ * every file that expands a macro gets its own copy and unused functions cost
+ * nothing. name must be a valid identifier; it prefixes every generated type
+ * and function.
+ **/
+
+
+/* Hash and equality of DS_HASHTABLE_DEFINE(...) keys, handed const K* */
+#define DS_HASH_BYTES(kp) (ds_hash_mem((kp), sizeof(*(kp))))
+#define DS_EQ_BYTES(ap, bp) (!memcmp((ap), (bp), sizeof(*(ap))))
+#define DS_EQ_VAL(ap, bp) (*(ap) == *(bp))
+
+/* Hash of an integer key, mixed so that patterned keys spread out */
+#define DS_HASH_INT(kp) (__ds_hash_int((unsigned long) *(kp)))
+
+__DS_INLINE unsigned long __ds_hash_int(unsigned long x) {
+   x ^= x >> 16;
+   x *= 0x45d9f3bUL;
+   x ^= x >> 16;
+   x *= 0x45d9f3bUL;
+   x ^= x >> 16;
+
+   return x;
+}
+
+
+/**
+ * DS_VECTOR_DEFINE(name, T) defines name_vec_t, a vector of T, and:
+ *
+ *    name_vec_t* name_vec_init     (void)
+ *    name_vec_t* name_vec_init_cap (ds_idx_t n)
+ *    void        name_vec_free     (name_vec_t* v)
+ *
+ *    ds_idx_t    name_vec_size     (name_vec_t* v)
+ *    ds_idx_t    name_vec_cap      (name_vec_t* v)
+ *    int         name_vec_reserve  (name_vec_t* v, ds_idx_t n)
+ *    void        name_vec_trim     (name_vec_t* v)
+ *
+ *    int         name_vec_push     (name_vec_t* v, T elem)
+ *    int         name_vec_add      (name_vec_t* v, ds_idx_t index, T elem)
+ *    int         name_vec_pop      (name_vec_t* v, T* out)
+ *    int         name_vec_rem      (name_vec_t* v, ds_idx_t index, T* out)
+ *    int         name_vec_set      (name_vec_t* v, ds_idx_t index, T elem)
+ *    void        name_vec_clear    (name_vec_t* v)
+ *
+ *    T*          name_vec_get      (name_vec_t* v, ds_idx_t index)
+ *    ds_idx_t    name_vec_indexof  (name_vec_t* v, T elem)
+ *    int         name_vec_contains (name_vec_t* v, T elem)
+ *    T*          name_vec_data     (name_vec_t* v)
+ *    ds_span_t   name_vec_span     (name_vec_t* v)
+ *
+ * Each behaves as its v_*(...) counterpart does for an inline vector.
+ * Elements are compared bytewise, as a vector without callbacks does.
+ **/
+#define DS_VECTOR_DEFINE(name, T) \
+typedef struct name##_vec_s { \
+   T *__elements; \
+   ds_idx_t __size; \
+   ds_idx_t __cap; \
+} name##_vec_t; \
+\
+__DS_INLINE int __##name##_vec_resize(name##_vec_t* const v, ds_idx_t cap) { \
+   T *elements; \
+\
+   if(cap < 1) cap = 1; \
+\
+   if((size_t) cap > (size_t) -1 / sizeof(T)) return 0; \
+\
+   elements = realloc(v->__elements, sizeof(T) * (size_t) cap); \
+\
+   if(!elements) return 0; \
+\
+   v->__elements = elements; \
+   v->__cap = cap; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int __##name##_vec_grow(name##_vec_t* const v) { \
+   return __##name##_vec_resize(v, v->__cap > (DS_IDX_MAX - 1) / 2 ? \
+                                DS_IDX_MAX : 2 * v->__cap + 1); \
+} \
+\
+__DS_INLINE name##_vec_t* name##_vec_init_cap(ds_idx_t n) { \
+   name##_vec_t *v; \
+\
+   if(n < 0) return NULL; \
+\
+   v = malloc(sizeof(name##_vec_t)); \
+\
+   if(!v) return NULL; \
+\
+   v->__elements = NULL; \
+   v->__size = 0; \
+\
+   if(!__##name##_vec_resize(v, n)) { \
+      free(v); \
+      return NULL; \
+   } \
+\
+   return v; \
+} \
+\
+__DS_INLINE name##_vec_t* name##_vec_init(void) { \
+   return name##_vec_init_cap(10); \
+} \
+\
+__DS_INLINE void name##_vec_free(name##_vec_t* const v) { \
+   if(!v) return; \
+\
+   free(v->__elements); \
+   free(v); \
+} \
+\
+__DS_INLINE ds_idx_t name##_vec_size(name##_vec_t* const v) { \
+   return (v ? v->__size : -1); \
+} \
+\
+__DS_INLINE ds_idx_t name##_vec_cap(name##_vec_t* const v) { \
+   return (v ? v->__cap : -1); \
+} \
+\
+__DS_INLINE int name##_vec_reserve(name##_vec_t* const v, ds_idx_t n) { \
+   if(!v || n < 0) return 0; \
+\
+   if(n <= v->__cap) return 1; \
+\
+   return __##name##_vec_resize(v, n); \
+} \
+\
+__DS_INLINE void name##_vec_trim(name##_vec_t* const v) { \
+   if(!v) return; \
+\
+   __##name##_vec_resize(v, v->__size); \
+} \
+\
+__DS_INLINE int name##_vec_add(name##_vec_t* const v, ds_idx_t index, \
+                               T elem) { \
+   if(!v || index < 0 || index > v->__size) return 0; \
+\
+   if(v->__size == v->__cap) \
+      if(!__##name##_vec_grow(v)) \
+         return 0; \
+\
+   memmove(v->__elements + index + 1, v->__elements + index, \
+           sizeof(T) * (size_t) (v->__size - index)); \
+\
+   v->__elements[index] = elem; \
+   v->__size++; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_vec_push(name##_vec_t* const v, T elem) { \
+   if(!v) return 0; \
+\
+   if(v->__size == v->__cap) \
+      if(!__##name##_vec_grow(v)) \
+         return 0; \
+\
+   v->__elements[v->__size++] = elem; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_vec_rem(name##_vec_t* const v, ds_idx_t index, \
+                               T* const out) { \
+   if(!v || index < 0 || index >= v->__size) return 0; \
+\
+   if(out) *out = v->__elements[index]; \
+\
+   memmove(v->__elements + index, v->__elements + index + 1, \
+           sizeof(T) * (size_t) (v->__size - index - 1)); \
+\
+   v->__size--; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_vec_pop(name##_vec_t* const v, T* const out) { \
+   if(!v || !v->__size) return 0; \
+\
+   v->__size--; \
+\
+   if(out) *out = v->__elements[v->__size]; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_vec_set(name##_vec_t* const v, ds_idx_t index, \
+                               T elem) { \
+   if(!v || index < 0 || index >= v->__size) return 0; \
+\
+   v->__elements[index] = elem; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE void name##_vec_clear(name##_vec_t* const v) { \
+   if(v) v->__size = 0; \
+} \
+\
+__DS_INLINE T* name##_vec_get(name##_vec_t* const v, ds_idx_t index) { \
+   if(!v || index < 0 || index >= v->__size) return NULL; \
+\
+   return v->__elements + index; \
+} \
+\
+__DS_INLINE ds_idx_t name##_vec_indexof(name##_vec_t* const v, T elem) { \
+   ds_idx_t i; \
+\
+   if(!v) return -1; \
+\
+   for(i = 0; i < v->__size; i++) \
+      if(!memcmp(v->__elements + i, &elem, sizeof(T))) \
+         return i; \
+\
+   return -1; \
+} \
+\
+__DS_INLINE int name##_vec_contains(name##_vec_t* const v, T elem) { \
+   return (name##_vec_indexof(v, elem) >= 0); \
+} \
+\
+__DS_INLINE T* name##_vec_data(name##_vec_t* const v) { \
+   return (v ? v->__elements : NULL); \
+} \
+\
+__DS_INLINE ds_span_t name##_vec_span(name##_vec_t* const v) { \
+   ds_span_t span; \
+\
+   span.data = (v ? v->__elements : NULL); \
+   span.len = (v ? (size_t) v->__size : 0); \
+   span.stride = sizeof(T); \
+\
+   return span; \
+}
+
+
+/**
+ * DS_STACK_DEFINE(name, T) defines name_stack_t, a stack of T, and:
+ *
+ *    name_stack_t* name_stack_init    (void)
+ *    void          name_stack_free    (name_stack_t* s)
+ *
+ *    ds_idx_t      name_stack_size    (name_stack_t* s)
+ *    int           name_stack_reserve (name_stack_t* s, ds_idx_t n)
+ *
+ *    int           name_stack_push    (name_stack_t* s, T elem)
+ *    int           name_stack_pop     (name_stack_t* s, T* out)
+ *    T*            name_stack_top     (name_stack_t* s)
+ *    ds_span_t     name_stack_view    (name_stack_t* s)
+ *
+ * Each behaves as its s_*(...) counterpart does. As with s_view(...), the
+ * view lists the stack from the bottom up.
+ **/
+#define DS_STACK_DEFINE(name, T) \
+typedef struct name##_stack_s { \
+   T *__elements; \
+   ds_idx_t __size; \
+   ds_idx_t __cap; \
+} name##_stack_t; \
+\
+__DS_INLINE int __##name##_stack_resize(name##_stack_t* const s, \
+                                        ds_idx_t cap) { \
+   T *elements; \
+\
+   if((size_t) cap > (size_t) -1 / sizeof(T)) return 0; \
+\
+   elements = realloc(s->__elements, sizeof(T) * (size_t) cap); \
+\
+   if(!elements) return 0; \
+\
+   s->__elements = elements; \
+   s->__cap = cap; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE name##_stack_t* name##_stack_init(void) { \
+   name##_stack_t *s; \
+\
+   s = malloc(sizeof(name##_stack_t)); \
+\
+   if(!s) return NULL; \
+\
+   s->__elements = NULL; \
+   s->__size = 0; \
+\
+   if(!__##name##_stack_resize(s, 10)) { \
+      free(s); \
+      return NULL; \
+   } \
+\
+   return s; \
+} \
+\
+__DS_INLINE void name##_stack_free(name##_stack_t* const s) { \
+   if(!s) return; \
+\
+   free(s->__elements); \
+   free(s); \
+} \
+\
+__DS_INLINE ds_idx_t name##_stack_size(name##_stack_t* const s) { \
+   return (s ? s->__size : -1); \
+} \
+\
+__DS_INLINE int name##_stack_reserve(name##_stack_t* const s, ds_idx_t n) { \
+   if(!s || n < 0) return 0; \
+\
+   if(n <= s->__cap) return 1; \
+\
+   return __##name##_stack_resize(s, n); \
+} \
+\
+__DS_INLINE int name##_stack_push(name##_stack_t* const s, T elem) { \
+   if(!s) return 0; \
+\
+   if(s->__size == s->__cap) \
+      if(!__##name##_stack_resize(s, s->__cap > (DS_IDX_MAX - 1) / 2 ? \
+                                  DS_IDX_MAX : 2 * s->__cap + 1)) \
+         return 0; \
+\
+   s->__elements[s->__size++] = elem; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_stack_pop(name##_stack_t* const s, T* const out) { \
+   if(!s || !s->__size) return 0; \
+\
+   s->__size--; \
+\
+   if(out) *out = s->__elements[s->__size]; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE T* name##_stack_top(name##_stack_t* const s) { \
+   return (s && s->__size ? s->__elements + s->__size - 1 : NULL); \
+} \
+\
+__DS_INLINE ds_span_t name##_stack_view(name##_stack_t* const s) { \
+   ds_span_t span; \
+\
+   span.data = (s ? s->__elements : NULL); \
+   span.len = (s ? (size_t) s->__size : 0); \
+   span.stride = sizeof(T); \
+\
+   return span; \
+}
+
+
+/**
+ * DS_QUEUE_DEFINE(name, T) defines name_queue_t, a queue of T built upon a
+ * circular buffer, and:
+ *
+ *    name_queue_t* name_queue_init       (void)
+ *    name_queue_t* name_queue_init_fixed (ds_idx_t cap)
+ *    void          name_queue_free       (name_queue_t* q)
+ *
+ *    ds_idx_t      name_queue_size       (name_queue_t* q)
+ *    ds_idx_t      name_queue_cap        (name_queue_t* q)
+ *
+ *    int           name_queue_enq        (name_queue_t* q, T elem)
+ *    int           name_queue_deq        (name_queue_t* q, T* out)
+ *    T*            name_queue_head       (name_queue_t* q)
+ *    T*            name_queue_tail       (name_queue_t* q)
+ *    ds_span2_t    name_queue_view       (name_queue_t* q)
+ *
+ * Each behaves as its q_*(...) counterpart does. A fixed queue never grows;
+ * name_queue_enq(...) fails once it is full.
+ **/
+#define DS_QUEUE_DEFINE(name, T) \
+typedef struct name##_queue_s { \
+   T *__elements; \
+   ds_idx_t __head; \
+   ds_idx_t __size; \
+   ds_idx_t __cap; \
+   int __fixed; \
+} name##_queue_t; \
+\
+__DS_INLINE name##_queue_t* __##name##_queue_create(ds_idx_t cap, \
+                                                    int fixed) { \
+   name##_queue_t *q; \
+\
+   if((size_t) cap > (size_t) -1 / sizeof(T)) return NULL; \
+\
+   q = malloc(sizeof(name##_queue_t)); \
+\
+   if(!q) return NULL; \
+\
+   q->__elements = malloc(sizeof(T) * (size_t) cap); \
+\
+   if(!q->__elements) { \
+      free(q); \
+      return NULL; \
+   } \
+\
+   q->__head = 0; \
+   q->__size = 0; \
+   q->__cap = cap; \
+   q->__fixed = fixed; \
+\
+   return q; \
+} \
+\
+__DS_INLINE name##_queue_t* name##_queue_init(void) { \
+   return __##name##_queue_create(16, 0); \
+} \
+\
+__DS_INLINE name##_queue_t* name##_queue_init_fixed(ds_idx_t cap) { \
+   return (cap < 1 ? NULL : __##name##_queue_create(cap, 1)); \
+} \
+\
+__DS_INLINE void name##_queue_free(name##_queue_t* const q) { \
+   if(!q) return; \
+\
+   free(q->__elements); \
+   free(q); \
+} \
+\
+__DS_INLINE ds_idx_t name##_queue_size(name##_queue_t* const q) { \
+   return (q ? q->__size : -1); \
+} \
+\
+__DS_INLINE ds_idx_t name##_queue_cap(name##_queue_t* const q) { \
+   return (q ? q->__cap : -1); \
+} \
+\
+__DS_INLINE int __##name##_queue_expand(name##_queue_t* const q) { \
+   T *elements; \
+   ds_idx_t first; \
+\
+   if((size_t) q->__cap > (size_t) -1 / 2 / sizeof(T)) return 0; \
+\
+   elements = malloc(sizeof(T) * (size_t) q->__cap * 2); \
+\
+   if(!elements) return 0; \
+\
+   /* Unwrap the two runs, head to end then start to tail */ \
+   first = q->__cap - q->__head; \
+   memcpy(elements, q->__elements + q->__head, sizeof(T) * (size_t) first); \
+   memcpy(elements + first, q->__elements, sizeof(T) * (size_t) q->__head); \
+\
+   free(q->__elements); \
+\
+   q->__elements = elements; \
+   q->__head = 0; \
+   q->__cap *= 2; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_queue_enq(name##_queue_t* const q, T elem) { \
+   ds_idx_t tail; \
+\
+   if(!q) return 0; \
+\
+   if(q->__size == q->__cap) \
+      if(q->__fixed || !__##name##_queue_expand(q)) \
+         return 0; \
+\
+   tail = q->__head + q->__size; \
+\
+   if(tail >= q->__cap) \
+      tail -= q->__cap; \
+\
+   q->__elements[tail] = elem; \
+   q->__size++; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_queue_deq(name##_queue_t* const q, T* const out) { \
+   if(!q || !q->__size) return 0; \
+\
+   if(out) *out = q->__elements[q->__head]; \
+\
+   if(++q->__head == q->__cap) \
+      q->__head = 0; \
+\
+   q->__size--; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE T* name##_queue_head(name##_queue_t* const q) { \
+   return (q && q->__size ? q->__elements + q->__head : NULL); \
+} \
+\
+__DS_INLINE T* name##_queue_tail(name##_queue_t* const q) { \
+   ds_idx_t tail; \
+\
+   if(!q || !q->__size) return NULL; \
+\
+   tail = q->__head + q->__size - 1; \
+\
+   return q->__elements + (tail >= q->__cap ? tail - q->__cap : tail); \
+} \
+\
+__DS_INLINE ds_span2_t name##_queue_view(name##_queue_t* const q) { \
+   ds_span2_t view; \
+   ds_idx_t first; \
+\
+   view.seg[0].data = view.seg[1].data = NULL; \
+   view.seg[0].len = view.seg[1].len = 0; \
+   view.seg[0].stride = view.seg[1].stride = sizeof(T); \
+\
+   if(!q || !q->__size) return view; \
+\
+   first = q->__cap - q->__head; \
+\
+   if(first > q->__size) \
+      first = q->__size; \
+\
+   view.seg[0].data = q->__elements + q->__head; \
+   view.seg[0].len = (size_t) first; \
+\
+   if(q->__size > first) { \
+      view.seg[1].data = q->__elements; \
+      view.seg[1].len = (size_t) (q->__size - first); \
+   } \
+\
+   return view; \
+}
+
+
+/**
+ * DS_HASHTABLE_DEFINE(name, K, V, HASH, EQ) defines name_ht_t, a hashtable
+ * mapping keys of type K to values of type V, and:
+ *
+ *    name_ht_t*  name_ht_init     (void)
+ *    void        name_ht_free     (name_ht_t* ht)
+ *
+ *    ds_idx_t    name_ht_size     (name_ht_t* ht)
+ *    ds_idx_t    name_ht_cap      (name_ht_t* ht)
+ *    int         name_ht_reserve  (name_ht_t* ht, ds_idx_t n)
+ *    int         name_ht_rehash   (name_ht_t* ht)
+ *
+ *    int         name_ht_add      (name_ht_t* ht, K key, V val)
+ *    int         name_ht_put      (name_ht_t* ht, K key, V val, V* former)
+ *    int         name_ht_rem      (name_ht_t* ht, K key, V* out)
+ *    void        name_ht_clear    (name_ht_t* ht)
+ *
+ *    int         name_ht_contains (name_ht_t* ht, K key)
+ *    V*          name_ht_get      (name_ht_t* ht, K key)
+ *    void        name_ht_apply    (name_ht_t* ht, void (*funct)(V* const))
+ *
+ * The table is laid out as ht_t is and each function behaves as its ht_*(...)
+ * counterpart does, except that name_ht_put(...) returns 1 if the key existed
+ * (storing the value it replaces in former, when not NULL) and 0 if the key
+ * was added or upon allocation error.
+ *
+ * HASH(kp) must hash the key kp points to; EQ(ap, bp) must be nonzero if the
+ * keys ap and bp point to are equal. Both are handed const K* and may be
+ * function-like macros, such as DS_HASH_INT and DS_EQ_VAL for integer keys or
+ * DS_HASH_BYTES and DS_EQ_BYTES for keys compared bytewise.
+ **/
+#define DS_HASHTABLE_DEFINE(name, K, V, HASH, EQ) \
+typedef struct name##_ht_s { \
+   unsigned long *__hashes; \
+   K *__keys; \
+   V *__vals; \
+   size_t __mask; \
+   ds_idx_t __size; \
+   ds_idx_t __cap; \
+} name##_ht_t; \
+\
+__DS_INLINE unsigned long __##name##_ht_hash(const K* const key) { \
+   unsigned long h; \
+\
+   h = (unsigned long) (HASH(key)); \
+\
+   return (h ? h : 1); \
+} \
+\
+__DS_INLINE ds_idx_t __##name##_ht_find(name##_ht_t* const ht, \
+                                        const K* const key, \
+                                        unsigned long h) { \
+   size_t pos, dist; \
+\
+   pos = h & ht->__mask; \
+\
+   for(dist = 0; ht->__hashes[pos]; dist++) { \
+      if(((pos - ht->__hashes[pos]) & ht->__mask) < dist) \
+         return -1; \
+\
+      if(ht->__hashes[pos] == h && (EQ(key, ht->__keys + pos))) \
+         return (ds_idx_t) pos; \
+\
+      pos = (pos + 1) & ht->__mask; \
+   } \
+\
+   return -1; \
+} \
+\
+__DS_INLINE void __##name##_ht_place(name##_ht_t* const ht, unsigned long h, \
+                                     K key, V val) { \
+   unsigned long htemp; \
+   K ktemp; \
+   V vtemp; \
+   size_t pos, dist, home; \
+\
+   pos = h & ht->__mask; \
+\
+   for(dist = 0; ht->__hashes[pos]; dist++) { \
+      /* Take the slot of an entry closer to home; carry it onward */ \
+      home = (pos - ht->__hashes[pos]) & ht->__mask; \
+\
+      if(home < dist) { \
+         dist = home; \
+\
+         htemp = ht->__hashes[pos]; \
+         ht->__hashes[pos] = h; \
+         h = htemp; \
+\
+         ktemp = ht->__keys[pos]; \
+         ht->__keys[pos] = key; \
+         key = ktemp; \
+\
+         vtemp = ht->__vals[pos]; \
+         ht->__vals[pos] = val; \
+         val = vtemp; \
+      } \
+\
+      pos = (pos + 1) & ht->__mask; \
+   } \
+\
+   ht->__hashes[pos] = h; \
+   ht->__keys[pos] = key; \
+   ht->__vals[pos] = val; \
+   ht->__size++; \
+} \
+\
+__DS_INLINE int __##name##_ht_resize(name##_ht_t* const ht, ds_idx_t cap) { \
+   unsigned long *hashes, *old_hashes; \
+   K *keys, *old_keys; \
+   V *vals, *old_vals; \
+   ds_idx_t i, old_cap; \
+\
+   hashes = calloc((size_t) cap, sizeof(unsigned long)); \
+   keys = malloc(sizeof(K) * (size_t) cap); \
+   vals = malloc(sizeof(V) * (size_t) cap); \
+\
+   if(!hashes || !keys || !vals) { \
+      free(hashes); \
+      free(keys); \
+      free(vals); \
+      return 0; \
+   } \
+\
+   /* Switch to the new arrays, keeping the old ones to move entries from */ \
+   old_hashes = ht->__hashes; \
+   old_keys = ht->__keys; \
+   old_vals = ht->__vals; \
+   old_cap = (old_hashes ? ht->__cap : 0); \
+\
+   ht->__hashes = hashes; \
+   ht->__keys = keys; \
+   ht->__vals = vals; \
+   ht->__cap = cap; \
+   ht->__mask = (size_t) cap - 1; \
+   ht->__size = 0; \
+\
+   for(i = 0; i < old_cap; i++) \
+      if(old_hashes[i]) \
+         __##name##_ht_place(ht, old_hashes[i], old_keys[i], old_vals[i]); \
+\
+   free(old_hashes); \
+   free(old_keys); \
+   free(old_vals); \
+\
+   return 1; \
+} \
+\
+__DS_INLINE ds_idx_t __##name##_ht_fit(ds_idx_t n) { \
+   ds_idx_t cap; \
+\
+   for(cap = 16; cap / 8 * 7 < n; cap <<= 1) \
+      ; \
+\
+   return cap; \
+} \
+\
+__DS_INLINE name##_ht_t* name##_ht_init(void) { \
+   name##_ht_t *ht; \
+\
+   ht = malloc(sizeof(name##_ht_t)); \
+\
+   if(!ht) return NULL; \
+\
+   ht->__hashes = NULL; \
+   ht->__keys = NULL; \
+   ht->__vals = NULL; \
+   ht->__size = 0; \
+\
+   if(!__##name##_ht_resize(ht, 16)) { \
+      free(ht); \
+      return NULL; \
+   } \
+\
+   return ht; \
+} \
+\
+__DS_INLINE void name##_ht_free(name##_ht_t* const ht) { \
+   if(!ht) return; \
+\
+   free(ht->__hashes); \
+   free(ht->__keys); \
+   free(ht->__vals); \
+   free(ht); \
+} \
+\
+__DS_INLINE ds_idx_t name##_ht_size(name##_ht_t* const ht) { \
+   return (ht ? ht->__size : -1); \
+} \
+\
+__DS_INLINE ds_idx_t name##_ht_cap(name##_ht_t* const ht) { \
+   return (ht ? ht->__cap : -1); \
+} \
+\
+__DS_INLINE int name##_ht_reserve(name##_ht_t* const ht, ds_idx_t n) { \
+   ds_idx_t cap; \
+\
+   if(!ht || n < 0) return 0; \
+\
+   cap = __##name##_ht_fit(n); \
+\
+   return (cap <= ht->__cap ? 1 : __##name##_ht_resize(ht, cap)); \
+} \
+\
+__DS_INLINE int name##_ht_rehash(name##_ht_t* const ht) { \
+   return (ht ? __##name##_ht_resize(ht, __##name##_ht_fit(ht->__size)) : 0); \
+} \
+\
+__DS_INLINE int name##_ht_add(name##_ht_t* const ht, K key, V val) { \
+   unsigned long h; \
+\
+   if(!ht) return 0; \
+\
+   h = __##name##_ht_hash(&key); \
+\
+   if(__##name##_ht_find(ht, &key, h) >= 0) return 0; \
+\
+   /* Grow before the table becomes more than 7/8 full */ \
+   if(ht->__size + 1 > ht->__cap / 8 * 7) \
+      if(!__##name##_ht_resize(ht, ht->__cap << 1)) \
+         return 0; \
+\
+   __##name##_ht_place(ht, h, key, val); \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_ht_put(name##_ht_t* const ht, K key, V val, \
+                              V* const former) { \
+   ds_idx_t slot; \
+\
+   if(!ht) return 0; \
+\
+   slot = __##name##_ht_find(ht, &key, __##name##_ht_hash(&key)); \
+\
+   if(slot < 0) { \
+      name##_ht_add(ht, key, val); \
+      return 0; \
+   } \
+\
+   if(former) *former = ht->__vals[slot]; \
+\
+   ht->__vals[slot] = val; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE int name##_ht_rem(name##_ht_t* const ht, K key, V* const out) { \
+   ds_idx_t slot; \
+   size_t next; \
+\
+   if(!ht) return 0; \
+\
+   slot = __##name##_ht_find(ht, &key, __##name##_ht_hash(&key)); \
+\
+   if(slot < 0) return 0; \
+\
+   if(out) *out = ht->__vals[slot]; \
+\
+   /* Shift back following entries until one is empty or at its home slot */ \
+   next = ((size_t) slot + 1) & ht->__mask; \
+\
+   while(ht->__hashes[next] && \
+         ((next - ht->__hashes[next]) & ht->__mask)) { \
+      ht->__hashes[slot] = ht->__hashes[next]; \
+      ht->__keys[slot] = ht->__keys[next]; \
+      ht->__vals[slot] = ht->__vals[next]; \
+\
+      slot = (ds_idx_t) next; \
+      next = (next + 1) & ht->__mask; \
+   } \
+\
+   ht->__hashes[slot] = 0; \
+   ht->__size--; \
+\
+   return 1; \
+} \
+\
+__DS_INLINE void name##_ht_clear(name##_ht_t* const ht) { \
+   if(!ht) return; \
+\
+   memset(ht->__hashes, 0, sizeof(unsigned long) * (size_t) ht->__cap); \
+   ht->__size = 0; \
+} \
+\
+__DS_INLINE int name##_ht_contains(name##_ht_t* const ht, K key) { \
+   if(!ht) return 0; \
+\
+   return (__##name##_ht_find(ht, &key, __##name##_ht_hash(&key)) >= 0); \
+} \
+\
+__DS_INLINE V* name##_ht_get(name##_ht_t* const ht, K key) { \
+   ds_idx_t slot; \
+\
+   if(!ht) return NULL; \
+\
+   slot = __##name##_ht_find(ht, &key, __##name##_ht_hash(&key)); \
+\
+   return (slot >= 0 ? ht->__vals + slot : NULL); \
+} \
+\
+__DS_INLINE void name##_ht_apply(name##_ht_t* const ht, \
+                                 void (*funct)(V* const)) { \
+   ds_idx_t i; \
+\
+   if(!ht) return; \
+\
+   for(i = 0; i < ht->__cap; i++) \
+      if(ht->__hashes[i]) \
+         (funct)(ht->__vals + i); \
+}
+
+#endif   /* __LIBDSTRUCTS_TEMPLATE_H__ */
@@ -19,16 +19,34 @@
 #ifndef __LIBDSTRUCTS_TREE_H__
 #define __LIBDSTRUCTS_TREE_H__   /* Guard against multiple inclusion */
 
+#include "compare.h"    /* For ds_cmp_t */
+#include "alloc.h"      /* For ds_allocator_t */
+
 
 /**
  * Binary search tree public, opaque data type. Contents only accessable
  * through function calls.
+ *
+ * The tree is self-balancing (AVL), so insertion, removal and lookup are
+ * O(log n) no matter the order elements are added in. Every subtree is itself
+ * a bst_t, and the top of a (sub)tree keeps its address while the tree
+ * rebalances.
  **/
 typedef struct __bst_s bst_t;
 
 
-/* Wrapper macro for __bst_init(size_t __alloc_size) */
-#define bst_init(type) (__bst_init(sizeof(type)))
+/* Wrapper macro for __bst_init(size_t __alloc_size, ds_cmp_t cmp) */
+#define bst_init(type) (__bst_init(sizeof(type), NULL))
+
+/* Wrapper macro for a binary search tree ordered by a user comparator */
+#define bst_init_cmp(type, cmp) (__bst_init(sizeof(type), (cmp)))
+
+/* Wrapper macro for a binary search tree using callbacks (ds_ops_t*) */
+#define bst_init_ops(type, ops) (__bst_init(sizeof(type), (ops)->cmp))
+
+/* Wrapper macro for a binary search tree drawing nodes from an allocator */
+#define bst_init_alloc(type, cmp, alloc) \
+   (__bst_init_alloc(sizeof(type), (cmp), (alloc)))
 
 /* Semantic macro for determining if a binary search tree is empty */
 #define bst_empty(B) (!bst_root(B))
@@ -37,10 +55,13 @@ typedef struct __bst_s bst_t;
 /** FUNCTION PROTOTYPES **/
 
 /**
- * NOTE: __bst_init(...) is not intended for use by the user. Use the wrapper
- * macro bst_init(...) instead.
+ * NOTE: __bst_init(...) and __bst_init_alloc(...) are not intended for use by
+ * the user. Use the wrapper macros bst_init(...), bst_init_cmp(...),
+ * bst_init_ops(...) or bst_init_alloc(...) instead.
  **/
-extern   bst_t*   __bst_init  (size_t __elem_size);
+extern   bst_t*   __bst_init  (size_t __elem_size, ds_cmp_t cmp);
+extern   bst_t*   __bst_init_alloc(size_t __elem_size, ds_cmp_t cmp,
+                                   ds_allocator_t* const alloc);
 extern   void     bst_free    (bst_t* const tree);
 
 extern   void*    bst_root    (bst_t* const tree);
@@ -57,9 +78,17 @@ extern   bst_t*   bst_left    (bst_t* const tree);
 extern   bst_t*   bst_right   (bst_t* const tree);
 
 extern   int      bst_add     (bst_t* const tree, void* const elem);
+extern   int      bst_build_sorted(bst_t* const tree, void** const arr,
+                                   int n);
 extern   void*    bst_rem     (bst_t* const tree, void* const elem);
 
 extern   void     bst_apply   (bst_t* const tree, void (*funct)(void* const));
+extern   void     bst_apply_ctx(bst_t* const tree,
+                                void (*funct)(void* const, void*), void* ctx);
+extern   void*    bst_visit   (bst_t* const tree,
+                               int (*visit)(void* const, void*), void* ctx);
+extern   void     bst_apply_par(bst_t* const tree, void (*funct)(void* const),
+                                int nthreads);
 
 extern   void**   bst_toarr   (bst_t* const tree);
 
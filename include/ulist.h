@@ -0,0 +1,114 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_ULIST_H__
+#define __LIBDSTRUCTS_ULIST_H__  /* Guard against multiple inclusion */
+
+#include "compare.h"    /* For ds_ops_t */
+
+
+/**
+ * Unrolled linkedlist public, opaque data type. Contents only accessable
+ * through function calls.
+ *
+ * An unrolled list behaves like llist_t, but each node holds a small array of
+ * elements instead of just one. Traversals read mostly sequential memory and
+ * the per-element overhead is a fraction of that of llist_t, while insertion
+ * at an iterator and splicing whole lists together stay cheap.
+ **/
+typedef struct __ulist_s ulist_t;
+
+
+/**
+ * Unrolled linkedlist iterator public data type. Contents only accessable
+ * through function calls. Its size is known, so an iterator may be declared
+ * on the stack and set up with ul_itr_init(...); such an iterator needs no
+ * allocation and is never freed.
+ **/
+typedef struct __ul_iter_s {
+   ulist_t *__list;
+   struct __unode_s *__node;
+   int __pos;
+   int __last;
+} ul_itr_t;
+
+
+/* Wrapper macro for __ul_init(size_t __alloc_size) */
+#define ul_init(type) (__ul_init(sizeof(type)))
+
+/* Semantic macro for determining if a list is empty */
+#define ul_empty(L) (!ul_size(L))
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __ul_init(...) is not intended for use by the user. Use the wrapper
+ * macro ul_init(...) instead.
+ **/
+extern   ulist_t*    __ul_init   (size_t __elem_size);
+extern   void        ul_free     (ulist_t* const list);
+
+extern   int   ul_size     (ulist_t* const list);
+extern   int   ul_setops   (ulist_t* const list, const ds_ops_t* const ops);
+
+extern   int   ul_addf     (ulist_t* const list, void* const elem);
+extern   int   ul_addl     (ulist_t* const list, void* const elem);
+extern   int   ul_add      (ulist_t* const list, int index,
+                            void* const elem);
+
+extern   void  ul_clear    (ulist_t* const list);
+extern   int   ul_contains (ulist_t* const list, void* const elem);
+
+extern   void* ul_get      (ulist_t* const list, int index);
+extern   void* ul_first    (ulist_t* const list);
+extern   void* ul_last     (ulist_t* const list);
+
+extern   int   ul_indexof  (ulist_t* const list, void* const elem);
+extern   void  ul_apply    (ulist_t* const list, void (*funct)(void* const));
+extern   void  ul_apply_ctx(ulist_t* const list,
+                            void (*funct)(void* const, void*), void* ctx);
+extern   void* ul_visit    (ulist_t* const list,
+                            int (*visit)(void* const, void*), void* ctx);
+
+extern   void* ul_rem      (ulist_t* const list, int index);
+extern   void* ul_remf     (ulist_t* const list);
+extern   void* ul_reml     (ulist_t* const list);
+extern   void* ul_set      (ulist_t* const list, int index, void* const elem);
+
+extern   int   ul_splice   (ulist_t* const list, int index,
+                            ulist_t* const other);
+
+extern   void**   ul_toarr (ulist_t* const list);
+
+
+/* Unrolled Linkedlist Iterator Functions */
+extern   ul_itr_t*   ul_itr      (ulist_t* const list, int index);
+extern   int         ul_itr_init (ul_itr_t* const itr, ulist_t* const list,
+                                  int index);
+extern   void        ui_free     (ul_itr_t* const itr);
+
+extern   int         ui_hasnext  (ul_itr_t* const itr);
+extern   int         ui_hasprev  (ul_itr_t* const itr);
+extern   void*       ui_next     (ul_itr_t* const itr);
+extern   void*       ui_prev     (ul_itr_t* const itr);
+
+extern   int         ui_add      (ul_itr_t* const itr, void* const elem);
+extern   void*       ui_rem      (ul_itr_t* const itr);
+
+#endif   /* __LIBDSTRUCTS_ULIST_H__ */
@@ -19,6 +19,11 @@
 #ifndef __LIBDSTRUCTS_VECTOR_H__
 #define __LIBDSTRUCTS_VECTOR_H__   /* Guard against multiple inclusion */
 
+#include "compare.h"    /* For ds_ops_t, ds_cmp_t */
+#include "span.h"       /* For ds_span_t */
+#include "alloc.h"      /* For ds_allocator_t */
+#include "index.h"      /* For ds_idx_t */
+
 
 /**
  * Vector public, opaque data type. Contents only accessable through
@@ -28,15 +33,50 @@ typedef struct __vect_s vect_t;
 
 
 /**
- * Vector iterator public, opaque data type. Contents only accessable
- * through function calls.
+ * Vector iterator public data type. Contents only accessable through function
+ * calls. Unlike the vector itself, its size is known, so an iterator may be
+ * declared on the stack and set up with v_itr_init(...); such an iterator
+ * needs no allocation and is never freed.
+ *
+ * The cursor sits before the element at __pos. __last is the offset from the
+ * cursor of the element most recently returned by vi_next(...) (-1) or
+ * vi_prev(...) (0), or 1 if there is no such element to remove.
  **/
-typedef struct __v_itr_s v_itr_t;
+typedef struct __v_itr_s {
+   vect_t *__vector;
+   ds_idx_t __pos;
+   int __last;
+} v_itr_t;
 
 
 /* Wrapper macro for __v_init(size_t __alloc_size) */
 #define v_init(type) (__v_init(sizeof(type)))
 
+/* Wrapper macro for __v_init_inline(size_t __alloc_size) */
+#define v_init_inline(type) (__v_init_inline(sizeof(type)))
+
+/* Wrapper macros for vectors with an initial capacity of n elements */
+#define v_init_cap(type, n) (__v_init_cap(sizeof(type), 0, (n)))
+#define v_init_inline_cap(type, n) (__v_init_cap(sizeof(type), 1, (n)))
+
+/* Wrapper macros for vectors drawing memory from an allocator */
+#define v_init_alloc(type, alloc) (__v_init_alloc(sizeof(type), 0, (alloc)))
+#define v_init_inline_alloc(type, alloc) \
+   (__v_init_alloc(sizeof(type), 1, (alloc)))
+
+/* Wrapper macro for __v_open_mmap(size_t __elem_size, ...) */
+#define v_open_mmap(type, path, flags) \
+   (__v_open_mmap(sizeof(type), (path), (flags)))
+
+/* Flags for v_open_mmap(...) */
+#define V_MAP_VERIFY    1        /* Check the snapshot's checksum */
+
+/* Growth policies for v_growth(...) */
+#define V_GROW_DOUBLE   0        /* Grow to (2 * capacity) + 1 (default) */
+#define V_GROW_HALF     1        /* Grow by half the capacity */
+#define V_GROW_CHUNK    2        /* Grow by a fixed number of elements */
+#define V_GROW_MMAP     0x100    /* Flag: grow large buffers with mremap */
+
 /* Semantic macro for determining if a v is empty */
 #define v_empty(V) (!v_first(V))
 
@@ -50,40 +90,91 @@ typedef struct __v_itr_s v_itr_t;
 /** FUNCTION PROTOTYPES **/
 
 /**
- * NOTE: __v_init(...) is not intended for use by the user. Use the wrapper
- * macro v_init(...) instead.
+ * NOTE: __v_init(...), __v_init_inline(...), __v_init_cap(...),
+ * __v_init_alloc(...) and __v_open_mmap(...) are not intended for use by the
+ * user. Use the wrapper macros v_init(...), v_init_inline(...),
+ * v_init_cap(...), v_init_inline_cap(...), v_init_alloc(...),
+ * v_init_inline_alloc(...) and v_open_mmap(...) instead.
  **/
 extern   vect_t*  __v_init(size_t __elem_size);
+extern   vect_t*  __v_init_inline(size_t __elem_size);
+extern   vect_t*  __v_init_cap(size_t __elem_size, int __inl, ds_idx_t n);
+extern   vect_t*  __v_init_alloc(size_t __elem_size, int __inl,
+                                 ds_allocator_t* const alloc);
 extern   void     v_free  (vect_t* const v);
 
-extern   int   v_size     (vect_t* const v);
-extern   int   v_cap      (vect_t* const v);
+extern   ds_idx_t v_size  (vect_t* const v);
+extern   ds_idx_t v_cap   (vect_t* const v);
+extern   int   v_reserve  (vect_t* const v, ds_idx_t n);
+extern   int   v_growth   (vect_t* const v, int policy, ds_idx_t chunk);
+extern   int   v_setops   (vect_t* const v, const ds_ops_t* const ops);
 
 extern   void  v_addf     (vect_t* const v, void* const elem);
 extern   void  v_addl     (vect_t* const v, void* const elem);
-extern   int   v_add      (vect_t* const v, int index, void* const elem);
+extern   int   v_add      (vect_t* const v, ds_idx_t index,
+                           void* const elem);
+extern   int   v_push     (vect_t* const v, void* const elem);
+extern   int   v_add_range(vect_t* const v, ds_idx_t index, void* const arr,
+                           ds_idx_t n);
+extern   int   v_append_arr(vect_t* const v, void* const arr, ds_idx_t n);
 
 extern   void  v_clear    (vect_t* const v);
 extern   int   v_contains (vect_t* const v, void* const elem);
 
-extern   void* v_get      (vect_t* const v, int index);
+extern   void* v_get      (vect_t* const v, ds_idx_t index);
+extern   void* v_get_ref  (vect_t* const v, ds_idx_t index);
 extern   void* v_first    (vect_t* const v);
 extern   void* v_last     (vect_t* const v);
 
-extern   int   v_indexof  (vect_t* const v, void* const elem);
+extern   ds_idx_t v_indexof(vect_t* const v, void* const elem);
+extern   ds_idx_t v_count (vect_t* const v, void* const elem);
+extern   void* v_min      (vect_t* const v);
+extern   void* v_max      (vect_t* const v);
 extern   void  v_apply    (vect_t* const v, void (*funct)(void* const));
-
-extern   void* v_rem      (vect_t* const v, int index);
+extern   void  v_apply_ctx(vect_t* const v, void (*funct)(void* const, void*),
+                           void* ctx);
+extern   void* v_visit    (vect_t* const v, int (*visit)(void* const, void*),
+                           void* ctx);
+extern   void  v_apply_par(vect_t* const v, void (*funct)(void* const),
+                           int nthreads);
+extern   int   v_mapreduce_par(vect_t* const v,
+                               void (*map)(void* const, void*),
+                               void (*reduce)(void*, const void*),
+                               void* acc, size_t acc_size, int nthreads);
+
+extern   void* v_rem      (vect_t* const v, ds_idx_t index);
 extern   void* v_remf     (vect_t* const v);
 extern   void* v_reml     (vect_t* const v);
-extern   void* v_set      (vect_t* const v, int index, void* const elem);
+extern   void* v_set      (vect_t* const v, ds_idx_t index,
+                           void* const elem);
+extern   int   v_rem_range(vect_t* const v, ds_idx_t index, ds_idx_t n,
+                           void* const out);
+extern   int   v_splice   (vect_t* const v, ds_idx_t index, ds_idx_t nrem,
+                           void* const arr, ds_idx_t nins, void* const out);
+
+extern   void  v_sort     (vect_t* const v, ds_cmp_t cmp);
+extern   ds_idx_t v_sorted_insert(vect_t* const v, void* const elem,
+                                  ds_cmp_t cmp);
+extern   ds_idx_t v_bsearch(vect_t* const v, void* const elem, ds_cmp_t cmp);
+extern   ds_idx_t v_lower_bound(vect_t* const v, void* const elem,
+                                ds_cmp_t cmp);
+extern   ds_idx_t v_upper_bound(vect_t* const v, void* const elem,
+                                ds_cmp_t cmp);
 
 extern   void**   v_toarr (vect_t* const v);
+extern   void*    v_data  (vect_t* const v);
+extern   ds_span_t v_span (vect_t* const v);
 extern   void     v_trim  (vect_t* const v);
 
+extern   int      v_save  (vect_t* const v, const char* path);
+extern   vect_t*  __v_open_mmap(size_t __elem_size, const char* path,
+                                int flags);
+
 
 /* Vector Iterator Functions */
-extern   v_itr_t*    v_itr       (vect_t* const v, int index);
+extern   v_itr_t*    v_itr       (vect_t* const v, ds_idx_t index);
+extern   int         v_itr_init  (v_itr_t* const itr, vect_t* const v,
+                                  ds_idx_t index);
 extern   void        vi_free     (v_itr_t* const itr);
 
 extern   int         vi_hasnext  (v_itr_t* const itr);
@@ -91,5 +182,51 @@ extern   int         vi_hasprev  (v_itr_t* const itr);
 extern   void*       vi_next     (v_itr_t* const itr);
 extern   void*       vi_prev     (v_itr_t* const itr);
 
+extern   int         vi_add      (v_itr_t* const itr, void* const elem);
+extern   void*       vi_rem      (v_itr_t* const itr);
+
+
+/**
+ * With DSTRUCTS_INLINE defined before vector.h is included, the accessors
+ * below are compiled into the caller rather than called in the library. They
+ * behave exactly like the functions they stand in for, which the library
+ * still exports, so taking the address of v_size and the like still works.
+ * See layout.h for what this asks of the caller's build.
+ **/
+#ifdef DSTRUCTS_INLINE
+
+#include "layout.h"     /* For struct __vect_s */
+
+__DS_INLINE ds_idx_t __v_size_inline(vect_t* const v) {
+   return (v ? v->__size : -1);
+}
+
+__DS_INLINE ds_idx_t __v_cap_inline(vect_t* const v) {
+   return (v ? v->__cap : -1);
+}
+
+__DS_INLINE void* __v_get_inline(vect_t* const v, ds_idx_t index) {
+   char *slot;
+
+   if(!v || index < 0 || index >= v->__size) return NULL;
+
+   slot = v->__elements + (size_t) index * v->__stride;
+
+   return (v->__inl ? (void*) slot : *(void**) slot);
+}
+
+__DS_INLINE void* __v_last_inline(vect_t* const v) {
+   return (v ? __v_get_inline(v, v->__size - 1) : NULL);
+}
+
+#define v_size(V) (__v_size_inline(V))
+#define v_cap(V) (__v_cap_inline(V))
+#define v_get(V, i) (__v_get_inline((V), (i)))
+#define v_get_ref(V, i) (__v_get_inline((V), (i)))
+#define v_first(V) (__v_get_inline((V), 0))
+#define v_last(V) (__v_last_inline(V))
+
+#endif   /* DSTRUCTS_INLINE */
+
 #endif   /* __LIBDSTRUCTS_VECTOR_H__ */
 
@@ -0,0 +1,61 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_WSDEQUE_H__
+#define __LIBDSTRUCTS_WSDEQUE_H__   /* Guard against multiple inclusion */
+
+#include "index.h"      /* For ds_idx_t */
+
+
+/**
+ * Work-stealing deque public, opaque data type. Contents only accessable
+ * through function calls.
+ *
+ * A wsd_t is a Chase-Lev deque for task schedulers. A single thread, the
+ * deque's owner, pushes and pops elements at the bottom like a stack; any
+ * number of other threads may steal elements from the top at the same time.
+ * None of these operations take a lock, and the deque grows as needed.
+ * wsd_push(...) and wsd_pop(...) must only be called by the owner;
+ * wsd_steal(...) and wsd_size(...) are safe from any thread.
+ **/
+typedef struct __wsd_s wsd_t;
+
+
+/* Wrapper macro for __wsd_init(size_t __elem_size) */
+#define wsd_init(type) (__wsd_init(sizeof(type)))
+
+/* Semantic macro for determining if a deque is empty */
+#define wsd_empty(D) (wsd_size(D) <= 0)
+
+
+/** FUNCTION PROTOTYPES **/
+
+/**
+ * NOTE: __wsd_init(...) is not intended for use by the user. Use the wrapper
+ * macro wsd_init(...) instead.
+ **/
+extern   wsd_t*   __wsd_init     (size_t __elem_size);
+extern   void     wsd_free       (wsd_t* const d);
+
+extern   ds_idx_t wsd_size       (wsd_t* const d);
+
+extern   int      wsd_push       (wsd_t* const d, void* const elem);
+extern   void*    wsd_pop        (wsd_t* const d);
+extern   void*    wsd_steal      (wsd_t* const d);
+
+#endif   /* __LIBDSTRUCTS_WSDEQUE_H__ */
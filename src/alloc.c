@@ -0,0 +1,295 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), free(...) */
+#include <string.h>     /* For memcpy(...) */
+#include "alloc.h"
+
+
+#define ARENA_BLOCK ((size_t) 64 * 1024)   /* Default block size in bytes */
+
+
+/* A type with the strictest alignment of the basic types */
+union __ds_align_u {
+   long l;
+   double d;
+   long double ld;
+   void *p;
+   void (*f)(void);
+};
+
+#define ALIGN sizeof(union __ds_align_u)
+
+/* Round n up to a multiple of ALIGN */
+#define __ROUND(n) (((n) + ALIGN - 1) / ALIGN * ALIGN)
+
+
+/**
+ * Internal arena block definition. A block's memory follows its header,
+ * which is padded out to ALIGN bytes; __used bytes of its __size are taken.
+ **/
+typedef struct __ds_block_s {
+   struct __ds_block_s *__next;
+   size_t __size;
+   size_t __used;
+} __ds_block_t;
+
+#define HEADER __ROUND(sizeof(__ds_block_t))
+
+/* First byte of a block's memory */
+#define __DATA(b) ((char*) (b) + HEADER)
+
+
+/**
+ * Internal arena definition. Blocks are kept in a chain from __first to
+ * __tail and allocated from in order; __cur is the block currently being
+ * carved up, and every block before it is considered full. __top is the most
+ * recent allocation, which may still be freed or grown in place. __hooks is
+ * the ds_allocator_t handed out by ds_arena_allocator(...).
+ **/
+struct __ds_arena_s {
+   ds_allocator_t __hooks;
+   __ds_block_t *__first;
+   __ds_block_t *__tail;
+   __ds_block_t *__cur;
+   char *__top;
+   size_t __block;
+};
+
+
+/* Local functions */
+static void* __arena_alloc(void* ctx, size_t size);
+static void* __arena_realloc(void* ctx, void* ptr, size_t old, size_t size);
+static void __arena_free(void* ctx, void* ptr, size_t size);
+
+
+
+/**
+ * A simulated constructor for an arena. No memory is set aside until the
+ * first allocation. An arena is not thread-safe.
+ *
+ * @param block - the size in bytes of the blocks the arena allocates from.
+ *    Uses a default if zero (0). Larger allocations get a block of their own.
+ * @return a pointer to an empty arena. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+ds_arena_t* ds_arena_init(size_t block) {
+   ds_arena_t *arena;
+
+   arena = malloc(sizeof(ds_arena_t));
+
+   if(!arena) return NULL;
+
+   arena->__hooks.alloc = __arena_alloc;
+   arena->__hooks.realloc = __arena_realloc;
+   arena->__hooks.free = __arena_free;
+   arena->__hooks.ctx = arena;
+   arena->__first = NULL;
+   arena->__tail = NULL;
+   arena->__cur = NULL;
+   arena->__top = NULL;
+   arena->__block = (block ? block : ARENA_BLOCK);
+
+   return arena;
+}
+
+
+/**
+ * A simulated destructor for an arena. Releases every block, invalidating
+ * all memory allocated from the arena and any container built on it.
+ *
+ * @param arena - the arena to destroy.
+ **/
+void ds_arena_free(ds_arena_t* const arena) {
+   __ds_block_t *block, *next;
+
+   if(!arena) return;
+
+   for(block = arena->__first; block; block = next) {
+      next = block->__next;
+      free(block);
+   }
+
+   free(arena);
+}
+
+
+/**
+ * Releases everything allocated from an arena at once, keeping its blocks
+ * for reuse. Containers built on the arena are torn down along with it; they
+ * must not be used, or passed to their destructors, afterwards.
+ *
+ * @param arena - the arena to reset.
+ **/
+void ds_arena_reset(ds_arena_t* const arena) {
+   __ds_block_t *block;
+
+   if(!arena) return;
+
+   for(block = arena->__first; block; block = block->__next)
+      block->__used = 0;
+
+   arena->__cur = arena->__first;
+   arena->__top = NULL;
+}
+
+
+/**
+ * Allocates memory from an arena. The memory is aligned for any type and
+ * lives until the arena is reset or destroyed.
+ *
+ * @param arena - the arena to allocate from.
+ * @param size - the number of bytes to allocate.
+ * @return a pointer to the allocated memory. Returns NULL if the arena is
+ *    NULL or upon allocation error.
+ **/
+void* ds_arena_alloc(ds_arena_t* const arena, size_t size) {
+   __ds_block_t *block;
+   size_t bytes;
+
+   if(!arena) return NULL;
+
+   /* Guard against size_t overflow */
+   if(size > (size_t) -1 - HEADER - ALIGN) return NULL;
+
+   size = (size ? __ROUND(size) : ALIGN);
+
+   for(block = arena->__cur; block; block = block->__next)
+      if(block->__size - block->__used >= size)
+         break;
+
+   /* No block has room; add one */
+   if(!block) {
+      bytes = (size > arena->__block ? size : arena->__block);
+      block = malloc(HEADER + bytes);
+
+      if(!block) return NULL;
+
+      block->__next = NULL;
+      block->__size = bytes;
+      block->__used = 0;
+
+      if(arena->__tail)
+         arena->__tail->__next = block;
+      else
+         arena->__first = block;
+
+      arena->__tail = block;
+   }
+
+   arena->__cur = block;
+   arena->__top = __DATA(block) + block->__used;
+   block->__used += size;
+
+   return arena->__top;
+}
+
+
+/**
+ * Retrieve the number of bytes currently allocated from an arena, including
+ * alignment padding.
+ *
+ * @param arena - the arena to inspect.
+ * @return the number of bytes in use. Returns 0 if the arena is NULL.
+ **/
+size_t ds_arena_used(ds_arena_t* const arena) {
+   __ds_block_t *block;
+   size_t used;
+
+   if(!arena) return 0;
+
+   used = 0;
+
+   for(block = arena->__first; block; block = block->__next)
+      used += block->__used;
+
+   return used;
+}
+
+
+/**
+ * Retrieve the allocator hooks of an arena, for use with the containers'
+ * *_init_alloc variants. The hooks live inside the arena.
+ *
+ * @param arena - the arena to allocate from.
+ * @return the arena's allocator. Returns NULL if the arena is NULL.
+ **/
+ds_allocator_t* ds_arena_allocator(ds_arena_t* const arena) {
+   return (arena ? &arena->__hooks : NULL);
+}
+
+
+/**
+ * Allocator hook for an arena.
+ **/
+static void* __arena_alloc(void* ctx, size_t size) {
+   return ds_arena_alloc(ctx, size);
+}
+
+
+/**
+ * Reallocator hook for an arena. The most recent allocation is grown or
+ * shrunk in place when its block has room; anything else is copied into a
+ * new allocation.
+ **/
+static void* __arena_realloc(void* ctx, void* ptr, size_t old, size_t size) {
+   ds_arena_t *arena;
+   __ds_block_t *block;
+   size_t offset;
+   void *moved;
+
+   arena = ctx;
+
+   if(!ptr) return ds_arena_alloc(arena, size);
+
+   block = arena->__cur;
+
+   if(ptr == arena->__top && size <= (size_t) -1 - ALIGN) {
+      offset = (size_t) (arena->__top - __DATA(block));
+
+      if(block->__size - offset >= __ROUND(size)) {
+         block->__used = offset + (size ? __ROUND(size) : ALIGN);
+         return ptr;
+      }
+   }
+
+   moved = ds_arena_alloc(arena, size);
+
+   if(moved)
+      memcpy(moved, ptr, (old < size ? old : size));
+
+   return moved;
+}
+
+
+/**
+ * Deallocator hook for an arena. Only the most recent allocation is given
+ * back; everything else waits for the arena to be reset.
+ **/
+static void __arena_free(void* ctx, void* ptr, size_t size) {
+   ds_arena_t *arena;
+
+   (void) size;
+
+   arena = ctx;
+
+   if(!ptr || ptr != arena->__top) return;
+
+   arena->__cur->__used = (size_t) (arena->__top - __DATA(arena->__cur));
+   arena->__top = NULL;
+}
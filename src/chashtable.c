@@ -0,0 +1,896 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), aligned_alloc(...), free(...) */
+#include <string.h>     /* For memcpy(...) */
+#include <stdatomic.h>  /* For atomic_*(...) */
+#include <pthread.h>    /* For pthread_mutex_t, pthread_mutex_*(...) */
+#include "chashtable.h"
+
+
+#define ADDED 1
+#define EXIST 1
+#define CACHE_LINE 64
+#define SHARD_BITS 6
+#define SHARDS (1 << SHARD_BITS)
+#define INIT_SIZE 8     /* Initial buckets per shard; a power of two */
+#define MIGRATE 16      /* Buckets moved per write while a shard grows */
+
+/* Maximum load factor, as a fraction of LOAD_DEN */
+#define LOAD_NUM 3
+#define LOAD_DEN 4
+
+
+/**
+ * Internal link for memory awaiting reclamation. Only used in this file.
+ * Anything a reader may still be looking at when a writer discards it
+ * (nodes, bucket arrays and generations) starts with one, and is put on its
+ * shard's list of retired memory instead of being freed right away.
+ **/
+typedef struct __cht_dead_s {
+   struct __cht_dead_s *next;
+} __cht_dead_t;
+
+
+/**
+ * Internal entry type. Only used in this file.
+ *
+ * The key and hash never change once a node is published. Writers replace
+ * the value atomically, and unlink a removed node without touching its own
+ * __next, so a reader standing on it can always carry on down the chain.
+ **/
+typedef struct __cht_node_s {
+   __cht_dead_t __dead;
+   _Atomic(struct __cht_node_s*) __next;
+   _Atomic(void*) __val;
+   unsigned long __hash;
+   char __key[];
+} __cht_node_t;
+
+
+/* Internal bucket array type. Only used in this file. */
+typedef struct __cht_tab_s {
+   __cht_dead_t __dead;
+   size_t __mask;
+   _Atomic(__cht_node_t*) __buckets[];
+} __cht_tab_t;
+
+
+/**
+ * Internal generation type. Only used in this file.
+ *
+ * While a shard grows, its entries are spread over the new bucket array,
+ * __cur, and the one it replaces, __old. Buckets move from __old to __cur a
+ * few at a time: each is copied into __cur before it is emptied in __old, so
+ * a reader searching __old and then __cur cannot miss an entry. A reader
+ * loads the pair in one go and checks afterwards that it is still current.
+ **/
+typedef struct __cht_gen_s {
+   __cht_dead_t __dead;
+   __cht_tab_t *__cur;
+   __cht_tab_t *__old;
+} __cht_gen_t;
+
+
+/**
+ * Internal shard definition. Only used in this file.
+ *
+ * Writers hold __lock. Readers instead register in __readers[e & 1] for the
+ * epoch e they start in. Retired memory collects in __pending; a writer
+ * flipping the epoch moves it to __waiting, and frees it once no reader from
+ * the previous epoch remains, so readers never wait on writers and writers
+ * never wait on readers. __moved is the next bucket of __old to move.
+ **/
+typedef struct __cht_shard_s {
+   _Alignas(CACHE_LINE) _Atomic(__cht_gen_t*) __gen;
+   atomic_uint __epoch;
+   atomic_long __readers[2];
+   atomic_int __size;
+   pthread_mutex_t __lock;
+   size_t __moved;
+   __cht_dead_t *__pending;
+   __cht_dead_t *__waiting;
+} __cht_shard_t;
+
+
+/* Internal concurrent hashtable definition */
+struct __cht_s {
+   __cht_shard_t *__shards;
+   ds_hash_t __hash;
+   ds_eq_t __eq;
+   size_t __key_size;
+};
+
+
+/* Shard holding a hash */
+#define __CHT_SHARD(ht, h) (&(ht)->__shards[(h) & (SHARDS - 1)])
+
+/* Bucket of a bucket array holding a hash; its low bits pick the shard */
+#define __CHT_BUCKET(tab, h) (&(tab)->__buckets[((h) >> SHARD_BITS) & \
+                                                (tab)->__mask])
+
+
+/* Local functions */
+static int __cht_shard(__cht_shard_t* const s);
+static void __cht_drop(__cht_shard_t* const s);
+static __cht_tab_t* __cht_tab(size_t size);
+static __cht_gen_t* __cht_gen(__cht_tab_t* const cur, __cht_tab_t* const old);
+static __cht_node_t* __cht_node(cht_t* const ht, void* const key,
+                                unsigned long h, void* const val);
+static unsigned __cht_enter(__cht_shard_t* const s);
+static void __cht_leave(__cht_shard_t* const s, unsigned e);
+static void __cht_retire(__cht_shard_t* const s, void* const dead);
+static void __cht_reclaim(__cht_shard_t* const s);
+static __cht_node_t* __cht_scan(cht_t* const ht, __cht_tab_t* const tab,
+                                void* const key, unsigned long h);
+static __cht_node_t* __cht_read(cht_t* const ht, __cht_shard_t* const s,
+                                void* const key, unsigned long h);
+static void __cht_link(__cht_tab_t* const tab, __cht_node_t* const node);
+static int __cht_move(cht_t* const ht, __cht_shard_t* const s,
+                      __cht_gen_t* const gen, size_t i);
+static void __cht_step(cht_t* const ht, __cht_shard_t* const s);
+static void __cht_grow(__cht_shard_t* const s);
+static __cht_gen_t* __cht_prepare(cht_t* const ht, __cht_shard_t* const s,
+                                  unsigned long h);
+
+
+/**
+ * A simulated constructor for a concurrent hashtable.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro cht_init(type) or cht_init_fn(type, hash, eq),
+ * where type is the type of the keys in the hashtable.
+ *
+ * @param __key_size - the size of a key in the hashtable.
+ * @param hash - the function used to hash keys. Uses ds_hash_mem(...) if
+ *    NULL.
+ * @param eq - the function used to compare keys. Uses ds_eq_mem(...) if NULL.
+ * @return a pointer to an empty hashtable. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+cht_t* __cht_init(size_t __key_size, ds_hash_t hash, ds_eq_t eq) {
+   cht_t *table;
+   int i;
+
+   table = malloc(sizeof(cht_t));
+
+   if(!table) return NULL;
+
+   table->__shards = aligned_alloc(CACHE_LINE, sizeof(__cht_shard_t) * SHARDS);
+
+   if(!table->__shards) {
+      free(table);
+      return NULL;
+   }
+
+   table->__hash = (hash ? hash : ds_hash_mem);
+   table->__eq = (eq ? eq : ds_eq_mem);
+   table->__key_size = __key_size;
+
+   for(i = 0; i < SHARDS; i++)
+      if(!__cht_shard(&table->__shards[i])) {
+         while(i--)
+            __cht_drop(&table->__shards[i]);
+
+         free(table->__shards);
+         free(table);
+         return NULL;
+      }
+
+   return table;
+}
+
+
+/**
+ * Set up an empty shard.
+ *
+ * @param s - the shard to set up.
+ * @return 1 if the shard was set up. Returns 0 upon allocation error, in which
+ *    case nothing is left to release.
+ **/
+static int __cht_shard(__cht_shard_t* const s) {
+   __cht_tab_t *tab;
+   __cht_gen_t *gen;
+
+   tab = __cht_tab(INIT_SIZE);
+   gen = (tab ? __cht_gen(tab, NULL) : NULL);
+
+   if(!gen || pthread_mutex_init(&s->__lock, NULL) != 0) {
+      free(gen);
+      free(tab);
+      return !ADDED;
+   }
+
+   atomic_init(&s->__gen, gen);
+   atomic_init(&s->__epoch, 0);
+   atomic_init(&s->__readers[0], 0);
+   atomic_init(&s->__readers[1], 0);
+   atomic_init(&s->__size, 0);
+   s->__moved = 0;
+   s->__pending = NULL;
+   s->__waiting = NULL;
+
+   return ADDED;
+}
+
+
+/**
+ * A simulated destructor for a concurrent hashtable. Frees the values
+ * remaining in the table. Must not be called while other threads use the
+ * table.
+ *
+ * @param ht - the hashtable to destroy.
+ **/
+void cht_free(cht_t* const ht) {
+   int i;
+
+   if(!ht) return;
+
+   for(i = 0; i < SHARDS; i++)
+      __cht_drop(&ht->__shards[i]);
+
+   free(ht->__shards);
+   free(ht);
+}
+
+
+/**
+ * Release everything a shard holds: its entries, applying free(...) to each
+ * value, its bucket arrays and any retired memory.
+ *
+ * @param s - the shard to release.
+ **/
+static void __cht_drop(__cht_shard_t* const s) {
+   __cht_dead_t *dead, *next;
+   __cht_node_t *node, *after;
+   __cht_tab_t *tabs[2];
+   __cht_gen_t *gen;
+   size_t i;
+   int t;
+
+   gen = atomic_load_explicit(&s->__gen, memory_order_relaxed);
+   tabs[0] = gen->__cur;
+   tabs[1] = gen->__old;
+
+   for(t = 0; t < 2 && tabs[t]; t++) {
+      for(i = 0; i <= tabs[t]->__mask; i++)
+         for(node = atomic_load_explicit(&tabs[t]->__buckets[i],
+                                         memory_order_relaxed);
+             node; node = after) {
+            after = atomic_load_explicit(&node->__next, memory_order_relaxed);
+            free(atomic_load_explicit(&node->__val, memory_order_relaxed));
+            free(node);
+         }
+
+      free(tabs[t]);
+   }
+
+   free(gen);
+
+   for(dead = s->__pending; dead; dead = next) {
+      next = dead->next;
+      free(dead);
+   }
+
+   for(dead = s->__waiting; dead; dead = next) {
+      next = dead->next;
+      free(dead);
+   }
+
+   pthread_mutex_destroy(&s->__lock);
+}
+
+
+/**
+ * Retrieve the size of a concurrent hashtable. While other threads are
+ * adding or removing entries, the result is only a snapshot.
+ *
+ * @param ht - the hashtable to retrieve the size of.
+ * @return the number of entries in the hashtable. Returns -1 if the hashtable
+ *    is NULL.
+ **/
+int cht_size(cht_t* const ht) {
+   int i, size;
+
+   if(!ht) return -1;
+
+   for(i = size = 0; i < SHARDS; i++)
+      size += atomic_load_explicit(&ht->__shards[i].__size,
+                                   memory_order_relaxed);
+
+   return size;
+}
+
+
+/**
+ * Allocate an empty bucket array.
+ *
+ * @param size - the number of buckets; a power of two.
+ * @return a pointer to the bucket array. Returns NULL upon allocation error.
+ **/
+static __cht_tab_t* __cht_tab(size_t size) {
+   __cht_tab_t *tab;
+   size_t i;
+
+   tab = malloc(sizeof(__cht_tab_t) + sizeof(_Atomic(__cht_node_t*)) * size);
+
+   if(!tab) return NULL;
+
+   tab->__mask = size - 1;
+
+   for(i = 0; i < size; i++)
+      atomic_init(&tab->__buckets[i], NULL);
+
+   return tab;
+}
+
+
+/**
+ * Allocate a generation.
+ *
+ * @param cur - the bucket array entries are added to.
+ * @param old - the bucket array being moved into cur, or NULL.
+ * @return a pointer to the generation. Returns NULL upon allocation error.
+ **/
+static __cht_gen_t* __cht_gen(__cht_tab_t* const cur, __cht_tab_t* const old) {
+   __cht_gen_t *gen;
+
+   gen = malloc(sizeof(__cht_gen_t));
+
+   if(!gen) return NULL;
+
+   gen->__cur = cur;
+   gen->__old = old;
+
+   return gen;
+}
+
+
+/**
+ * Allocate an unlinked entry.
+ *
+ * @param ht - the hashtable the entry is for.
+ * @param key - the key of the entry, which is copied.
+ * @param h - the hash of the key.
+ * @param val - the value of the entry.
+ * @return a pointer to the entry. Returns NULL upon allocation error.
+ **/
+static __cht_node_t* __cht_node(cht_t* const ht, void* const key,
+                                unsigned long h, void* const val) {
+   __cht_node_t *node;
+
+   node = malloc(sizeof(__cht_node_t) + ht->__key_size);
+
+   if(!node) return NULL;
+
+   atomic_init(&node->__next, NULL);
+   atomic_init(&node->__val, val);
+   node->__hash = h;
+   memcpy(node->__key, key, ht->__key_size);
+
+   return node;
+}
+
+
+/**
+ * Register a reader with a shard. Until it leaves, nothing the reader can
+ * reach is freed. Rechecking the epoch after registering catches a writer
+ * flipping it in between, in which case the reader registers again.
+ *
+ * @param s - the shard to read.
+ * @return the epoch the reader registered in.
+ **/
+static unsigned __cht_enter(__cht_shard_t* const s) {
+   unsigned e;
+
+   for(;;) {
+      e = atomic_load(&s->__epoch);
+      atomic_fetch_add(&s->__readers[e & 1], 1);
+
+      if(atomic_load(&s->__epoch) == e) return e;
+
+      atomic_fetch_sub(&s->__readers[e & 1], 1);
+   }
+}
+
+
+/**
+ * Unregister a reader from a shard.
+ *
+ * @param s - the shard read.
+ * @param e - the epoch returned by __cht_enter(...).
+ **/
+static void __cht_leave(__cht_shard_t* const s, unsigned e) {
+   atomic_fetch_sub_explicit(&s->__readers[e & 1], 1, memory_order_release);
+}
+
+
+/**
+ * Put memory that readers may still be looking at on a shard's list of
+ * retired memory. Writers only, under the shard's lock.
+ *
+ * @param s - the shard the memory belonged to.
+ * @param dead - the memory, which starts with an __cht_dead_t.
+ **/
+static void __cht_retire(__cht_shard_t* const s, void* const dead) {
+   ((__cht_dead_t*) dead)->next = s->__pending;
+   s->__pending = dead;
+}
+
+
+/**
+ * Free whatever retired memory of a shard no reader can still reach. Writers
+ * only, under the shard's lock. Memory retired during epoch e is moved to
+ * __waiting by flipping the epoch to e + 1; readers arriving from then on
+ * cannot reach it, so it is freed once the readers of epoch e are gone.
+ *
+ * @param s - the shard to reclaim memory from.
+ **/
+static void __cht_reclaim(__cht_shard_t* const s) {
+   __cht_dead_t *dead, *next;
+   unsigned e;
+
+   if(!s->__waiting && s->__pending) {
+      s->__waiting = s->__pending;
+      s->__pending = NULL;
+      atomic_fetch_add(&s->__epoch, 1);
+   }
+
+   if(!s->__waiting) return;
+
+   e = atomic_load_explicit(&s->__epoch, memory_order_relaxed);
+
+   if(atomic_load(&s->__readers[(e - 1) & 1]) != 0) return;
+
+   for(dead = s->__waiting; dead; dead = next) {
+      next = dead->next;
+      free(dead);
+   }
+
+   s->__waiting = NULL;
+}
+
+
+/**
+ * Search one bucket array for a key.
+ *
+ * @param ht - the hashtable to search.
+ * @param tab - the bucket array to search.
+ * @param key - the key to search for.
+ * @param h - the hash of the key.
+ * @return the entry holding the key. Returns NULL if there is none.
+ **/
+static __cht_node_t* __cht_scan(cht_t* const ht, __cht_tab_t* const tab,
+                                void* const key, unsigned long h) {
+   __cht_node_t *node;
+
+   for(node = atomic_load_explicit(__CHT_BUCKET(tab, h), memory_order_acquire);
+       node; node = atomic_load_explicit(&node->__next, memory_order_acquire))
+      if(node->__hash == h && ht->__eq(node->__key, key, ht->__key_size))
+         return node;
+
+   return NULL;
+}
+
+
+/**
+ * Search a shard for a key without taking its lock. The caller must be
+ * registered with __cht_enter(...). A search that comes up empty while the
+ * shard moved to a new generation may have missed an entry being moved, and
+ * is repeated.
+ *
+ * @param ht - the hashtable to search.
+ * @param s - the shard holding the key.
+ * @param key - the key to search for.
+ * @param h - the hash of the key.
+ * @return the entry holding the key. Returns NULL if there is none.
+ **/
+static __cht_node_t* __cht_read(cht_t* const ht, __cht_shard_t* const s,
+                                void* const key, unsigned long h) {
+   __cht_node_t *node;
+   __cht_gen_t *gen, *now;
+
+   gen = atomic_load_explicit(&s->__gen, memory_order_acquire);
+
+   for(;;) {
+      node = (gen->__old ? __cht_scan(ht, gen->__old, key, h) : NULL);
+
+      if(!node)
+         node = __cht_scan(ht, gen->__cur, key, h);
+
+      now = atomic_load_explicit(&s->__gen, memory_order_acquire);
+
+      if(node || now == gen) return node;
+
+      gen = now;
+   }
+}
+
+
+/**
+ * Publish an entry at the head of its bucket.
+ *
+ * @param tab - the bucket array to add the entry to.
+ * @param node - the entry.
+ **/
+static void __cht_link(__cht_tab_t* const tab, __cht_node_t* const node) {
+   _Atomic(__cht_node_t*) *bucket;
+
+   bucket = __CHT_BUCKET(tab, node->__hash);
+
+   atomic_store_explicit(&node->__next,
+                         atomic_load_explicit(bucket, memory_order_relaxed),
+                         memory_order_relaxed);
+   atomic_store_explicit(bucket, node, memory_order_release);
+}
+
+
+/**
+ * Move one bucket of a growing shard's old bucket array into the new one.
+ * The bucket's entries are copied, rather than relinked, so that readers
+ * still walking the old chain are not led astray.
+ *
+ * @param ht - the hashtable.
+ * @param s - the shard.
+ * @param gen - the shard's current generation.
+ * @param i - the index of the bucket in the old array.
+ * @return 1 if the bucket was moved (or was empty). Returns 0 upon
+ *    allocation error, in which case the bucket is left where it was.
+ **/
+static int __cht_move(cht_t* const ht, __cht_shard_t* const s,
+                      __cht_gen_t* const gen, size_t i) {
+   __cht_node_t *node, *copy, *copies, *next;
+
+   node = atomic_load_explicit(&gen->__old->__buckets[i],
+                               memory_order_relaxed);
+
+   if(!node) return ADDED;
+
+   /* Copy the whole bucket first, so that a failure moves nothing */
+   for(copies = NULL; node;
+       node = atomic_load_explicit(&node->__next, memory_order_relaxed)) {
+      copy = __cht_node(ht, node->__key, node->__hash,
+                        atomic_load_explicit(&node->__val,
+                                             memory_order_relaxed));
+
+      if(!copy) {
+         for(; copies; copies = next) {
+            next = atomic_load_explicit(&copies->__next,
+                                        memory_order_relaxed);
+            free(copies);
+         }
+
+         return !ADDED;
+      }
+
+      atomic_store_explicit(&copy->__next, copies, memory_order_relaxed);
+      copies = copy;
+   }
+
+   for(copy = copies; copy; copy = next) {
+      next = atomic_load_explicit(&copy->__next, memory_order_relaxed);
+      __cht_link(gen->__cur, copy);
+   }
+
+   /* Only empty the old bucket once every copy is visible */
+   node = atomic_load_explicit(&gen->__old->__buckets[i],
+                               memory_order_relaxed);
+   atomic_store_explicit(&gen->__old->__buckets[i], NULL,
+                         memory_order_release);
+
+   for(; node; node = next) {
+      next = atomic_load_explicit(&node->__next, memory_order_relaxed);
+      __cht_retire(s, node);
+   }
+
+   return ADDED;
+}
+
+
+/**
+ * Move the next few buckets of a growing shard, and retire its old bucket
+ * array once it is empty. A bucket that cannot be moved for lack of memory
+ * is retried on the next write.
+ *
+ * @param ht - the hashtable.
+ * @param s - the growing shard.
+ **/
+static void __cht_step(cht_t* const ht, __cht_shard_t* const s) {
+   __cht_gen_t *gen, *done;
+   int n;
+
+   gen = atomic_load_explicit(&s->__gen, memory_order_relaxed);
+
+   for(n = 0; n < MIGRATE && s->__moved <= gen->__old->__mask; n++) {
+      if(!__cht_move(ht, s, gen, s->__moved)) return;
+
+      s->__moved++;
+   }
+
+   if(s->__moved <= gen->__old->__mask) return;
+
+   done = __cht_gen(gen->__cur, NULL);
+
+   if(!done) return;
+
+   atomic_store_explicit(&s->__gen, done, memory_order_release);
+
+   __cht_retire(s, gen->__old);
+   __cht_retire(s, gen);
+}
+
+
+/**
+ * Start growing a shard into a bucket array twice the size, if it has become
+ * too full and is not growing already. If memory is short the shard simply
+ * stays as it is.
+ *
+ * @param s - the shard.
+ **/
+static void __cht_grow(__cht_shard_t* const s) {
+   __cht_gen_t *gen, *next;
+   __cht_tab_t *tab;
+   size_t cap;
+
+   gen = atomic_load_explicit(&s->__gen, memory_order_relaxed);
+
+   if(gen->__old) return;
+
+   cap = gen->__cur->__mask + 1;
+
+   if((size_t) atomic_load_explicit(&s->__size, memory_order_relaxed) *
+      LOAD_DEN <= cap * LOAD_NUM)
+      return;
+
+   tab = __cht_tab(cap << 1);
+   next = (tab ? __cht_gen(tab, gen->__cur) : NULL);
+
+   if(!next) {
+      free(tab);
+      return;
+   }
+
+   s->__moved = 0;
+   atomic_store_explicit(&s->__gen, next, memory_order_release);
+
+   __cht_retire(s, gen);
+}
+
+
+/**
+ * Get a shard ready for a write to a key: if the shard is growing, move the
+ * key's old bucket, so that the key can only be in the new bucket array, and
+ * a few more. Writers only, under the shard's lock.
+ *
+ * @param ht - the hashtable.
+ * @param s - the shard holding the key.
+ * @param h - the hash of the key.
+ * @return the shard's generation, whose __cur is the only bucket array that
+ *    may hold the key. Returns NULL upon allocation error.
+ **/
+static __cht_gen_t* __cht_prepare(cht_t* const ht, __cht_shard_t* const s,
+                                  unsigned long h) {
+   __cht_gen_t *gen;
+
+   gen = atomic_load_explicit(&s->__gen, memory_order_relaxed);
+
+   if(!gen->__old) return gen;
+
+   if(!__cht_move(ht, s, gen, (size_t) (__CHT_BUCKET(gen->__old, h) -
+                                        gen->__old->__buckets)))
+      return NULL;
+
+   __cht_step(ht, s);
+
+   return atomic_load_explicit(&s->__gen, memory_order_relaxed);
+}
+
+
+/**
+ * Add an entry to a concurrent hashtable if its key is not already present.
+ *
+ * @param ht - the hashtable to add the entry to.
+ * @param key - the key of the entry; it is copied into the table.
+ * @param val - the value of the entry, which may be NULL.
+ * @return 1 if the entry was added. Returns 0 if the hashtable or key is NULL,
+ *    if the key already exists, or upon allocation error.
+ **/
+int cht_add(cht_t* const ht, void* const key, void* const val) {
+   __cht_shard_t *s;
+   __cht_node_t *node;
+   __cht_gen_t *gen;
+   unsigned long h;
+   int added;
+
+   if(!ht || !key) return !ADDED;
+
+   h = ht->__hash(key, ht->__key_size);
+   s = __CHT_SHARD(ht, h);
+   added = !ADDED;
+
+   pthread_mutex_lock(&s->__lock);
+
+   gen = __cht_prepare(ht, s, h);
+
+   if(gen && !__cht_scan(ht, gen->__cur, key, h) &&
+      (node = __cht_node(ht, key, h, val))) {
+      __cht_link(gen->__cur, node);
+      atomic_fetch_add_explicit(&s->__size, 1, memory_order_relaxed);
+      __cht_grow(s);
+      added = ADDED;
+   }
+
+   __cht_reclaim(s);
+
+   pthread_mutex_unlock(&s->__lock);
+
+   return added;
+}
+
+
+/**
+ * Associate a value with a key in a concurrent hashtable, adding the key if
+ * it does not already exist.
+ *
+ * @param ht - the hashtable to store the entry in.
+ * @param key - the key of the entry; it is copied into the table.
+ * @param val - the value to store, which may be NULL.
+ * @return the value previously associated with the key. Returns NULL if the
+ *    key was newly added or upon error.
+ **/
+void* cht_put(cht_t* const ht, void* const key, void* const val) {
+   __cht_shard_t *s;
+   __cht_node_t *node;
+   __cht_gen_t *gen;
+   unsigned long h;
+   void *former;
+
+   if(!ht || !key) return NULL;
+
+   h = ht->__hash(key, ht->__key_size);
+   s = __CHT_SHARD(ht, h);
+   former = NULL;
+
+   pthread_mutex_lock(&s->__lock);
+
+   gen = __cht_prepare(ht, s, h);
+
+   if(gen && (node = __cht_scan(ht, gen->__cur, key, h)))
+      former = atomic_exchange_explicit(&node->__val, val,
+                                        memory_order_acq_rel);
+   else if(gen && (node = __cht_node(ht, key, h, val))) {
+      __cht_link(gen->__cur, node);
+      atomic_fetch_add_explicit(&s->__size, 1, memory_order_relaxed);
+      __cht_grow(s);
+   }
+
+   __cht_reclaim(s);
+
+   pthread_mutex_unlock(&s->__lock);
+
+   return former;
+}
+
+
+/**
+ * Determines if a key is contained within a concurrent hashtable. Takes no
+ * lock.
+ *
+ * @param ht - the hashtable possibly containing the key.
+ * @param key - the key to search for.
+ * @return 1 if the key exists in the hashtable. Returns 0 otherwise or if
+ *    either parameter is NULL.
+ **/
+int cht_contains(cht_t* const ht, void* const key) {
+   __cht_shard_t *s;
+   unsigned long h;
+   unsigned e;
+   int found;
+
+   if(!ht || !key) return !EXIST;
+
+   h = ht->__hash(key, ht->__key_size);
+   s = __CHT_SHARD(ht, h);
+
+   e = __cht_enter(s);
+   found = (__cht_read(ht, s, key, h) ? EXIST : !EXIST);
+   __cht_leave(s, e);
+
+   return found;
+}
+
+
+/**
+ * Retrieve the value associated with a key in a concurrent hashtable. Takes
+ * no lock. The table does not keep the value alive: if another thread may
+ * remove the entry and free its value, the caller must arrange for the value
+ * to outlive its use.
+ *
+ * @param ht - the hashtable to search.
+ * @param key - the key to search for.
+ * @return the value associated with the key. Returns NULL if the key does not
+ *    exist or if either parameter is NULL.
+ **/
+void* cht_get(cht_t* const ht, void* const key) {
+   __cht_shard_t *s;
+   __cht_node_t *node;
+   unsigned long h;
+   unsigned e;
+   void *val;
+
+   if(!ht || !key) return NULL;
+
+   h = ht->__hash(key, ht->__key_size);
+   s = __CHT_SHARD(ht, h);
+
+   e = __cht_enter(s);
+   node = __cht_read(ht, s, key, h);
+   val = (node ? atomic_load_explicit(&node->__val, memory_order_acquire) :
+          NULL);
+   __cht_leave(s, e);
+
+   return val;
+}
+
+
+/**
+ * Remove an entry from a concurrent hashtable.
+ *
+ * @param ht - the hashtable to remove the entry from.
+ * @param key - the key of the entry to remove.
+ * @return the value of the removed entry. Returns NULL if the key does not
+ *    exist, if either parameter is NULL, or upon allocation error.
+ **/
+void* cht_rem(cht_t* const ht, void* const key) {
+   _Atomic(__cht_node_t*) *link;
+   __cht_shard_t *s;
+   __cht_node_t *node;
+   __cht_gen_t *gen;
+   unsigned long h;
+   void *former;
+
+   if(!ht || !key) return NULL;
+
+   h = ht->__hash(key, ht->__key_size);
+   s = __CHT_SHARD(ht, h);
+   former = NULL;
+
+   pthread_mutex_lock(&s->__lock);
+
+   gen = __cht_prepare(ht, s, h);
+
+   for(link = (gen ? __CHT_BUCKET(gen->__cur, h) : NULL);
+       link && (node = atomic_load_explicit(link, memory_order_relaxed));
+       link = &node->__next)
+      if(node->__hash == h && ht->__eq(node->__key, key, ht->__key_size)) {
+         former = atomic_load_explicit(&node->__val, memory_order_relaxed);
+
+         /* Readers on the node keep following its own __next */
+         atomic_store_explicit(link, atomic_load_explicit(&node->__next,
+                               memory_order_relaxed), memory_order_release);
+         atomic_fetch_sub_explicit(&s->__size, 1, memory_order_relaxed);
+         __cht_retire(s, node);
+         break;
+      }
+
+   __cht_reclaim(s);
+
+   pthread_mutex_unlock(&s->__lock);
+
+   return former;
+}
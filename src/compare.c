@@ -0,0 +1,281 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <limits.h>     /* For ULONG_MAX */
+#include <stdint.h>     /* For int64_t, uint64_t */
+#include <string.h>     /* For memcmp(...), memcpy(...) */
+#include "compare.h"
+#include "ops.h"
+
+
+/* Three-way compare of two scalars of the same type */
+#define __DS_CMP3(type, a, b) \
+   ((*(const type*) (a) > *(const type*) (b)) - \
+    (*(const type*) (a) < *(const type*) (b)))
+
+/* Three-way compare of two floating point values, NaN last */
+#define __DS_FCMP3(type, a, b) \
+   (*(const type*) (a) != *(const type*) (a) ? \
+      (*(const type*) (b) != *(const type*) (b) ? 0 : 1) : \
+    *(const type*) (b) != *(const type*) (b) ? -1 : __DS_CMP3(type, a, b))
+
+
+const ds_ops_t ds_ops_mem = { ds_cmp_mem, ds_eq_mem, ds_hash_mem };
+const ds_ops_t ds_ops_int = { ds_cmp_int, ds_eq_int, ds_hash_mem };
+const ds_ops_t ds_ops_uint = { ds_cmp_uint, ds_eq_uint, ds_hash_mem };
+const ds_ops_t ds_ops_i64 = { ds_cmp_i64, ds_eq_i64, ds_hash_mem };
+const ds_ops_t ds_ops_u64 = { ds_cmp_u64, ds_eq_u64, ds_hash_mem };
+const ds_ops_t ds_ops_float = { ds_cmp_float, ds_eq_float, ds_hash_float };
+const ds_ops_t ds_ops_double = { ds_cmp_double, ds_eq_double, ds_hash_double };
+
+
+/**
+ * Finalize a hash so that every input bit affects every output bit. Uses the
+ * MurmurHash3 finalizer for the width of an unsigned long.
+ *
+ * @param h - the hash to mix.
+ * @return the mixed hash.
+ **/
+static unsigned long __ds_mix(unsigned long h) {
+#if ULONG_MAX > 0xffffffffUL
+   h ^= h >> 33;
+   h *= 0xff51afd7ed558ccdUL;
+   h ^= h >> 33;
+   h *= 0xc4ceb9fe1a85ec53UL;
+   h ^= h >> 33;
+#else
+   h ^= h >> 16;
+   h *= 0x85ebca6bUL;
+   h ^= h >> 13;
+   h *= 0xc2b2ae35UL;
+   h ^= h >> 16;
+#endif
+
+   return h;
+}
+
+
+/**
+ * Hash an element by its bytes. Elements the size of an int or a long are
+ * mixed directly; anything else goes through FNV-1a first.
+ *
+ * @param elem - the element to hash.
+ * @param size - the size of the element in bytes.
+ * @return the hash of the element.
+ **/
+unsigned long ds_hash_mem(const void* elem, size_t size) {
+   const unsigned char *bytes;
+   unsigned long h;
+   unsigned int u;
+   size_t i;
+
+   if(size == sizeof(unsigned long)) {
+      memcpy(&h, elem, sizeof(h));
+      return __ds_mix(h);
+   }
+
+   if(size == sizeof(unsigned int)) {
+      memcpy(&u, elem, sizeof(u));
+      return __ds_mix(u);
+   }
+
+   bytes = elem;
+   h = 2166136261UL;
+
+   for(i = 0; i < size; i++) {
+      h ^= bytes[i];
+      h *= 16777619UL;
+   }
+
+   return __ds_mix(h ^ size);
+}
+
+
+/**
+ * Compare two elements for equality by their bytes.
+ *
+ * @param a - the first element.
+ * @param b - the second element.
+ * @param size - the size of the elements in bytes.
+ * @return 1 if the elements are bytewise equal. Returns 0 otherwise.
+ **/
+int ds_eq_mem(const void* a, const void* b, size_t size) {
+   return (memcmp(a, b, size) == 0);
+}
+
+
+/**
+ * Compare two elements by their bytes, in the order memcmp(...) gives.
+ *
+ * @param a - the first element.
+ * @param b - the second element.
+ * @param size - the size of the elements in bytes.
+ * @return -1, 0 or 1 as a orders before, with or after b.
+ **/
+int ds_cmp_mem(const void* a, const void* b, size_t size) {
+   int cmp;
+
+   cmp = memcmp(a, b, size);
+
+   return (cmp > 0) - (cmp < 0);
+}
+
+
+/** Scalar comparators **/
+
+int ds_cmp_int(const void* a, const void* b, size_t size) {
+   (void) size;
+   return __DS_CMP3(int, a, b);
+}
+
+int ds_cmp_uint(const void* a, const void* b, size_t size) {
+   (void) size;
+   return __DS_CMP3(unsigned int, a, b);
+}
+
+int ds_cmp_i64(const void* a, const void* b, size_t size) {
+   (void) size;
+   return __DS_CMP3(int64_t, a, b);
+}
+
+int ds_cmp_u64(const void* a, const void* b, size_t size) {
+   (void) size;
+   return __DS_CMP3(uint64_t, a, b);
+}
+
+int ds_cmp_float(const void* a, const void* b, size_t size) {
+   (void) size;
+   return __DS_FCMP3(float, a, b);
+}
+
+int ds_cmp_double(const void* a, const void* b, size_t size) {
+   (void) size;
+   return __DS_FCMP3(double, a, b);
+}
+
+
+/** Scalar equality **/
+
+int ds_eq_int(const void* a, const void* b, size_t size) {
+   (void) size;
+   return (*(const int*) a == *(const int*) b);
+}
+
+int ds_eq_uint(const void* a, const void* b, size_t size) {
+   (void) size;
+   return (*(const unsigned int*) a == *(const unsigned int*) b);
+}
+
+int ds_eq_i64(const void* a, const void* b, size_t size) {
+   (void) size;
+   return (*(const int64_t*) a == *(const int64_t*) b);
+}
+
+int ds_eq_u64(const void* a, const void* b, size_t size) {
+   (void) size;
+   return (*(const uint64_t*) a == *(const uint64_t*) b);
+}
+
+int ds_eq_float(const void* a, const void* b, size_t size) {
+   (void) size;
+   return (*(const float*) a == *(const float*) b);
+}
+
+int ds_eq_double(const void* a, const void* b, size_t size) {
+   (void) size;
+   return (*(const double*) a == *(const double*) b);
+}
+
+
+/**
+ * Hash a float so that values equal under ds_eq_float(...) hash alike; both
+ * zeros map to the hash of 0.0.
+ *
+ * @param elem - the float to hash.
+ * @param size - ignored.
+ * @return the hash of the element.
+ **/
+unsigned long ds_hash_float(const void* elem, size_t size) {
+   float f;
+
+   (void) size;
+   f = *(const float*) elem;
+
+   if(f == 0.0f) f = 0.0f;
+
+   return ds_hash_mem(&f, sizeof(f));
+}
+
+
+/**
+ * Hash a double so that values equal under ds_eq_double(...) hash alike; both
+ * zeros map to the hash of 0.0.
+ *
+ * @param elem - the double to hash.
+ * @param size - ignored.
+ * @return the hash of the element.
+ **/
+unsigned long ds_hash_double(const void* elem, size_t size) {
+   double d;
+
+   (void) size;
+   d = *(const double*) elem;
+
+   if(d == 0.0) d = 0.0;
+
+   return ds_hash_mem(&d, sizeof(d));
+}
+
+
+/**
+ * Classify a set of callbacks for the containers' search loops. Equality is
+ * decided by eq when present, otherwise by cmp.
+ *
+ * NOTE: This function is internal to the library.
+ *
+ * @param ops - the callbacks to classify, or NULL.
+ * @return one of the DS_K_* kinds in ops.h.
+ **/
+int __ds_kind(const ds_ops_t* const ops) {
+   if(!ops) return DS_K_MEM;
+
+   if(ops->eq) {
+      if(ops->eq == ds_eq_mem) return DS_K_MEM;
+      if(ops->eq == ds_eq_int) return DS_K_INT;
+      if(ops->eq == ds_eq_uint) return DS_K_UINT;
+      if(ops->eq == ds_eq_i64) return DS_K_I64;
+      if(ops->eq == ds_eq_u64) return DS_K_U64;
+      if(ops->eq == ds_eq_float) return DS_K_FLOAT;
+      if(ops->eq == ds_eq_double) return DS_K_DOUBLE;
+
+      return DS_K_CUSTOM;
+   }
+
+   if(ops->cmp) {
+      if(ops->cmp == ds_cmp_mem) return DS_K_MEM;
+      if(ops->cmp == ds_cmp_int) return DS_K_INT;
+      if(ops->cmp == ds_cmp_uint) return DS_K_UINT;
+      if(ops->cmp == ds_cmp_i64) return DS_K_I64;
+      if(ops->cmp == ds_cmp_u64) return DS_K_U64;
+
+      /* Unlike ==, ds_cmp_float(...) treats NaN as equal to NaN */
+      return DS_K_CUSTOM;
+   }
+
+   return DS_K_MEM;
+}
@@ -0,0 +1,72 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_COUNTERS_H__
+#define __LIBDSTRUCTS_COUNTERS_H__    /* Guard against multiple inclusion */
+
+/**
+ * Internal header for the instrumentation counters. Not installed.
+ *
+ * An instrumented container declares __DS_STATS (see stats.h) as its very
+ * first member, which is what lets ds_stats_get(...) read any of them. Without
+ * DSTRUCTS_STATS the member is left out and the counting macros reduce to
+ * (void) (c), which compiles to nothing.
+ **/
+
+#include "stats.h"      /* For ds_stats_t */
+
+#ifdef DSTRUCTS_STATS
+
+#include <string.h>     /* For memset(...) */
+
+/* Zero a container's counters */
+#define __DS_STATS_INIT(c) memset(&(c)->__stats, 0, sizeof(ds_stats_t))
+
+/* Add n to a counter */
+#define __DS_COUNT(c, field, n) \
+   ((c)->__stats.field += (unsigned long) (n))
+
+/* Raise a peak counter to n */
+#define __DS_PEAK(c, field, n) \
+   ((c)->__stats.field < (unsigned long) (n) ? \
+    (void) ((c)->__stats.field = (unsigned long) (n)) : (void) 0)
+
+/* Count a traversal of n steps, each making a comparison if cmp is set */
+#define __DS_WALK(c, n, cmp) \
+   ((c)->__stats.walks++, (c)->__stats.steps += (unsigned long) (n), \
+    (void) ((cmp) ? (c)->__stats.cmps += (unsigned long) (n) : 0))
+
+/* Copy the counters of the container c is built upon */
+#define __DS_STATS_SYNC(c, from) \
+   ((c)->__stats = *(const ds_stats_t*) (from))
+
+/* Count one step, and comparison, of a traversal counted separately */
+#define __DS_WALK_STEP(c) ((c)->__stats.steps++, (void) (c)->__stats.cmps++)
+
+#else
+
+#define __DS_STATS_INIT(c) ((void) (c))
+#define __DS_COUNT(c, field, n) ((void) (c))
+#define __DS_PEAK(c, field, n) ((void) (c))
+#define __DS_WALK(c, n, cmp) ((void) (c))
+#define __DS_WALK_STEP(c) ((void) (c))
+#define __DS_STATS_SYNC(c, from) ((void) (c))
+
+#endif   /* DSTRUCTS_STATS */
+
+#endif   /* __LIBDSTRUCTS_COUNTERS_H__ */
@@ -0,0 +1,309 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), free(...) */
+#include <limits.h>     /* For INT_MAX */
+#include <stdatomic.h>  /* For atomic_size_t, atomic_*(...) */
+#include "cqueue.h"
+
+
+#define ADDED 1
+#define CACHE_LINE 64
+
+
+/**
+ * Internal cell type. Only used in this file.
+ *
+ * A cell's sequence number says whose turn it is: when seq == pos the cell is
+ * free for the producer that claims position pos; when seq == pos + 1 it
+ * holds the element for the consumer that claims position pos. Consumers hand
+ * the cell to the next lap by storing pos + cap.
+ **/
+typedef struct __cell_s {
+   atomic_size_t seq;
+   void *element;
+} __cell_t;
+
+
+/**
+ * Internal concurrent queue definition. The producer and consumer positions
+ * are kept on separate cache lines so that enqueueing threads and dequeueing
+ * threads do not contend on the same line.
+ **/
+struct __cq_s {
+   __cell_t *__cells;
+   size_t __mask;
+   size_t __elem_size;
+   char __pad0[CACHE_LINE];
+   atomic_size_t __enq_pos;
+   char __pad1[CACHE_LINE - sizeof(atomic_size_t)];
+   atomic_size_t __deq_pos;
+   char __pad2[CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+
+/* Local functions */
+static int __cq_claim(cq_t* const q, atomic_size_t* const pos, size_t lap,
+                      int n, size_t* const start);
+
+
+/**
+ * A simulated constructor for a concurrent queue. The capacity is rounded up
+ * to the next power of two, so that cq_cap(...) can report it, cap may be at
+ * most INT_MAX / 2 + 1.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro cq_init(type, cap), where type is the type
+ * that the user wishes to restrict the queue to.
+ *
+ * @param __elem_size - the size of an element in the queue.
+ * @param cap - the minimum number of elements the queue can hold.
+ * @return a pointer to an empty queue. Returns a NULL pointer if cap is zero
+ *    (0), greater than INT_MAX / 2 + 1, or upon allocation error.
+ **/
+cq_t* __cq_init(size_t __elem_size, size_t cap) {
+   cq_t *queue;
+   size_t i, size;
+
+   if(!cap || cap > (size_t) INT_MAX / 2 + 1) return NULL;
+
+   for(size = 2; size < cap; size <<= 1)
+      ;
+
+   if(size > (size_t) -1 / sizeof(__cell_t)) return NULL;
+
+   queue = malloc(sizeof(cq_t));
+
+   if(!queue) return NULL;
+
+   queue->__cells = malloc(sizeof(__cell_t) * size);
+
+   if(!queue->__cells) {
+      free(queue);
+      return NULL;
+   }
+
+   for(i = 0; i < size; i++) {
+      atomic_init(&queue->__cells[i].seq, i);
+      queue->__cells[i].element = NULL;
+   }
+
+   queue->__mask = size - 1;
+   queue->__elem_size = __elem_size;
+   atomic_init(&queue->__enq_pos, 0);
+   atomic_init(&queue->__deq_pos, 0);
+
+   return queue;
+}
+
+
+/**
+ * A simulated destructor for a concurrent queue. Frees any elements remaining
+ * in the queue. Must not be called while other threads use the queue.
+ *
+ * @param q - the queue to destroy.
+ **/
+void cq_free(cq_t* const q) {
+   if(!q) return;
+
+   while(cq_size(q) > 0)
+      free(cq_trydeq(q));
+
+   free(q->__cells);
+   free(q);
+}
+
+
+/**
+ * Retrieve the size of a concurrent queue. While other threads are enqueueing
+ * or dequeueing, the result is only a snapshot.
+ *
+ * @param q - the queue to retrieve the size of.
+ * @return the number of elements in the queue. Returns -1 if the queue is
+ *    NULL.
+ **/
+int cq_size(cq_t* const q) {
+   size_t enq, deq;
+
+   if(!q) return -1;
+
+   deq = atomic_load_explicit(&q->__deq_pos, memory_order_acquire);
+   enq = atomic_load_explicit(&q->__enq_pos, memory_order_acquire);
+
+   /* A dequeue may have raced ahead of our read of the enqueue position */
+   return (enq > deq ? (int) (enq - deq) : 0);
+}
+
+
+/**
+ * Retrieve the capacity of a concurrent queue.
+ *
+ * @param q - the queue to retrieve the capacity of.
+ * @return the maximum number of elements the queue can hold. Returns -1 if
+ *    the queue is NULL.
+ **/
+int cq_cap(cq_t* const q) {
+   return (q ? (int) (q->__mask + 1) : -1);
+}
+
+
+/**
+ * Claim up to n consecutive positions for the calling thread. A position is
+ * claimable once its cell's sequence number equals pos + lap (lap is zero (0)
+ * for producers and one (1) for consumers). Claiming several positions costs
+ * a single compare-and-swap.
+ *
+ * @param q - the queue to claim positions in.
+ * @param pos - the producer or consumer position counter.
+ * @param lap - the sequence offset that marks a cell as ready.
+ * @param n - the maximum number of positions to claim.
+ * @param start - set to the first claimed position.
+ * @return the number of positions claimed. Returns 0 if the queue is full
+ *    (producers) or empty (consumers).
+ **/
+static int __cq_claim(cq_t* const q, atomic_size_t* const pos, size_t lap,
+                      int n, size_t* const start) {
+   size_t first, seq;
+   int ready;
+
+   first = atomic_load_explicit(pos, memory_order_relaxed);
+
+   for(;;) {
+      /* Count how many cells from first onward are ready for us */
+      for(ready = 0; ready < n; ready++) {
+         seq = atomic_load_explicit(&q->__cells[(first + ready) & q->__mask].seq,
+                                    memory_order_acquire);
+
+         if(seq != first + ready + lap) break;
+      }
+
+      if(!ready) {
+         seq = atomic_load_explicit(&q->__cells[first & q->__mask].seq,
+                                    memory_order_acquire);
+
+         /* Cell still belongs to the previous lap; queue is full or empty */
+         if((long) (seq - (first + lap)) < 0)
+            return 0;
+
+         /* Another thread claimed first; retry from the new position */
+         first = atomic_load_explicit(pos, memory_order_relaxed);
+         continue;
+      }
+
+      if(atomic_compare_exchange_weak_explicit(pos, &first, first + ready,
+                                               memory_order_relaxed,
+                                               memory_order_relaxed)) {
+         *start = first;
+         return ready;
+      }
+   }
+}
+
+
+/**
+ * Attempt to add a specified element to the end of the queue without
+ * blocking.
+ *
+ * @param q - the queue to add the specified element to.
+ * @param elem - the element to add to the queue.
+ * @return 1 if the element was added. Returns 0 if either parameter is NULL
+ *    or if the queue is full.
+ **/
+int cq_tryenq(cq_t* const q, void* const elem) {
+   if(!q || !elem) return !ADDED;
+
+   return cq_enq_batch(q, (void**) &elem, 1);
+}
+
+
+/**
+ * Attempt to remove and return the head of the queue without blocking.
+ *
+ * @param q - the queue to retrieve the element from.
+ * @return the head of the queue. Returns NULL if the queue is empty or NULL.
+ **/
+void* cq_trydeq(cq_t* const q) {
+   void *elem;
+
+   if(!q) return NULL;
+
+   return (cq_deq_batch(q, &elem, 1) ? elem : NULL);
+}
+
+
+/**
+ * Attempt to add up to n elements to the end of the queue without blocking.
+ * The elements that are added keep their relative order and are contiguous
+ * in the queue.
+ *
+ * @param q - the queue to add the specified elements to.
+ * @param elems - the elements to add to the queue. None may be NULL.
+ * @param n - the number of elements in elems.
+ * @return the number of elements added, starting from elems[0]. Returns 0 if
+ *    the queue is full or NULL.
+ **/
+int cq_enq_batch(cq_t* const q, void** const elems, int n) {
+   __cell_t *cell;
+   size_t start;
+   int i, count;
+
+   if(!q || !elems || n <= 0) return 0;
+
+   count = __cq_claim(q, &q->__enq_pos, 0, n, &start);
+
+   /* Fill each claimed cell, then publish it to consumers */
+   for(i = 0; i < count; i++) {
+      cell = &q->__cells[(start + i) & q->__mask];
+      cell->element = elems[i];
+      atomic_store_explicit(&cell->seq, start + i + 1, memory_order_release);
+   }
+
+   return count;
+}
+
+
+/**
+ * Attempt to remove up to n elements from the head of the queue without
+ * blocking.
+ *
+ * @param q - the queue to remove elements from.
+ * @param elems - receives the removed elements, head first. Must have room
+ *    for n elements.
+ * @param n - the maximum number of elements to remove.
+ * @return the number of elements removed. Returns 0 if the queue is empty or
+ *    NULL.
+ **/
+int cq_deq_batch(cq_t* const q, void** const elems, int n) {
+   __cell_t *cell;
+   size_t start;
+   int i, count;
+
+   if(!q || !elems || n <= 0) return 0;
+
+   count = __cq_claim(q, &q->__deq_pos, 1, n, &start);
+
+   /* Empty each claimed cell, then hand it to the next lap's producer */
+   for(i = 0; i < count; i++) {
+      cell = &q->__cells[(start + i) & q->__mask];
+      elems[i] = cell->element;
+      atomic_store_explicit(&cell->seq, start + i + q->__mask + 1,
+                            memory_order_release);
+   }
+
+   return count;
+}
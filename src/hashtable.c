@@ -0,0 +1,545 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), calloc(...), free(...) */
+#include <limits.h>     /* For INT_MAX */
+#include <string.h>     /* For memcpy(...) */
+#include "hashtable.h"
+
+
+#define INIT_SIZE 16
+#define ADDED 1
+#define EXIST 1
+
+/* Maximum load factor, as a fraction of LOAD_DEN */
+#define LOAD_NUM 7
+#define LOAD_DEN 8
+
+
+/**
+ * Internal hashtable definition. Open addressing with linear probing and
+ * Robin Hood displacement: an entry being inserted takes the slot of any
+ * entry that is closer to its home slot, which keeps probe lengths short and
+ * lets lookups stop early. Removal shifts the following entries back, so the
+ * table never needs tombstones.
+ *
+ * Keys are stored back to back in __keys, with one extra slot at the end used
+ * as scratch space during insertion. A stored hash of zero (0) marks an empty
+ * slot; hashes are forced nonzero before they are stored.
+ **/
+struct __ht_s {
+   unsigned long *__hashes;
+   char *__keys;
+   void **__vals;
+   ds_hash_t __hash;
+   ds_eq_t __eq;
+   size_t __key_size;
+   size_t __mask;
+   int __size;
+   int __cap;
+};
+
+
+/* Address of the key in the slot at the specified index */
+#define __HT_KEY(ht, i) ((ht)->__keys + (size_t) (i) * (ht)->__key_size)
+
+/* Distance of the entry in slot i from its home slot */
+#define __HT_DIST(ht, i) (((i) - (ht)->__hashes[i]) & (ht)->__mask)
+
+
+/* Local functions */
+static unsigned long __ht_hash(ht_t* const ht, void* const key);
+static int __ht_find(ht_t* const ht, void* const key, unsigned long h);
+static void __ht_place(ht_t* const ht, unsigned long h, void* const val);
+static int __ht_resize(ht_t* const ht, int cap);
+static int __ht_fit(int n);
+static void __ht_swap(char* a, char* b, size_t n);
+
+
+/**
+ * A simulated constructor for a hashtable.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro ht_init(type) or ht_init_fn(type, hash, eq),
+ * where type is the type of the keys in the hashtable.
+ *
+ * @param __key_size - the size of a key in the hashtable.
+ * @param hash - the function used to hash keys. Uses ds_hash_mem(...) if
+ *    NULL.
+ * @param eq - the function used to compare keys. Uses ds_eq_mem(...) if NULL.
+ * @return a pointer to an empty hashtable. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+ht_t* __ht_init(size_t __key_size, ds_hash_t hash, ds_eq_t eq) {
+   ht_t *table;
+
+   table = malloc(sizeof(ht_t));
+
+   if(!table) return NULL;
+
+   table->__hashes = NULL;
+   table->__keys = NULL;
+   table->__vals = NULL;
+   table->__hash = (hash ? hash : ds_hash_mem);
+   table->__eq = (eq ? eq : ds_eq_mem);
+   table->__key_size = __key_size;
+   table->__size = 0;
+
+   if(!__ht_resize(table, INIT_SIZE)) {
+      free(table);
+      return NULL;
+   }
+
+   return table;
+}
+
+
+/**
+ * A simulated destructor for a hashtable. Frees the values remaining in the
+ * table.
+ *
+ * @param ht - the hashtable to destroy.
+ **/
+void ht_free(ht_t* const ht) {
+   if(!ht) return;
+
+   ht_clear(ht);
+   free(ht->__hashes);
+   free(ht->__keys);
+   free(ht->__vals);
+   free(ht);
+}
+
+
+/**
+ * Retrieve the size of a hashtable.
+ *
+ * @param ht - the hashtable to retrieve the size of.
+ * @return the number of entries in the hashtable. Returns -1 if the hashtable
+ *    is NULL.
+ **/
+int ht_size(ht_t* const ht) {
+   return (ht ? ht->__size : -1);
+}
+
+
+/**
+ * Retrieve the capacity of a hashtable. That is, the number of slots in the
+ * table; the table grows before it is more than 7/8 full.
+ *
+ * @param ht - the hashtable to retrieve the capacity of.
+ * @return the number of slots in the hashtable. Returns -1 if the hashtable
+ *    is NULL.
+ **/
+int ht_cap(ht_t* const ht) {
+   return (ht ? ht->__cap : -1);
+}
+
+
+/**
+ * Ensure a hashtable can hold at least the specified number of entries
+ * without rehashing.
+ *
+ * @param ht - the hashtable to reserve space in.
+ * @param n - the number of entries to make room for.
+ * @return 1 if the hashtable can hold n entries. Returns 0 if the hashtable is
+ *    NULL, n is negative, the capacity n needs exceeds the largest power of
+ *    two an int holds, or upon allocation error.
+ **/
+int ht_reserve(ht_t* const ht, int n) {
+   int cap;
+
+   if(!ht || n < 0) return !ADDED;
+
+   cap = __ht_fit(n);
+
+   if(!cap) return !ADDED;
+
+   if(cap <= ht->__cap) return ADDED;
+
+   return __ht_resize(ht, cap);
+}
+
+
+/**
+ * Rebuild a hashtable at the smallest capacity that holds its entries. Use
+ * after removing many entries to give memory back and shorten probes.
+ *
+ * @param ht - the hashtable to rehash.
+ * @return 1 if the hashtable was rehashed. Returns 0 if the hashtable is NULL
+ *    or upon allocation error, in which case the table is left unchanged.
+ **/
+int ht_rehash(ht_t* const ht) {
+   if(!ht) return !ADDED;
+
+   return __ht_resize(ht, __ht_fit(ht->__size));
+}
+
+
+/**
+ * Add a key and its value to a hashtable. If the key already exists in the
+ * table, nothing is added.
+ *
+ * @param ht - the hashtable to add the entry to.
+ * @param key - the key of the entry; it is copied into the table.
+ * @param val - the value of the entry.
+ * @return 1 if the entry was added. Returns 0 if the hashtable or key is NULL,
+ *    if the key already exists, or upon allocation error.
+ **/
+int ht_add(ht_t* const ht, void* const key, void* const val) {
+   unsigned long h;
+
+   if(!ht || !key) return !ADDED;
+
+   h = __ht_hash(ht, key);
+
+   if(__ht_find(ht, key, h) >= 0) return !ADDED;
+
+   /* Grow before the table becomes too full */
+   if(ht->__size >= ht->__cap / LOAD_DEN * LOAD_NUM)
+      if(ht->__cap > INT_MAX / 2 || !__ht_resize(ht, ht->__cap << 1))
+         return !ADDED;
+
+   memcpy(__HT_KEY(ht, ht->__cap), key, ht->__key_size);
+   __ht_place(ht, h, val);
+
+   return ADDED;
+}
+
+
+/**
+ * Associate a value with a key in a hashtable, adding the key if it does not
+ * already exist.
+ *
+ * @param ht - the hashtable to store the entry in.
+ * @param key - the key of the entry; it is copied into the table.
+ * @param val - the value to store.
+ * @return the value previously associated with the key. Returns NULL if the
+ *    key was newly added or upon error.
+ **/
+void* ht_put(ht_t* const ht, void* const key, void* const val) {
+   void *former;
+   int slot;
+
+   if(!ht || !key) return NULL;
+
+   slot = __ht_find(ht, key, __ht_hash(ht, key));
+
+   if(slot < 0) {
+      ht_add(ht, key, val);
+      return NULL;
+   }
+
+   former = ht->__vals[slot];
+   ht->__vals[slot] = val;
+
+   return former;
+}
+
+
+/**
+ * Removes all entries in a hashtable, applying free(...) to each value.
+ *
+ * @param ht - the hashtable to clear.
+ **/
+void ht_clear(ht_t* const ht) {
+   int i;
+
+   if(!ht) return;
+
+   for(i = 0; i < ht->__cap; i++) {
+      if(ht->__hashes[i]) {
+         free(ht->__vals[i]);
+         ht->__hashes[i] = 0;
+      }
+   }
+
+   ht->__size = 0;
+}
+
+
+/**
+ * Determines if the specified key exists in a hashtable.
+ *
+ * @param ht - the hashtable possibly containing the key.
+ * @param key - the key to search for.
+ * @return 1 if the key exists in the hashtable. Returns 0 otherwise or if
+ *    either parameter is NULL.
+ **/
+int ht_contains(ht_t* const ht, void* const key) {
+   if(!ht || !key) return !EXIST;
+
+   return (__ht_find(ht, key, __ht_hash(ht, key)) >= 0 ? EXIST : !EXIST);
+}
+
+
+/**
+ * Retrieves (but does not remove) the value associated with a key.
+ *
+ * @param ht - the hashtable to retrieve the value from.
+ * @param key - the key to search for.
+ * @return the value associated with the key. Returns NULL if the key does not
+ *    exist or if either parameter is NULL.
+ **/
+void* ht_get(ht_t* const ht, void* const key) {
+   int slot;
+
+   if(!ht || !key) return NULL;
+
+   slot = __ht_find(ht, key, __ht_hash(ht, key));
+
+   return (slot >= 0 ? ht->__vals[slot] : NULL);
+}
+
+
+/**
+ * Removes a key from a hashtable and returns its value.
+ *
+ * @param ht - the hashtable to remove the key from.
+ * @param key - the key to remove.
+ * @return the value that was associated with the key. Returns NULL if the key
+ *    does not exist or if either parameter is NULL.
+ **/
+void* ht_rem(ht_t* const ht, void* const key) {
+   void *target;
+   size_t next;
+   int slot;
+
+   if(!ht || !key) return NULL;
+
+   slot = __ht_find(ht, key, __ht_hash(ht, key));
+
+   if(slot < 0) return NULL;
+
+   target = ht->__vals[slot];
+
+   /* Shift back following entries until one is empty or at its home slot */
+   next = (slot + 1) & ht->__mask;
+
+   while(ht->__hashes[next] && __HT_DIST(ht, next)) {
+      ht->__hashes[slot] = ht->__hashes[next];
+      ht->__vals[slot] = ht->__vals[next];
+      memcpy(__HT_KEY(ht, slot), __HT_KEY(ht, next), ht->__key_size);
+
+      slot = next;
+      next = (next + 1) & ht->__mask;
+   }
+
+   ht->__hashes[slot] = 0;
+   ht->__size--;
+
+   return target;
+}
+
+
+/**
+ * Apply a function over all the values in a hashtable. Values are visited in
+ * no particular order.
+ *
+ * @param ht - the hashtable to apply an operation over.
+ * @param funct - the function to apply, where the argument to the function is
+ *    a value in the hashtable.
+ **/
+void ht_apply(ht_t* const ht, void (*funct)(void* const)) {
+   int i;
+
+   if(!ht) return;
+
+   for(i = 0; i < ht->__cap; i++)
+      if(ht->__hashes[i])
+         (funct)(ht->__vals[i]);
+}
+
+
+/**
+ * Hash a key with the table's hash function, forcing the result nonzero.
+ *
+ * @param ht - the hashtable the key belongs to.
+ * @param key - the key to hash.
+ * @return the nonzero hash of the key.
+ **/
+static unsigned long __ht_hash(ht_t* const ht, void* const key) {
+   unsigned long h;
+
+   h = (ht->__hash)(key, ht->__key_size);
+
+   return (h ? h : 1);
+}
+
+
+/**
+ * Find the slot holding a key.
+ *
+ * @param ht - the hashtable to search.
+ * @param key - the key to search for.
+ * @param h - the hash of the key.
+ * @return the index of the slot holding the key, or -1 if it does not exist.
+ **/
+static int __ht_find(ht_t* const ht, void* const key, unsigned long h) {
+   size_t pos, dist;
+
+   pos = h & ht->__mask;
+
+   for(dist = 0; ht->__hashes[pos]; dist++) {
+      /* Any entry of ours would have displaced this one */
+      if(__HT_DIST(ht, pos) < dist)
+         return -1;
+
+      if(ht->__hashes[pos] == h &&
+            (ht->__eq)(key, __HT_KEY(ht, pos), ht->__key_size))
+         return (int) pos;
+
+      pos = (pos + 1) & ht->__mask;
+   }
+
+   return -1;
+}
+
+
+/**
+ * Insert an entry known not to be in the table. The key must already be in
+ * the scratch slot, and the table must have room.
+ *
+ * @param ht - the hashtable to insert into.
+ * @param h - the hash of the key.
+ * @param val - the value of the entry.
+ **/
+static void __ht_place(ht_t* const ht, unsigned long h, void* const val) {
+   unsigned long htemp;
+   void *vtemp, *v;
+   char *key;
+   size_t pos, dist;
+
+   key = __HT_KEY(ht, ht->__cap);
+   v = val;
+   pos = h & ht->__mask;
+
+   for(dist = 0; ht->__hashes[pos]; dist++) {
+      /* Take the slot of an entry closer to home; carry it onward */
+      if(__HT_DIST(ht, pos) < dist) {
+         dist = __HT_DIST(ht, pos);
+
+         htemp = ht->__hashes[pos];
+         ht->__hashes[pos] = h;
+         h = htemp;
+
+         vtemp = ht->__vals[pos];
+         ht->__vals[pos] = v;
+         v = vtemp;
+
+         __ht_swap(key, __HT_KEY(ht, pos), ht->__key_size);
+      }
+
+      pos = (pos + 1) & ht->__mask;
+   }
+
+   ht->__hashes[pos] = h;
+   ht->__vals[pos] = v;
+   memcpy(__HT_KEY(ht, pos), key, ht->__key_size);
+
+   ht->__size++;
+}
+
+
+/**
+ * Move every entry into a new table with the specified capacity.
+ *
+ * @param ht - the hashtable to resize.
+ * @param cap - the new capacity, a power of two large enough for the entries.
+ * @return 1 if the table was resized. Returns 0 upon allocation error, in
+ *    which case the table is left unchanged.
+ **/
+static int __ht_resize(ht_t* const ht, int cap) {
+   unsigned long *hashes;
+   char *keys;
+   void **vals;
+   int i, old_cap;
+
+   hashes = calloc(cap, sizeof(unsigned long));
+   keys = malloc((size_t) (cap + 1) * ht->__key_size);
+   vals = malloc(sizeof(void*) * cap);
+
+   if(!hashes || !keys || !vals) {
+      free(hashes);
+      free(keys);
+      free(vals);
+      return !ADDED;
+   }
+
+   /* Swap in the new arrays, keeping the old ones to move entries from */
+   old_cap = (ht->__hashes ? ht->__cap : 0);
+   __ht_swap((char*) &hashes, (char*) &ht->__hashes, sizeof(hashes));
+   __ht_swap((char*) &keys, (char*) &ht->__keys, sizeof(keys));
+   __ht_swap((char*) &vals, (char*) &ht->__vals, sizeof(vals));
+
+   ht->__cap = cap;
+   ht->__mask = cap - 1;
+   ht->__size = 0;
+
+   for(i = 0; i < old_cap; i++) {
+      if(hashes[i]) {
+         memcpy(__HT_KEY(ht, cap), keys + (size_t) i * ht->__key_size,
+                ht->__key_size);
+         __ht_place(ht, hashes[i], vals[i]);
+      }
+   }
+
+   free(hashes);
+   free(keys);
+   free(vals);
+
+   return ADDED;
+}
+
+
+/**
+ * Find the smallest capacity that holds the specified number of entries.
+ *
+ * Capacities are multiples of LOAD_DEN, so the comparison is exact and
+ * cannot overflow.
+ *
+ * @param n - the number of entries.
+ * @return a power of two capacity, at least INIT_SIZE. Returns 0 if no
+ *    capacity an int can hold is large enough.
+ **/
+static int __ht_fit(int n) {
+   int cap;
+
+   for(cap = INIT_SIZE; n > cap / LOAD_DEN * LOAD_NUM; cap <<= 1)
+      if(cap > INT_MAX / 2) return 0;
+
+   return cap;
+}
+
+
+/**
+ * Swap the contents of two buffers of the same size.
+ *
+ * @param a - the first buffer.
+ * @param b - the second buffer.
+ * @param n - the size of the buffers in bytes.
+ **/
+static void __ht_swap(char* a, char* b, size_t n) {
+   char temp;
+
+   while(n--) {
+      temp = a[n];
+      a[n] = b[n];
+      b[n] = temp;
+   }
+}
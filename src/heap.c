@@ -0,0 +1,531 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), realloc(...), free(...) */
+#include <string.h>     /* For memmove(...) */
+#include <limits.h>     /* For INT_MAX */
+#include "heap.h"
+#include "layout.h"     /* For struct __vect_s */
+
+
+#define INIT_SIZE 16
+#define ADDED 1
+
+
+/**
+ * Internal heap definition.
+ *
+ * __heap holds handles in heap order; the children of position i are at
+ * positions (d * i + 1) through (d * i + d). __pos maps a handle back to its
+ * position (or -1 for an unused handle) and __elems maps a handle to its
+ * element, so moving an element only moves an int. Handles below __slots
+ * that are not in use are parked in __heap past the end of the heap, at
+ * positions __size through (__slots - 1), and are reused first.
+ **/
+struct __heap_s {
+   int *__heap;
+   int *__pos;
+   void **__elems;
+   ds_cmp_t __cmp;
+   size_t __elem_size;
+   int __arity;
+   int __size;
+   int __slots;
+   int __cap;
+};
+
+
+/* Whether the element with handle a orders before the one with handle b */
+#define __HP_LESS(h, a, b) \
+   ((h)->__cmp((h)->__elems[a], (h)->__elems[b], (h)->__elem_size) < 0)
+
+
+/* Local functions */
+static int __hp_grow(heap_t* const heap, int n);
+static void __hp_up(heap_t* const heap, int pos);
+static void __hp_down(heap_t* const heap, int pos);
+static void* __hp_take(heap_t* const heap, int pos);
+
+
+/**
+ * A simulated constructor for a heap.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro hp_init(type, cmp) or
+ * hp_init_arity(type, cmp, d).
+ *
+ * @param __elem_size - the size of an element in the heap.
+ * @param cmp - the function used to order elements. Uses ds_cmp_mem(...) if
+ *    NULL.
+ * @param arity - the number of children per node. Must be at least two (2).
+ * @return a pointer to an empty heap. Returns a NULL pointer if the arity is
+ *    less than two (2) or upon allocation error.
+ **/
+heap_t* __hp_init(size_t __elem_size, ds_cmp_t cmp, int arity) {
+   heap_t *heap;
+
+   if(arity < 2) return NULL;
+
+   heap = malloc(sizeof(heap_t));
+
+   if(!heap) return NULL;
+
+   heap->__heap = NULL;
+   heap->__pos = NULL;
+   heap->__elems = NULL;
+   heap->__cmp = (cmp ? cmp : ds_cmp_mem);
+   heap->__elem_size = __elem_size;
+   heap->__arity = arity;
+   heap->__size = 0;
+   heap->__slots = 0;
+   heap->__cap = 0;
+
+   if(!__hp_grow(heap, INIT_SIZE)) {
+      hp_free(heap);
+      return NULL;
+   }
+
+   return heap;
+}
+
+
+/**
+ * A simulated destructor for a heap. Frees the elements remaining in the
+ * heap.
+ *
+ * @param heap - the heap to destroy.
+ **/
+void hp_free(heap_t* const heap) {
+   int i;
+
+   if(!heap) return;
+
+   for(i = 0; i < heap->__size; i++)
+      free(heap->__elems[heap->__heap[i]]);
+
+   free(heap->__heap);
+   free(heap->__pos);
+   free(heap->__elems);
+   free(heap);
+}
+
+
+/**
+ * Retrieve the size of a heap.
+ *
+ * @param heap - the heap to retrieve the size of.
+ * @return the number of elements in the heap. Returns -1 if the heap is NULL.
+ **/
+int hp_size(heap_t* const heap) {
+   return (heap ? heap->__size : -1);
+}
+
+
+/**
+ * Ensure a heap can hold at least the specified number of elements without
+ * reallocating.
+ *
+ * @param heap - the heap to reserve space in.
+ * @param n - the minimum number of elements the heap can hold.
+ * @return 1 if the heap can hold n elements. Returns 0 if the heap is NULL,
+ *    n is negative, or upon allocation error.
+ **/
+int hp_reserve(heap_t* const heap, int n) {
+   if(!heap || n < 0) return !ADDED;
+
+   return (n <= heap->__cap ? ADDED : __hp_grow(heap, n));
+}
+
+
+/**
+ * Add an element to a heap.
+ *
+ * @param heap - the heap to add the element to.
+ * @param elem - the element to add.
+ * @return the handle of the element. Returns -1 if either parameter is NULL
+ *    or upon allocation error.
+ **/
+int hp_push(heap_t* const heap, void* const elem) {
+   int hdl, pos, cap;
+
+   if(!heap || !elem) return -1;
+
+   /* Double the capacity, saturating at INT_MAX */
+   if(heap->__size == heap->__cap) {
+      cap = (heap->__cap > INT_MAX / 2 ? INT_MAX : heap->__cap * 2);
+
+      if(cap == heap->__cap || !__hp_grow(heap, cap)) return -1;
+   }
+
+   pos = heap->__size++;
+
+   /* Reuse a parked handle if there is one */
+   if(pos < heap->__slots)
+      hdl = heap->__heap[pos];
+   else
+      hdl = heap->__slots++;
+
+   heap->__heap[pos] = hdl;
+   heap->__pos[hdl] = pos;
+   heap->__elems[hdl] = elem;
+
+   __hp_up(heap, pos);
+
+   return hdl;
+}
+
+
+/**
+ * Add every element of a vector to a heap at once, then restore heap order
+ * bottom-up. This is O(n + m) for a heap of n elements and a vector of m,
+ * compared to O(m log(n + m)) for m calls to hp_push(...). Ownership of the
+ * elements moves to the heap: the vector is left empty, without its elements
+ * being freed, so freeing both the vector and the heap frees each element
+ * once. Inline vectors own their elements' storage and cannot hand it over,
+ * so they are rejected.
+ *
+ * The elements receive consecutive handles in the vector's order, starting at
+ * the handle returned.
+ *
+ * @param heap - the heap to add to.
+ * @param v - a (non-inline) vector of pointers to elements.
+ * @return the handle of the vector's first element, or the next handle to
+ *    be assigned if the vector is empty. Returns -1 if either parameter is
+ *    NULL, the vector is inline, the heap would need more than INT_MAX
+ *    handles, or upon allocation error, in which case the heap and the
+ *    vector are unchanged.
+ **/
+int hp_heapify(heap_t* const heap, vect_t* const v) {
+   int i, n, base, pos, parked;
+
+   if(!heap || !v || v->__inl) return -1;
+
+   if(v_size(v) > INT_MAX - heap->__slots) return -1;
+
+   n = (int) v_size(v);
+
+   /* Nothing to add, and the heap is already in order */
+   if(!n) return heap->__slots;
+
+   if(heap->__slots + n > heap->__cap)
+      if(!__hp_grow(heap, heap->__slots + n))
+         return -1;
+
+   /* Move the parked handles out of the way of the new positions */
+   parked = heap->__slots - heap->__size;
+
+   memmove(heap->__heap + heap->__size + n, heap->__heap + heap->__size,
+           sizeof(int) * parked);
+
+   base = heap->__slots;
+
+   for(i = 0; i < n; i++) {
+      pos = heap->__size + i;
+
+      heap->__heap[pos] = base + i;
+      heap->__pos[base + i] = pos;
+   }
+
+   /* Move the element pointers over, emptying the vector without freeing */
+   v_rem_range(v, 0, n, heap->__elems + base);
+
+   heap->__size += n;
+   heap->__slots += n;
+
+   /* Sift down every parent, last first */
+   for(pos = (heap->__size - 2) / heap->__arity; pos >= 0; pos--)
+      __hp_down(heap, pos);
+
+   return base;
+}
+
+
+/**
+ * Retrieves (but does not remove) the first element of a heap.
+ *
+ * @param heap - the heap to retrieve the element from.
+ * @return the element that orders first. Returns NULL if the heap is empty or
+ *    NULL.
+ **/
+void* hp_top(heap_t* const heap) {
+   if(!heap || !heap->__size) return NULL;
+
+   return heap->__elems[heap->__heap[0]];
+}
+
+
+/**
+ * Retrieves the handle of the first element of a heap.
+ *
+ * @param heap - the heap to retrieve the handle from.
+ * @return the handle of the element that orders first. Returns -1 if the heap
+ *    is empty or NULL.
+ **/
+int hp_top_hdl(heap_t* const heap) {
+   if(!heap || !heap->__size) return -1;
+
+   return heap->__heap[0];
+}
+
+
+/**
+ * Retrieves (but does not remove) the element with the specified handle.
+ *
+ * @param heap - the heap to retrieve the element from.
+ * @param hdl - the handle of the element.
+ * @return the element with the specified handle. Returns NULL if the heap is
+ *    NULL or the handle is not in use.
+ **/
+void* hp_get(heap_t* const heap, int hdl) {
+   if(!heap || hdl < 0 || hdl >= heap->__slots) return NULL;
+
+   if(heap->__pos[hdl] < 0) return NULL;
+
+   return heap->__elems[hdl];
+}
+
+
+/**
+ * Removes and returns the first element of a heap.
+ *
+ * @param heap - the heap to retrieve the element from.
+ * @return the element that ordered first. Returns NULL if the heap is empty
+ *    or NULL.
+ **/
+void* hp_pop(heap_t* const heap) {
+   if(!heap || !heap->__size) return NULL;
+
+   return __hp_take(heap, 0);
+}
+
+
+/**
+ * Removes and returns the element with the specified handle.
+ *
+ * @param heap - the heap to remove the element from.
+ * @param hdl - the handle of the element.
+ * @return the removed element. Returns NULL if the heap is NULL or the handle
+ *    is not in use.
+ **/
+void* hp_rem(heap_t* const heap, int hdl) {
+   if(!hp_get(heap, hdl)) return NULL;
+
+   return __hp_take(heap, heap->__pos[hdl]);
+}
+
+
+/**
+ * Replaces the element with the specified handle by one that orders no later
+ * than it (decrease-key), then restores heap order in O(log n).
+ *
+ * @param heap - the heap containing the element.
+ * @param hdl - the handle of the element.
+ * @param elem - the replacement element.
+ * @return the element previously stored under the handle. Returns NULL if a
+ *    parameter is NULL or the handle is not in use.
+ **/
+void* hp_decrease(heap_t* const heap, int hdl, void* const elem) {
+   void *former;
+
+   if(!elem || !hp_get(heap, hdl)) return NULL;
+
+   former = heap->__elems[hdl];
+   heap->__elems[hdl] = elem;
+
+   __hp_up(heap, heap->__pos[hdl]);
+
+   return former;
+}
+
+
+/**
+ * Restores heap order after the element with the specified handle has been
+ * modified in place, whether its priority went up or down.
+ *
+ * @param heap - the heap containing the element.
+ * @param hdl - the handle of the element.
+ * @return 1 if the handle is in use. Returns 0 otherwise or if the heap is
+ *    NULL.
+ **/
+int hp_update(heap_t* const heap, int hdl) {
+   if(!hp_get(heap, hdl)) return !ADDED;
+
+   __hp_up(heap, heap->__pos[hdl]);
+   __hp_down(heap, heap->__pos[hdl]);
+
+   return ADDED;
+}
+
+
+/**
+ * Creates and returns a pointer to an array representation of a heap, which
+ * free(...) may be called on. The elements are in heap order, not sorted; the
+ * first element orders first.
+ *
+ * @param heap - the heap to translate to an array.
+ * @return a pointer to an array representation of the heap. Returns NULL if
+ *    the heap is NULL.
+ **/
+void** hp_toarr(heap_t* const heap) {
+   void **array;
+   int i;
+
+   if(!heap) return NULL;
+
+   array = malloc(sizeof(void*) * heap->__size);
+
+   if(!array) return NULL;
+
+   for(i = 0; i < heap->__size; i++)
+      array[i] = heap->__elems[heap->__heap[i]];
+
+   return array;
+}
+
+
+/**
+ * Grow the heap's arrays to hold at least the specified number of handles.
+ *
+ * @param heap - the heap to grow.
+ * @param n - the new capacity.
+ * @return 1 if the arrays were grown. Returns 0 upon allocation error, in
+ *    which case the heap is left unchanged.
+ **/
+static int __hp_grow(heap_t* const heap, int n) {
+   int *ints;
+   void **elems;
+
+   if((size_t) n > (size_t) -1 / sizeof(void*)) return !ADDED;
+
+   ints = realloc(heap->__heap, sizeof(int) * n);
+
+   if(!ints) return !ADDED;
+
+   heap->__heap = ints;
+
+   ints = realloc(heap->__pos, sizeof(int) * n);
+
+   if(!ints) return !ADDED;
+
+   heap->__pos = ints;
+
+   elems = realloc(heap->__elems, sizeof(void*) * n);
+
+   if(!elems) return !ADDED;
+
+   heap->__elems = elems;
+   heap->__cap = n;
+
+   return ADDED;
+}
+
+
+/**
+ * Move the handle at a position up until its parent orders before it.
+ *
+ * @param heap - the heap to restore.
+ * @param pos - the position to sift up from.
+ **/
+static void __hp_up(heap_t* const heap, int pos) {
+   int hdl, parent;
+
+   hdl = heap->__heap[pos];
+
+   while(pos > 0) {
+      parent = (pos - 1) / heap->__arity;
+
+      if(!__HP_LESS(heap, hdl, heap->__heap[parent]))
+         break;
+
+      /* Pull the parent down into the hole */
+      heap->__heap[pos] = heap->__heap[parent];
+      heap->__pos[heap->__heap[pos]] = pos;
+      pos = parent;
+   }
+
+   heap->__heap[pos] = hdl;
+   heap->__pos[hdl] = pos;
+}
+
+
+/**
+ * Move the handle at a position down until no child orders before it.
+ *
+ * @param heap - the heap to restore.
+ * @param pos - the position to sift down from.
+ **/
+static void __hp_down(heap_t* const heap, int pos) {
+   int hdl, child, best, last, end;
+
+   hdl = heap->__heap[pos];
+
+   for(;;) {
+      child = heap->__arity * pos + 1;
+
+      if(child >= heap->__size) break;
+
+      /* Find the child that orders first */
+      end = child + heap->__arity;
+      last = (end < heap->__size ? end : heap->__size);
+
+      for(best = child++; child < last; child++)
+         if(__HP_LESS(heap, heap->__heap[child], heap->__heap[best]))
+            best = child;
+
+      if(!__HP_LESS(heap, heap->__heap[best], hdl))
+         break;
+
+      /* Pull the child up into the hole */
+      heap->__heap[pos] = heap->__heap[best];
+      heap->__pos[heap->__heap[pos]] = pos;
+      pos = best;
+   }
+
+   heap->__heap[pos] = hdl;
+   heap->__pos[hdl] = pos;
+}
+
+
+/**
+ * Remove the element at a position, parking its handle for reuse.
+ *
+ * @param heap - the heap to remove from.
+ * @param pos - the position of the element.
+ * @return the removed element.
+ **/
+static void* __hp_take(heap_t* const heap, int pos) {
+   int hdl, moved, last;
+
+   hdl = heap->__heap[pos];
+   last = --heap->__size;
+
+   /* Fill the hole with the last element and restore order around it */
+   if(pos != last) {
+      moved = heap->__heap[last];
+      heap->__heap[pos] = moved;
+      heap->__pos[moved] = pos;
+
+      __hp_up(heap, pos);
+      __hp_down(heap, heap->__pos[moved]);
+   }
+
+   heap->__heap[last] = hdl;
+   heap->__pos[hdl] = -1;
+
+   return heap->__elems[hdl];
+}
@@ -17,43 +17,72 @@
  * along with this program.  If not, see {http://www.gnu.org/licenses/}.
  **/
 #include <stdlib.h>     /* For malloc(...), free(...) */
-#include <string.h>     /* For memcmp(...) */
+#include <limits.h>     /* For INT_MAX */
 #include "list.h"       /* For llist_t, ll_itr_t */
+#include "layout.h"     /* For struct __llist_s, __ll_node_t */
+#include "ops.h"        /* For __DS_EQ(...) */
+#include "pool.h"       /* For __ds_pool_run(...) */
+#include "mem.h"        /* For __DS_ALLOC(...), __DS_FREE(...) */
+#include "counters.h"   /* For __DS_COUNT(...), ... */
+#include "snapshot.h"   /* For __ds_snap_open(...), ... */
 
 
 #define ADDED 1
 #define EXIST 1
+#define SLAB_NODES 64
+#define PAR_CHUNKS 4    /* Chunks per thread for parallel apply */
+#define PAR_MIN 1024    /* Fewest elements per chunk for parallel apply */
+
+
+/* Internal node type (see layout.h) */
+typedef __ll_node_t __node_t;
 
 
 /**
- * Internal linkedlist definition.
+ * Internal slab type. A single allocation holding a block of count nodes.
+ * Slabs are chained together so they can be released in bulk.
  **/
-struct __llist_s {
-   void *__first;
-   void *__last;
-   size_t __elem_size;
-   int __size;
-};
+typedef struct __slab_s {
+   struct __slab_s *next;
+   size_t count;
+   __node_t nodes[1];
+} __slab_t;
+
+/* Size in bytes of a slab of n nodes */
+#define __SLAB_BYTES(n) (sizeof(__slab_t) + ((n) - 1) * sizeof(__node_t))
 
 
 /**
- * Internal linkedlist iterator definition.
+ * Internal node pool definition. Recycled nodes are kept on a singly linked
+ * free list threaded through their next pointers. Slabs come from __alloc,
+ * or the C library if it is NULL.
  **/
-struct __ll_iter_s {
-   void *__next;
-   void *__prev;
+struct __ll_pool_s {
+   __slab_t *__slabs;
+   __node_t *__free;
+   ds_allocator_t *__alloc;
+   size_t __slab_nodes;
 };
 
 
+/* Local functions */
+static __node_t* __ll_node_new(llist_t* const list);
+static void __ll_node_del(llist_t* const list, __node_t* const node);
+static __node_t* __ll_node_at(llist_t* const list, int index);
+static void __ll_unlink(llist_t* const list, __node_t* const node);
+static void __ll_apply_task(void* ctx, int task);
+
+
 /**
- * Internal node type. Only used in this file.
+ * Internal job description for ll_apply_par(...): the list's elements
+ * gathered into an array, split into ntasks contiguous chunks.
  **/
-typedef struct __node_s {
-   void *element;
-   int index;
-   struct __node_s *prev;
-   struct __node_s *next;
-} __node_t;
+typedef struct __ll_job_s {
+   void **elems;
+   void (*funct)(void* const);
+   int size;
+   int ntasks;
+} __ll_job_t;
 
 
 /**
@@ -68,9 +97,29 @@ typedef struct __node_s {
  *    allocation error.
  **/
 llist_t* __ll_init(size_t __elem_size) {
+   return __ll_init_alloc(__elem_size, NULL);
+}
+
+
+/**
+ * A simulated constructor for a linkedlist whose memory all comes from a user
+ * allocator: the list, its nodes, and the release of elements freed by
+ * ll_clear(...) and ll_free(...). Elements handed to such a list must
+ * therefore come from the same allocator. The allocator must outlive the
+ * list.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro ll_init_alloc(type, alloc).
+ *
+ * @param __elem_size - the size of an element in the linkedlist.
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty linkedlist. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+llist_t* __ll_init_alloc(size_t __elem_size, ds_allocator_t* const alloc) {
    llist_t *list;
 
-   list = malloc(sizeof(llist_t));
+   list = __DS_ALLOC(alloc, sizeof(llist_t));
 
    /* Alloc error */
    if(!list) return NULL;
@@ -78,9 +127,91 @@ llist_t* __ll_init(size_t __elem_size) {
    /* Initialize */
    list->__first = NULL;
    list->__last = NULL;
+   list->__pool = NULL;
+   list->__alloc = alloc;
    list->__elem_size = __elem_size;
+   list->__ops = ds_ops_mem;
+   list->__kind = DS_K_MEM;
+   list->__own_pool = 0;
    list->__size = 0;
 
+   __DS_STATS_INIT(list);
+   __DS_COUNT(list, allocs, 1);
+
+   return list;
+}
+
+
+/**
+ * A simulated constructor for a linkedlist whose nodes come from a node pool.
+ * Removed nodes are recycled instead of freed. If pool is NULL the list gets
+ * a private pool of its own, which is released in bulk by ll_free(...).
+ * Otherwise the list draws from the shared pool, which must outlive the list,
+ * and uses the pool's allocator for everything else.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macros ll_init_slab(type, n) or
+ * ll_init_pool(type, pool).
+ *
+ * @param __elem_size - the size of an element in the linkedlist.
+ * @param pool - the shared pool to allocate nodes from, or NULL.
+ * @param slab_nodes - the number of nodes per slab of a private pool. Uses a
+ *    default if zero (0). Ignored if pool is not NULL.
+ * @return a pointer to an empty linkedlist. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+llist_t* __ll_init_pool(size_t __elem_size, ll_pool_t* const pool,
+                        size_t slab_nodes) {
+   llist_t *list;
+
+   list = __ll_init_alloc(__elem_size, (pool ? pool->__alloc : NULL));
+
+   if(!list) return NULL;
+
+   /* Use the shared pool */
+   if(pool) {
+      list->__pool = pool;
+      return list;
+   }
+
+   list->__pool = ll_pool_init(slab_nodes);
+
+   if(!list->__pool) {
+      __DS_FREE(list->__alloc, list, sizeof(llist_t));
+      return NULL;
+   }
+
+   list->__own_pool = 1;
+
+   return list;
+}
+
+
+/**
+ * A simulated constructor for a linkedlist holding the elements of an array,
+ * in order. See ll_append_arr(...).
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro ll_from_arr(type, arr, n).
+ *
+ * @param __elem_size - the size of an element in the linkedlist.
+ * @param arr - the n elements to add.
+ * @param n - the number of elements.
+ * @return a pointer to a linkedlist of the elements. Returns a NULL pointer
+ *    if arr is NULL, n is negative, or upon allocation error.
+ **/
+llist_t* __ll_from_arr(size_t __elem_size, void** const arr, int n) {
+   llist_t *list;
+
+   list = __ll_init(__elem_size);
+
+   if(!list) return NULL;
+
+   if(!ll_append_arr(list, arr, n)) {
+      ll_free(list);
+      return NULL;
+   }
+
    return list;
 }
 
@@ -94,7 +225,219 @@ void ll_free(llist_t* const list) {
    if(!list) return;
 
    ll_clear(list);   /* Remove elements in list */
-   free(list);
+
+   if(list->__own_pool)
+      ll_pool_free(list->__pool);
+
+   __DS_FREE(list->__alloc, list, sizeof(llist_t));
+}
+
+
+/**
+ * Register the element callbacks used by ll_contains(...) and
+ * ll_indexof(...) to test elements for equality. Built-in callbacks from
+ * compare.h are inlined into the search loops. The callbacks are copied, so
+ * ops need not outlive the list.
+ *
+ * @param list - the list to configure.
+ * @param ops - the callbacks to use, or NULL to compare elements bytewise.
+ * @return 1 if the callbacks were registered. Returns 0 if the list is NULL.
+ **/
+int ll_setops(llist_t* const list, const ds_ops_t* const ops) {
+   if(!list) return !ADDED;
+
+   list->__ops = (ops ? *ops : ds_ops_mem);
+   list->__kind = __ds_kind(ops);
+
+   return ADDED;
+}
+
+
+/**
+ * A simulated constructor for a node pool. A pool may be shared between any
+ * number of lists created with ll_init_pool(type, pool).
+ *
+ * @param slab_nodes - the number of nodes to allocate at once when the pool
+ *    runs dry. Uses a default if zero (0).
+ * @return a pointer to an empty node pool. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+ll_pool_t* ll_pool_init(size_t slab_nodes) {
+   return ll_pool_init_alloc(slab_nodes, NULL);
+}
+
+
+/**
+ * A simulated constructor for a node pool whose slabs come from a user
+ * allocator. Lists created on the pool with ll_init_pool(type, pool) use the
+ * same allocator. The allocator must outlive the pool.
+ *
+ * @param slab_nodes - the number of nodes to allocate at once when the pool
+ *    runs dry. Uses a default if zero (0).
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty node pool. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+ll_pool_t* ll_pool_init_alloc(size_t slab_nodes,
+                              ds_allocator_t* const alloc) {
+   ll_pool_t *pool;
+
+   pool = __DS_ALLOC(alloc, sizeof(ll_pool_t));
+
+   if(!pool) return NULL;
+
+   pool->__slabs = NULL;
+   pool->__free = NULL;
+   pool->__alloc = alloc;
+   pool->__slab_nodes = (slab_nodes ? slab_nodes : SLAB_NODES);
+
+   return pool;
+}
+
+
+/**
+ * A simulated destructor for a node pool. Releases every slab at once. All
+ * lists using the pool must be freed before the pool is.
+ *
+ * @param pool - the pool to destroy.
+ **/
+void ll_pool_free(ll_pool_t* const pool) {
+   __slab_t *slab, *next;
+
+   if(!pool) return;
+
+   for(slab = pool->__slabs; slab; slab = next) {
+      next = slab->next;
+      __DS_FREE(pool->__alloc, slab, __SLAB_BYTES(slab->count));
+   }
+
+   __DS_FREE(pool->__alloc, pool, sizeof(ll_pool_t));
+}
+
+
+/**
+ * Allocate a node for a list, from its pool if it has one.
+ *
+ * @param list - the list the node will belong to.
+ * @return an uninitialized node. Returns NULL upon allocation error.
+ **/
+static __node_t* __ll_node_new(llist_t* const list) {
+   ll_pool_t *pool;
+   __slab_t *slab;
+   __node_t *node;
+   size_t i, count;
+
+   pool = list->__pool;
+
+   if(!pool) {
+      node = __DS_ALLOC(list->__alloc, sizeof(__node_t));
+
+      if(node) node->pooled = 0;
+
+      __DS_COUNT(list, allocs, 1);
+
+      return node;
+   }
+
+   /* Pool is dry; carve up a new slab */
+   if(!pool->__free) {
+      count = pool->__slab_nodes;
+      slab = __DS_ALLOC(pool->__alloc, __SLAB_BYTES(count));
+
+      if(!slab) return NULL;
+
+      __DS_COUNT(list, allocs, 1);
+
+      slab->next = pool->__slabs;
+      slab->count = count;
+      pool->__slabs = slab;
+
+      for(i = 0; i < count; i++) {
+         slab->nodes[i].pooled = 1;
+         slab->nodes[i].next = (i + 1 < count ? &slab->nodes[i + 1] : NULL);
+      }
+
+      pool->__free = slab->nodes;
+   }
+
+   node = pool->__free;
+   pool->__free = node->next;
+
+   return node;
+}
+
+
+/**
+ * Release a node, returning it to its pool if it came from one.
+ *
+ * @param list - the list the node belonged to.
+ * @param node - the node to release.
+ **/
+static void __ll_node_del(llist_t* const list, __node_t* const node) {
+   if(!node->pooled) {
+      __DS_FREE(list->__alloc, node, sizeof(__node_t));
+      return;
+   }
+
+   node->next = list->__pool->__free;
+   list->__pool->__free = node;
+}
+
+
+/**
+ * Find the node at the specified index, walking from whichever end of the
+ * list is closer.
+ *
+ * @param list - the list to search.
+ * @param index - the index of the node (assumed to be in range).
+ * @return the node at the specified index.
+ **/
+static __node_t* __ll_node_at(llist_t* const list, int index) {
+   __node_t *temp;
+   int count;
+
+   /* Walk forward from the front */
+   if(index < list->__size / 2) {
+      temp = list->__first;
+
+      for(count = 0; count < index; count++)
+         temp = temp->next;
+   }
+
+   /* Walk backward from the end */
+   else {
+      temp = list->__last;
+
+      for(count = list->__size - 1; count > index; count--)
+         temp = temp->prev;
+   }
+
+   __DS_WALK(list, (index < list->__size / 2 ? index :
+                    list->__size - 1 - index), 0);
+
+   return temp;
+}
+
+
+/**
+ * Unlink a node from a list and release it. Does not touch the element.
+ *
+ * @param list - the list containing the node.
+ * @param node - the node to unlink.
+ **/
+static void __ll_unlink(llist_t* const list, __node_t* const node) {
+   if(node->prev)
+      node->prev->next = node->next;
+   else
+      list->__first = node->next;
+
+   if(node->next)
+      node->next->prev = node->prev;
+   else
+      list->__last = node->prev;
+
+   __ll_node_del(list, node);
+   list->__size--;
 }
 
 
@@ -122,21 +465,19 @@ int ll_size(llist_t* const list) {
  **/
 int ll_add(llist_t* const list, int index, void* const elem) {
    __node_t *temp, *new;
-   int count;
 
    if(!list) return !ADDED;
 
    if(index < 0 || index > list->__size)
       return !ADDED;
 
-   new = malloc(sizeof(__node_t));  /* Allocate */
+   new = __ll_node_new(list);  /* Allocate */
 
    if(!new) return !ADDED;
 
 
    /* Initialize */
    new->element = elem;
-   new->index = index;
    new->prev = NULL;
    new->next = NULL;
 
@@ -146,6 +487,7 @@ int ll_add(llist_t* const list, int index, void* const elem) {
       list->__last = new;
 
       list->__size++;
+      __DS_PEAK(list, peak_size, list->__size);
       return ADDED;
    }
 
@@ -157,6 +499,7 @@ int ll_add(llist_t* const list, int index, void* const elem) {
       list->__last = new;
 
       list->__size++;
+      __DS_PEAK(list, peak_size, list->__size);
       return ADDED;
    }
 
@@ -167,31 +510,19 @@ int ll_add(llist_t* const list, int index, void* const elem) {
       list->__first = new;
    }
 
-   /* Adding somewhere in middle of list */
+   /* Adding somewhere in middle of list; insert before the current node */
    else {
-      count = 0;
-      temp = list->__first;
-
-      /* Loop until temp is at the desired index */
-      while(temp->next) {
-         if(count == index) {
-            new->next = temp->next;
-            new->prev = temp;
-            temp->next->prev = new;
-            temp->next = new;
+      temp = __ll_node_at(list, index);
 
-            break;
-         }
-
-         temp = temp->next;
-         count++;
-      }
+      new->next = temp;
+      new->prev = temp->prev;
+      temp->prev->next = new;
+      temp->prev = new;
    }
 
-   temp = new->next;
-
    /* Item added */
    list->__size++;
+   __DS_PEAK(list, peak_size, list->__size);
    return ADDED;
 }
 
@@ -220,6 +551,72 @@ void ll_addl(llist_t* const list, void* const elem) {
 }
 
 
+/**
+ * Adds the elements of an array to the end of a list, in order. All n nodes
+ * are carved from a single slab and linked in one pass, rather than
+ * allocated and appended one at a time. The slab belongs to the list's node
+ * pool; a list without one is given a private pool first, so nodes removed
+ * later are recycled by the list and released by ll_free(...). The list
+ * takes ownership of the elements, as with ll_addl(...).
+ *
+ * @param list - the list to add the elements to.
+ * @param arr - the n elements to add.
+ * @param n - the number of elements.
+ * @return 1 if the elements were added. Returns 0 if the list or arr is
+ *    NULL, n is negative or would overflow the list's size, or upon
+ *    allocation error, in which case the list is unchanged.
+ **/
+int ll_append_arr(llist_t* const list, void** const arr, int n) {
+   ll_pool_t *pool;
+   __slab_t *slab;
+   __node_t *nodes;
+   int i;
+
+   if(!list || !arr || n < 0 || n > INT_MAX - list->__size) return !ADDED;
+
+   if(n == 0) return ADDED;
+
+   if(!list->__pool) {
+      list->__pool = ll_pool_init_alloc(0, list->__alloc);
+
+      if(!list->__pool) return !ADDED;
+
+      list->__own_pool = 1;
+   }
+
+   pool = list->__pool;
+   slab = __DS_ALLOC(pool->__alloc, __SLAB_BYTES((size_t) n));
+
+   if(!slab) return !ADDED;
+
+   __DS_COUNT(list, allocs, 1);
+
+   slab->next = pool->__slabs;
+   slab->count = (size_t) n;
+   pool->__slabs = slab;
+
+   nodes = slab->nodes;
+
+   for(i = 0; i < n; i++) {
+      nodes[i].element = arr[i];
+      nodes[i].pooled = 1;
+      nodes[i].prev = (i > 0 ? &nodes[i - 1] : list->__last);
+      nodes[i].next = (i + 1 < n ? &nodes[i + 1] : NULL);
+   }
+
+   if(list->__last)
+      ((__node_t*) list->__last)->next = nodes;
+   else
+      list->__first = nodes;
+
+   list->__last = &nodes[n - 1];
+   list->__size += n;
+   __DS_PEAK(list, peak_size, list->__size);
+
+   return ADDED;
+}
+
+
 /**
  * Attempts to remove all elements in the specified list. If the elements of
  * the list are pointers to structures which have allocated memory associated
@@ -238,7 +635,7 @@ void ll_clear(llist_t* const list) {
     * the first element in the list.
     **/
    while(!ll_empty(list))
-      free(ll_remf(list));
+      __DS_FREE(list->__alloc, ll_remf(list), list->__elem_size);
 }
 
 
@@ -251,25 +648,7 @@ void ll_clear(llist_t* const list) {
  *    or if the list is NULL;
  **/
 int ll_contains(llist_t* const list, void* const elem) {
-   __node_t *temp;
-   size_t num_bytes;
-
-   if(!list) return !EXIST;
-
-   temp = list->__first;
-   num_bytes = list->__elem_size;
-
-   /* Loop through to find the element */
-   while(temp) {
-      /* If the element is found */
-      if(memcmp(elem, temp->element, num_bytes) == 0)
-         return EXIST;
-
-      temp = temp->next;
-   }
-
-   /* Element does not exist */
-   return !EXIST;
+   return (ll_indexof(list, elem) >= 0 ? EXIST : !EXIST);
 }
 
 
@@ -284,28 +663,12 @@ int ll_contains(llist_t* const list, void* const elem) {
  *    size of the list.
  **/
 void* ll_get(llist_t* const list, int index) {
-   __node_t *temp;
-   int count;
-
    if(!list) return NULL;
 
    if(index < 0 || index >= list->__size)
       return NULL;
 
-   temp = list->__first;
-   count = 0;
-
-   /* Loop until desired index is found */
-   while(temp) {
-      if(count == index)
-         return temp->element;   /* Return the element */
-
-      temp = temp->next;
-      count++;
-   }
-
-   /* Index not found */
-   return NULL;
+   return __ll_node_at(list, index)->element;
 }
 
 
@@ -318,7 +681,9 @@ void* ll_get(llist_t* const list, int index) {
  *    empty.
  **/
 void* ll_first(llist_t* const list) {
-   return ll_get(list, 0);
+   if(!list || !list->__first) return NULL;
+
+   return ((__node_t*) list->__first)->element;
 }
 
 
@@ -331,7 +696,9 @@ void* ll_first(llist_t* const list) {
  *    empty.
  **/
 void* ll_last(llist_t* const list) {
-   return ll_get(list, list->__size - 1);
+   if(!list || !list->__last) return NULL;
+
+   return ((__node_t*) list->__last)->element;
 }
 
 
@@ -347,25 +714,29 @@ void* ll_last(llist_t* const list) {
 int ll_indexof(llist_t* const list, void* const elem) {
    __node_t *temp;
    size_t num_bytes;
-   int count;
+   int count, kind;
 
    if(!list) return -1;
 
    temp = list->__first;
    num_bytes = list->__elem_size;
+   kind = list->__kind;
    count = 0;
 
    /* Look for first occurrence of element */
    while(temp) {
       /* If the element is found */
-      if(memcmp(elem, temp->element, num_bytes) == 0)
+      if(__DS_EQ(kind, list->__ops, elem, temp->element, num_bytes)) {
+         __DS_WALK(list, count + 1, 1);
          return count;
+      }
 
       temp = temp->next;
       count++;
    }
 
    /* Element not found */
+   __DS_WALK(list, count, 1);
    return -1;
 }
 
@@ -375,11 +746,8 @@ int ll_indexof(llist_t* const list, void* const elem) {
  *
  * @param list - the list to apply an operation over.
  * @param funct - the function to apply over the specified list, where the
- *    first argument to the function is an element in the list and the second
- *    argument is an argument to be supplied to the function for operational
- *    purposes.
- * @param arg - the argument to be supplied to the function that will be
- *    applied over the list.
+ *    argument to the function is an element in the list. Use
+ *    ll_apply_ctx(...) to pass the function an argument as well.
  **/
 void ll_apply(llist_t* const list, void (*funct)(void* const)) {
    __node_t *temp;
@@ -397,6 +765,113 @@ void ll_apply(llist_t* const list, void (*funct)(void* const)) {
 }
 
 
+/**
+ * Apply a function over all the elements in a list, first to last, handing each
+ * call a user supplied context pointer so that results can be accumulated
+ * without global state.
+ *
+ * @param list - the list to apply an operation over.
+ * @param funct - the function to apply, where the first argument is an element
+ *    in the list and the second argument is ctx.
+ * @param ctx - the context passed to every call of funct.
+ **/
+void ll_apply_ctx(llist_t* const list, void (*funct)(void* const, void*),
+                  void* ctx) {
+   __node_t *temp;
+
+   if(!list) return;
+
+   for(temp = list->__first; temp; temp = temp->next)
+      (funct)(temp->element, ctx);
+}
+
+
+/**
+ * Visit the elements in a list, first to last, stopping at the first element
+ * for which the visitor returns nonzero. Searches such as "find the first
+ * match" can stop there instead of walking the whole list.
+ *
+ * @param list - the list to visit.
+ * @param visit - the visitor, where the first argument is an element in the
+ *    list and the second argument is ctx. Returns nonzero to stop.
+ * @param ctx - the context passed to every call of visit.
+ * @return the element the visit stopped at. Returns NULL if the visitor never
+ *    returned nonzero or the list is NULL.
+ **/
+void* ll_visit(llist_t* const list, int (*visit)(void* const, void*),
+               void* ctx) {
+   __node_t *temp;
+
+   if(!list) return NULL;
+
+   for(temp = list->__first; temp; temp = temp->next)
+      if((visit)(temp->element, ctx))
+         return temp->element;
+
+   return NULL;
+}
+
+
+/**
+ * Apply a function over all the elements in a list using several threads.
+ * The list is walked once to gather its elements, which are then split into
+ * chunks handed out to a shared pool of worker threads. funct is therefore
+ * called concurrently and in no particular order, and must be safe to call
+ * that way. Falls back to ll_apply(...) if the elements cannot be gathered.
+ *
+ * @param list - the list to apply an operation over.
+ * @param funct - the function to apply to each element.
+ * @param nthreads - the most threads to use, the calling thread included. If
+ *    zero (0) or less, uses one thread per online processor.
+ **/
+void ll_apply_par(llist_t* const list, void (*funct)(void* const),
+                  int nthreads) {
+   __ll_job_t job;
+
+   if(!list || !funct) return;
+
+   job.elems = ll_toarr(list);
+
+   if(!job.elems) {
+      ll_apply(list, funct);
+      return;
+   }
+
+   job.funct = funct;
+   job.size = list->__size;
+   job.ntasks = __ds_pool_threads(nthreads) * PAR_CHUNKS;
+
+   if(job.ntasks > job.size / PAR_MIN)
+      job.ntasks = job.size / PAR_MIN;
+
+   if(job.ntasks < 1)
+      job.ntasks = 1;
+
+   __ds_pool_run(__ll_apply_task, &job, job.ntasks, nthreads);
+
+   free(job.elems);
+}
+
+
+/**
+ * Apply one chunk of an ll_apply_par(...) job.
+ *
+ * @param ctx - the job.
+ * @param task - the chunk to apply.
+ **/
+static void __ll_apply_task(void* ctx, int task) {
+   __ll_job_t *job;
+   int i, end;
+
+   job = ctx;
+   i = (int) ((double) job->size * task / job->ntasks);
+   end = (int) ((double) job->size * (task + 1) / job->ntasks);
+
+   for(; i < end; i++)
+      (job->funct)(job->elems[i]);
+}
+
+
 /**
  * Removes the element at the specified index in the specified list. Shifts
  * remaining elements left one position (decrementing indices).
@@ -408,9 +883,8 @@ void ll_apply(llist_t* const list, void (*funct)(void* const)) {
  *    the size of the list.
  **/
 void* ll_rem(llist_t* const list, int index) {
-   __node_t *temp, *target;
+   __node_t *target;
    void *result;
-   int count;
 
    if(!list) return NULL;
 
@@ -420,53 +894,12 @@ void* ll_rem(llist_t* const list, int index) {
    /* Removing from empty list */
    if(ll_empty(list)) return NULL;
 
-   target = NULL;
-
-   /* Removing from front of list */
-   if(index == 0) {
-      target = list->__first;
-      temp = target->next;
-
-      /* If there are more elements in the list */
-      if(temp)
-         temp->prev = NULL;
-      list->__first = temp;
-
-      /* There was only one element in the list to remove */
-      if(!temp)
-         list->__last = temp;
-   }
-
-   /* Remove from elsewhere in list */
-   else {
-      temp = list->__first;
-      count = 1;
-
-      /* Loop until temp is at the desired index */
-      while(temp->next) {
-         if(count == index) {
-            target = temp->next;
-
-            /* Target not at end of list */
-            if(target->next)
-               target->next->prev = temp;
-            temp->next = target->next;
-
-            break;
-         }
-
-         temp = temp->next;
-         count++;
-      }
-   }
-
-   temp = target->next;
+   target = __ll_node_at(list, index);
 
    /* Grab element, free containing node */
    result = target->element;
-   free(target);
+   __ll_unlink(list, target);
 
-   list->__size--;
    return result;
 }
 
@@ -479,7 +912,14 @@ void* ll_rem(llist_t* const list, int index) {
  *    NULL.
  **/
 void* ll_remf(llist_t* const list) {
-   return ll_rem(list, 0);
+   void *result;
+
+   if(!list || !list->__first) return NULL;
+
+   result = ((__node_t*) list->__first)->element;
+   __ll_unlink(list, list->__first);
+
+   return result;
 }
 
 
@@ -491,7 +931,14 @@ void* ll_remf(llist_t* const list) {
  *    NULL.
  **/
 void* ll_reml(llist_t* const list) {
-   return ll_rem(list, list->__size - 1);
+   void *result;
+
+   if(!list || !list->__last) return NULL;
+
+   result = ((__node_t*) list->__last)->element;
+   __ll_unlink(list, list->__last);
+
+   return result;
 }
 
 
@@ -506,31 +953,18 @@ void* ll_reml(llist_t* const list) {
 void* ll_set(llist_t* const list, int index, void* const elem) {
    __node_t *temp;
    void *former;
-   int count;
 
    if(!list) return NULL;
 
    if(index < 0 || index >= list->__size)
       return NULL;
 
-   temp = list->__first;
-   count = 0;
-
-   /* Loop until desired index is found */
-   while(temp) {
-      if(count == index) {
-         former = temp->element;
-         temp->element = elem;
+   temp = __ll_node_at(list, index);
 
-         return former;
-      }
+   former = temp->element;
+   temp->element = elem;
 
-      temp = temp->next;
-      count++;
-   }
-
-   /* Index not found */
-   return NULL;
+   return former;
 }
 
 
@@ -542,7 +976,8 @@ void* ll_set(llist_t* const list, int index, void* const elem) {
  * @return a pointer to an array representation of the list.
  **/
 void** ll_toarr(llist_t* const list) {
-   int** array;
+   void **array;
+   __node_t *temp;
    int i, count;
 
    if(!list) return NULL;
@@ -553,15 +988,41 @@ void** ll_toarr(llist_t* const list) {
 
    if(!array) return NULL;
 
-   /**
-    * TODO: has room for optimization
-    *
-    * Get the element at each position
-    **/
-   for(i = 0; i < count; i++)
-      array[i] = ll_get(list, i);
+   /* Get the element at each position in a single pass */
+   temp = list->__first;
 
-   return (void**) array;
+   for(i = 0; i < count; i++) {
+      array[i] = temp->element;
+      temp = temp->next;
+   }
+
+   return array;
+}
+
+
+/**
+ * Write the list's elements, first to last, to a snapshot file in the format
+ * written by v_save(...), so that it can be opened as a vector with
+ * v_open_mmap(...). The elements are written as their elem_size bytes, so
+ * only elements without pointers survive the round trip. path is left
+ * untouched unless the whole snapshot is written.
+ *
+ * @param list - the list to save.
+ * @param path - the file to write.
+ * @return 1 if the snapshot was written. Returns 0 if the list or path is
+ *    NULL, or upon I/O error.
+ **/
+int ll_save(llist_t* const list, const char* path) {
+   __ds_snap_t snap;
+   __node_t *temp;
+
+   if(!list || !__ds_snap_open(&snap, path, list->__elem_size, list->__size))
+      return !ADDED;
+
+   for(temp = list->__first; temp; temp = temp->next)
+      __ds_snap_put(&snap, temp->element, 1);
+
+   return __ds_snap_close(&snap);
 }
 
 
@@ -569,46 +1030,70 @@ void** ll_toarr(llist_t* const list) {
 
 /**
  * A simulated constructor for a linkedlist iterator. Returns an iterator over
- * a specified linkedlist starting at a specified index.
+ * a specified linkedlist starting at a specified index. Use ll_itr_init(...)
+ * to set up an iterator without allocating one.
  *
  * @param list - the list to return an iterator over.
- * @param index - the position that the iterator will start at.
+ * @param index - the position that the iterator will start at, between 0 and
+ *    the size of the list.
  * @return an iterator over the specified linkedlist. Returns a NULL pointer
- *    if the specified list is NULL, (index < 0 || index >= ll_size(list)), or
+ *    if the specified list is NULL, (index < 0 || index > ll_size(list)), or
  *    upon allocation error.
  **/
 ll_itr_t* ll_itr(llist_t* const list, int index) {
    ll_itr_t *iterator;
-   __node_t *temp;
-   int count;
 
-   if(!list) return NULL;
+   iterator = malloc(sizeof(ll_itr_t));
 
-   if(index < 0 || index >= list->__size)
+   if(!iterator) return NULL;
+
+   if(!ll_itr_init(iterator, list, index)) {
+      free(iterator);
       return NULL;
+   }
 
-   iterator = malloc(sizeof(ll_itr_t));
+   return iterator;
+}
 
-   if(!iterator) return NULL;
 
-   temp = list->__first;
-   count = 0;
+/**
+ * Set up a caller provided iterator, typically one declared on the stack,
+ * over a specified linkedlist starting at a specified index. The iterator
+ * must not be passed to li_free(...). Modifying the list other than through
+ * the iterator invalidates the iterator.
+ *
+ * @param itr - the iterator to set up.
+ * @param list - the list to iterate over.
+ * @param index - the position that the iterator will start at, between 0 and
+ *    the size of the list.
+ * @return 1 if the iterator was set up. Returns 0 if the iterator or list is
+ *    NULL or the index is out of range.
+ **/
+int ll_itr_init(ll_itr_t* const itr, llist_t* const list, int index) {
+   __node_t *temp;
 
-   /* Loop to desired position */
-   while(temp) {
-      if(count == index) {
-         iterator->__next = temp;
-         iterator->__prev = temp->prev;
+   if(!itr || !list) return !ADDED;
 
-         return iterator;
-      }
+   if(index < 0 || index > list->__size)
+      return !ADDED;
 
-      temp = temp->next;
-      count++;
+   itr->__list = list;
+   itr->__last = NULL;
+
+   /* Positioned after the last element */
+   if(index == list->__size) {
+      itr->__next = NULL;
+      itr->__prev = list->__last;
+      return ADDED;
    }
 
-   /* Index not found */
-   return NULL;
+   /* Walk to desired position */
+   temp = __ll_node_at(list, index);
+
+   itr->__next = temp;
+   itr->__prev = temp->prev;
+
+   return ADDED;
 }
 
 
@@ -668,14 +1153,15 @@ void* li_next(ll_itr_t* const itr) {
 
    temp = itr->__next;
 
+   /* No more items */
+   if(!temp) return NULL;
+
    /* Move iterator ahead */
-   if(temp) {
-      itr->__next = temp->next;
-      return temp->element;
-   }
+   itr->__prev = temp;
+   itr->__next = temp->next;
+   itr->__last = temp;
 
-   /* No more items */
-   return NULL;
+   return temp->element;
 }
 
 
@@ -693,13 +1179,93 @@ void* li_prev(ll_itr_t* const itr) {
 
    temp = itr->__prev;
 
+   /* No previous items */
+   if(!temp) return NULL;
+
    /* Move iterator backwards */
-   if(temp) {
-      itr->__prev = temp->prev;
-      return temp->element;
-   }
+   itr->__next = temp;
+   itr->__prev = temp->prev;
+   itr->__last = temp;
 
-   /* No previous items */
-   return NULL;
+   return temp->element;
+}
+
+
+/**
+ * Inserts an element at the iterator's cursor in constant time. A following
+ * li_next(...) is unaffected, while li_prev(...) would return the new
+ * element.
+ *
+ * @param itr - the iterator to insert at.
+ * @param elem - the element to insert.
+ * @return 1 if the element was added. Returns 0 if the iterator is NULL or
+ *    upon allocation error.
+ **/
+int li_add(ll_itr_t* const itr, void* const elem) {
+   llist_t *list;
+   __node_t *new, *prev, *next;
+
+   if(!itr) return !ADDED;
+
+   list = itr->__list;
+   new = __ll_node_new(list);
+
+   if(!new) return !ADDED;
+
+   prev = itr->__prev;
+   next = itr->__next;
+
+   /* Link between the nodes on either side of the cursor */
+   new->element = elem;
+   new->prev = prev;
+   new->next = next;
+
+   if(prev)
+      prev->next = new;
+   else
+      list->__first = new;
+
+   if(next)
+      next->prev = new;
+   else
+      list->__last = new;
+
+   list->__size++;
+   __DS_PEAK(list, peak_size, list->__size);
+
+   itr->__prev = new;
+   itr->__last = NULL;
+
+   return ADDED;
 }
 
+
+/**
+ * Removes the element most recently returned by li_next(...) or li_prev(...)
+ * in constant time. May be called once per call to either.
+ *
+ * @param itr - the iterator to remove through.
+ * @return the removed element. Returns NULL if the iterator is NULL or there
+ *    is no element to remove.
+ **/
+void* li_rem(ll_itr_t* const itr) {
+   __node_t *target;
+   void *result;
+
+   if(!itr || !itr->__last) return NULL;
+
+   target = itr->__last;
+
+   /* Step the cursor off of the node */
+   if(itr->__prev == target)
+      itr->__prev = target->prev;
+   else
+      itr->__next = target->next;
+
+   itr->__last = NULL;
+
+   result = target->element;
+   __ll_unlink(itr->__list, target);
+
+   return result;
+}
@@ -0,0 +1,307 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), calloc(...), free(...) */
+#include "matrix.h"
+
+
+#define ADDED 1
+
+/* Side of the square tiles mat_mul(...) works in: 3 tiles of 64 * 64
+ * doubles, 96KB, stay resident in a typical L2 cache */
+#define MUL_BLOCK 64
+
+/* Side of the square tiles mat_transpose(...) copies: a 32 * 32 tile of
+ * doubles, 8KB, stays resident in L1 while it is read by row and written by
+ * column */
+#define TRANS_BLOCK 32
+
+
+/**
+ * Internal dense matrix definition. Element (i, j) is __elems[i * __cols +
+ * j].
+ **/
+struct __mat_s {
+   double *__elems;
+   ds_idx_t __rows;
+   ds_idx_t __cols;
+};
+
+
+/* Address of element (i, j) of a matrix */
+#define __MAT_AT(m, i, j) ((m)->__elems + (size_t) (i) * (m)->__cols + (j))
+
+/* Smaller of two values */
+#define __MAT_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+
+/**
+ * A simulated constructor for a dense matrix. All elements start at zero
+ * (0.0).
+ *
+ * @param rows - the number of rows.
+ * @param cols - the number of columns.
+ * @return a pointer to a zeroed rows x cols matrix. Returns a NULL pointer if
+ *    either dimension is less than one (1), or upon allocation error.
+ **/
+mat_t* mat_init(ds_idx_t rows, ds_idx_t cols) {
+   mat_t *m;
+
+   if(rows < 1 || cols < 1) return NULL;
+
+   if((size_t) rows > ((size_t) -1) / sizeof(double) / (size_t) cols)
+      return NULL;
+
+   m = malloc(sizeof(mat_t));
+
+   if(!m) return NULL;
+
+   m->__elems = calloc((size_t) rows * (size_t) cols, sizeof(double));
+
+   if(!m->__elems) {
+      free(m);
+      return NULL;
+   }
+
+   m->__rows = rows;
+   m->__cols = cols;
+
+   return m;
+}
+
+
+/**
+ * A simulated destructor for a dense matrix.
+ *
+ * @param m - the matrix to destroy.
+ **/
+void mat_free(mat_t* const m) {
+   if(!m) return;
+
+   free(m->__elems);
+   free(m);
+}
+
+
+/**
+ * Retrieve the number of rows of a matrix.
+ *
+ * @param m - the matrix.
+ * @return the number of rows. Returns -1 if the matrix is NULL.
+ **/
+ds_idx_t mat_rows(mat_t* const m) {
+   return (m ? m->__rows : -1);
+}
+
+
+/**
+ * Retrieve the number of columns of a matrix.
+ *
+ * @param m - the matrix.
+ * @return the number of columns. Returns -1 if the matrix is NULL.
+ **/
+ds_idx_t mat_cols(mat_t* const m) {
+   return (m ? m->__cols : -1);
+}
+
+
+/**
+ * Retrieve an element of a matrix.
+ *
+ * @param m - the matrix.
+ * @param i - the row of the element.
+ * @param j - the column of the element.
+ * @return the element at (i, j). Returns 0.0 if the matrix is NULL or (i, j)
+ *    is out of range.
+ **/
+double mat_get(mat_t* const m, ds_idx_t i, ds_idx_t j) {
+   if(!m || i < 0 || i >= m->__rows || j < 0 || j >= m->__cols) return 0.0;
+
+   return *__MAT_AT(m, i, j);
+}
+
+
+/**
+ * Replace an element of a matrix.
+ *
+ * @param m - the matrix.
+ * @param i - the row of the element.
+ * @param j - the column of the element.
+ * @param val - the new value of the element.
+ * @return 1 if the element was set. Returns 0 if the matrix is NULL or (i, j)
+ *    is out of range.
+ **/
+int mat_set(mat_t* const m, ds_idx_t i, ds_idx_t j, double val) {
+   if(!m || i < 0 || i >= m->__rows || j < 0 || j >= m->__cols)
+      return !ADDED;
+
+   *__MAT_AT(m, i, j) = val;
+
+   return ADDED;
+}
+
+
+/**
+ * Retrieve a row of a matrix as an array. The array is the matrix's own
+ * storage: writing through it changes the matrix, and it stays valid until
+ * the matrix is freed. Consecutive rows are stored back to back, so
+ * mat_row(m, 0) is the whole matrix in row-major order.
+ *
+ * @param m - the matrix.
+ * @param i - the row.
+ * @return the mat_cols(m) elements of row i. Returns NULL if the matrix is
+ *    NULL or i is out of range.
+ **/
+double* mat_row(mat_t* const m, ds_idx_t i) {
+   if(!m || i < 0 || i >= m->__rows) return NULL;
+
+   return __MAT_AT(m, i, 0);
+}
+
+
+/**
+ * Set every element of a matrix to the same value.
+ *
+ * @param m - the matrix.
+ * @param val - the value.
+ **/
+void mat_fill(mat_t* const m, double val) {
+   size_t i, n;
+
+   if(!m) return;
+
+   n = (size_t) m->__rows * (size_t) m->__cols;
+
+   for(i = 0; i < n; i++)
+      m->__elems[i] = val;
+}
+
+
+/**
+ * Compute the transpose of a matrix. The copy proceeds tile by tile so that
+ * both the rows read and the columns written stay in cache, rather than every
+ * write of a long row landing on a different cache line.
+ *
+ * @param m - the matrix.
+ * @return a new cols x rows matrix. Returns NULL if the matrix is NULL or
+ *    upon allocation error.
+ **/
+mat_t* mat_transpose(mat_t* const m) {
+   mat_t *t;
+   ds_idx_t ii, jj, i, j, iend, jend;
+
+   if(!m) return NULL;
+
+   t = mat_init(m->__cols, m->__rows);
+
+   if(!t) return NULL;
+
+   for(ii = 0; ii < m->__rows; ii += TRANS_BLOCK) {
+      iend = __MAT_MIN(ii + TRANS_BLOCK, m->__rows);
+
+      for(jj = 0; jj < m->__cols; jj += TRANS_BLOCK) {
+         jend = __MAT_MIN(jj + TRANS_BLOCK, m->__cols);
+
+         for(i = ii; i < iend; i++)
+            for(j = jj; j < jend; j++)
+               *__MAT_AT(t, j, i) = *__MAT_AT(m, i, j);
+      }
+   }
+
+   return t;
+}
+
+
+/**
+ * Compute the product of two matrices. The product is built MUL_BLOCK (64)
+ * rows, columns and inner terms at a time, so the tiles of a, b and the
+ * product being combined stay in cache; within a tile, each element of a
+ * scales a contiguous run of a row of b, which the compiler can vectorize.
+ *
+ * @param a - the left matrix.
+ * @param b - the right matrix; must have as many rows as a has columns.
+ * @return a new mat_rows(a) x mat_cols(b) matrix. Returns NULL if either
+ *    matrix is NULL, their dimensions do not agree, or upon allocation error.
+ **/
+mat_t* mat_mul(mat_t* const a, mat_t* const b) {
+   mat_t *c;
+   double aik, *crow;
+   const double *brow;
+   ds_idx_t ii, kk, jj, i, k, j, iend, kend, jend;
+
+   if(!a || !b || a->__cols != b->__rows) return NULL;
+
+   c = mat_init(a->__rows, b->__cols);
+
+   if(!c) return NULL;
+
+   for(ii = 0; ii < a->__rows; ii += MUL_BLOCK) {
+      iend = __MAT_MIN(ii + MUL_BLOCK, a->__rows);
+
+      for(kk = 0; kk < a->__cols; kk += MUL_BLOCK) {
+         kend = __MAT_MIN(kk + MUL_BLOCK, a->__cols);
+
+         for(jj = 0; jj < b->__cols; jj += MUL_BLOCK) {
+            jend = __MAT_MIN(jj + MUL_BLOCK, b->__cols);
+
+            for(i = ii; i < iend; i++) {
+               crow = __MAT_AT(c, i, 0);
+
+               for(k = kk; k < kend; k++) {
+                  aik = *__MAT_AT(a, i, k);
+                  brow = __MAT_AT(b, k, 0);
+
+                  for(j = jj; j < jend; j++)
+                     crow[j] += aik * brow[j];
+               }
+            }
+         }
+      }
+   }
+
+   return c;
+}
+
+
+/**
+ * Multiply a matrix by a vector: y = m * x.
+ *
+ * @param m - the matrix.
+ * @param x - the mat_cols(m) elements of the vector to multiply.
+ * @param y - receives the mat_rows(m) elements of the product. Must not
+ *    overlap x.
+ * @return 1 if the product was computed. Returns 0 if any argument is NULL.
+ **/
+int mat_mulv(mat_t* const m, const double* x, double* y) {
+   const double *row;
+   double sum;
+   ds_idx_t i, j;
+
+   if(!m || !x || !y) return !ADDED;
+
+   for(i = 0; i < m->__rows; i++) {
+      row = __MAT_AT(m, i, 0);
+
+      for(sum = 0.0, j = 0; j < m->__cols; j++)
+         sum += row[j] * x[j];
+
+      y[i] = sum;
+   }
+
+   return ADDED;
+}
@@ -0,0 +1,42 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_MEM_H__
+#define __LIBDSTRUCTS_MEM_H__    /* Guard against multiple inclusion */
+
+/**
+ * Internal header dispatching the containers' allocations to a user
+ * allocator (a ds_allocator_t*), or to the C library if it is NULL. Not
+ * installed.
+ **/
+
+#include <stdlib.h>     /* For malloc(...), realloc(...), free(...) */
+#include "alloc.h"      /* For ds_allocator_t */
+
+
+#define __DS_ALLOC(a, size) \
+   ((a) ? (a)->alloc((a)->ctx, (size)) : malloc(size))
+
+#define __DS_REALLOC(a, ptr, old, size) \
+   ((a) ? (a)->realloc((a)->ctx, (ptr), (old), (size)) : \
+    realloc((ptr), (size)))
+
+#define __DS_FREE(a, ptr, size) \
+   ((a) ? (a)->free((a)->ctx, (ptr), (size)) : free(ptr))
+
+#endif   /* __LIBDSTRUCTS_MEM_H__ */
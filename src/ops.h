@@ -0,0 +1,64 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_OPS_H__
+#define __LIBDSTRUCTS_OPS_H__    /* Guard against multiple inclusion */
+
+/**
+ * Internal header shared by the containers' search loops. Not installed.
+ **/
+
+#include <stdint.h>     /* For int64_t, uint64_t */
+#include <string.h>     /* For memcmp(...) */
+#include "compare.h"    /* For ds_ops_t */
+
+
+/* Kinds of element equality, as classified by __ds_kind(...) */
+#define DS_K_MEM     0  /* Bytewise */
+#define DS_K_INT     1
+#define DS_K_UINT    2
+#define DS_K_I64     3
+#define DS_K_U64     4
+#define DS_K_FLOAT   5
+#define DS_K_DOUBLE  6
+#define DS_K_CUSTOM  7  /* Through the eq or cmp callback */
+
+
+/* Equality of two scalars of the same type */
+#define __DS_EQT(type, a, b) (*(const type*) (a) == *(const type*) (b))
+
+/**
+ * Test elements a and b for equality according to kind k and callbacks ops
+ * (a ds_ops_t, not a pointer). The built-in kinds compile to a direct
+ * comparison; the branch on k is loop invariant.
+ **/
+#define __DS_EQ(k, ops, a, b, size) \
+   ((k) == DS_K_MEM ? memcmp((a), (b), (size)) == 0 : \
+    (k) == DS_K_INT ? __DS_EQT(int, a, b) : \
+    (k) == DS_K_UINT ? __DS_EQT(unsigned int, a, b) : \
+    (k) == DS_K_I64 ? __DS_EQT(int64_t, a, b) : \
+    (k) == DS_K_U64 ? __DS_EQT(uint64_t, a, b) : \
+    (k) == DS_K_FLOAT ? __DS_EQT(float, a, b) : \
+    (k) == DS_K_DOUBLE ? __DS_EQT(double, a, b) : \
+    (ops).eq ? (ops).eq((a), (b), (size)) != 0 : \
+    (ops).cmp((a), (b), (size)) == 0)
+
+
+extern   int   __ds_kind   (const ds_ops_t* const ops);
+
+#endif   /* __LIBDSTRUCTS_OPS_H__ */
@@ -0,0 +1,184 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#define _POSIX_C_SOURCE 200112L  /* For pthreads, sysconf(...) */
+
+#include <pthread.h>    /* For pthread_create(...), ... */
+#include <unistd.h>     /* For sysconf(...) */
+#include "pool.h"
+
+
+/**
+ * Pool state. __lock guards everything below it; __run is held for the
+ * length of a job so that only one job uses the workers at a time.
+ *
+ * A job hands out task numbers from __next up to __ntasks. __seats is the
+ * number of workers still allowed to join it, and __finished counts the
+ * tasks that have completed.
+ **/
+static pthread_mutex_t __run = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t __lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t __work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t __done = PTHREAD_COND_INITIALIZER;
+
+static int __nworkers = 0;
+
+static __ds_task_t __task = NULL;
+static void *__ctx = NULL;
+static int __ntasks = 0;
+static int __next = 0;
+static int __seats = 0;
+static int __finished = 0;
+
+
+/* Local functions */
+static void* __pool_worker(void* arg);
+static void __pool_drain(void);
+
+
+/**
+ * Resolve the number of threads a job should use.
+ *
+ * @param nthreads - the number of threads asked for. If zero (0) or less,
+ *    uses the number of online processors.
+ * @return the number of threads to use, between 1 and DS_POOL_MAX.
+ **/
+int __ds_pool_threads(int nthreads) {
+   long cpus;
+
+   if(nthreads <= 0) {
+      cpus = sysconf(_SC_NPROCESSORS_ONLN);
+      nthreads = (cpus > 0 ? (int) (cpus < DS_POOL_MAX ? cpus : DS_POOL_MAX) :
+                  1);
+   }
+
+   return (nthreads < DS_POOL_MAX ? nthreads : DS_POOL_MAX);
+}
+
+
+/**
+ * Run tasks numbered 0 to ntasks - 1, spread over up to nthreads threads. The
+ * calling thread runs tasks too, and the call returns once all are done.
+ *
+ * @param task - the function to run for each task.
+ * @param ctx - passed to every task.
+ * @param ntasks - the number of tasks.
+ * @param nthreads - the number of threads to use; see __ds_pool_threads(...).
+ **/
+void __ds_pool_run(__ds_task_t task, void* ctx, int ntasks, int nthreads) {
+   pthread_t thread;
+   int i;
+
+   if(ntasks <= 0) return;
+
+   nthreads = __ds_pool_threads(nthreads);
+
+   if(nthreads > ntasks)
+      nthreads = ntasks;
+
+   /* Go serial when there is nothing to share or the pool is busy */
+   if(nthreads == 1 || pthread_mutex_trylock(&__run) != 0) {
+      for(i = 0; i < ntasks; i++)
+         (task)(ctx, i);
+
+      return;
+   }
+
+   pthread_mutex_lock(&__lock);
+
+   /* Grow the pool; a job runs with fewer workers if a thread fails */
+   while(__nworkers < nthreads - 1) {
+      if(pthread_create(&thread, NULL, __pool_worker, NULL) != 0)
+         break;
+
+      pthread_detach(thread);
+      __nworkers++;
+   }
+
+   /* Publish the job */
+   __task = task;
+   __ctx = ctx;
+   __ntasks = ntasks;
+   __next = 0;
+   __finished = 0;
+   __seats = nthreads - 1;
+
+   pthread_cond_broadcast(&__work);
+
+   __pool_drain();
+
+   while(__finished < __ntasks)
+      pthread_cond_wait(&__done, &__lock);
+
+   /* Retire the job so late workers go back to sleep */
+   __ntasks = 0;
+   __next = 0;
+   __seats = 0;
+
+   pthread_mutex_unlock(&__lock);
+   pthread_mutex_unlock(&__run);
+}
+
+
+/**
+ * Run tasks of the current job until none are left to claim. Called and
+ * returns with __lock held.
+ **/
+static void __pool_drain(void) {
+   __ds_task_t task;
+   void *ctx;
+   int i;
+
+   task = __task;
+   ctx = __ctx;
+
+   while(__next < __ntasks) {
+      i = __next++;
+
+      pthread_mutex_unlock(&__lock);
+      (task)(ctx, i);
+      pthread_mutex_lock(&__lock);
+
+      if(++__finished == __ntasks)
+         pthread_cond_broadcast(&__done);
+   }
+}
+
+
+/**
+ * Body of a worker thread. Sleeps until a job has both a free seat and
+ * unclaimed tasks, then helps drain it.
+ *
+ * @param arg - unused.
+ * @return never returns.
+ **/
+static void* __pool_worker(void* arg) {
+   (void) arg;
+
+   pthread_mutex_lock(&__lock);
+
+   for(;;) {
+      while(!(__seats > 0 && __next < __ntasks))
+         pthread_cond_wait(&__work, &__lock);
+
+      __seats--;
+      __pool_drain();
+   }
+
+   return NULL;
+}
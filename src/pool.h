@@ -0,0 +1,43 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_POOL_H__
+#define __LIBDSTRUCTS_POOL_H__   /* Guard against multiple inclusion */
+
+/**
+ * Internal header for the worker pool behind the *_apply_par(...) functions.
+ * Not installed.
+ *
+ * The pool is created on first use, grows to the largest number of threads
+ * asked for, and lives as long as the process. It runs one job at a time; a
+ * job started while another is running (including from inside one of its
+ * tasks) runs serially on the calling thread instead.
+ **/
+
+/* Most threads a job may use, the calling thread included */
+#define DS_POOL_MAX 64
+
+/* A task: the ctx given to __ds_pool_run(...) and the task's number */
+typedef void (*__ds_task_t)(void* ctx, int task);
+
+
+extern   int   __ds_pool_threads (int nthreads);
+extern   void  __ds_pool_run     (__ds_task_t task, void* ctx, int ntasks,
+                                  int nthreads);
+
+#endif   /* __LIBDSTRUCTS_POOL_H__ */
@@ -0,0 +1,152 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>
+#include "priority-queue.h"
+#include "heap.h"
+
+
+/**
+ * Internal definition of a priority queue. Built upon a 4-ary heap.
+ **/
+struct pq_s {
+   heap_t *__heap;
+};
+
+
+/**
+ * A simulated constructor for a priority queue.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro pq_init(type, cmp), where type is the type
+ * that the user wishes to restrict the queue to.
+ *
+ * @param __elem_size - the size of an element in the queue.
+ * @param cmp - the function used to order elements. Uses ds_cmp_mem(...) if
+ *    NULL.
+ * @return a pointer to an empty priority queue. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+pq_t* __pq_init(size_t __elem_size, ds_cmp_t cmp) {
+   pq_t *queue;
+
+   queue = malloc(sizeof(pq_t));
+
+   if(!queue) return NULL;
+
+   queue->__heap = __hp_init(__elem_size, cmp, HP_ARITY);
+
+   if(!queue->__heap) {
+      free(queue);
+      return NULL;
+   }
+
+   return queue;
+}
+
+
+/**
+ * A simulated destructor for a priority queue.
+ *
+ * @param q - the queue to destroy.
+ **/
+void pq_free(pq_t* const q) {
+   if(!q) return;
+
+   hp_free(q->__heap);
+   free(q);
+}
+
+
+/**
+ * Retrieve the size of a priority queue.
+ *
+ * @param q - the queue to retrieve the size of.
+ * @return the number of elements in the queue. Returns -1 if the queue is
+ *    NULL.
+ **/
+int pq_size(pq_t* const q) {
+   return (q ? hp_size(q->__heap) : -1);
+}
+
+
+/**
+ * Retrieves (but does not remove) the next item to be removed from the queue.
+ * That is, the element that orders first.
+ *
+ * @param q - the queue to retrieve the element from.
+ * @return the next element to be returned by a call to pq_deq(...). Returns
+ *    NULL if the queue is empty or NULL.
+ **/
+void* pq_head(pq_t* const q) {
+   return (q ? hp_top(q->__heap) : NULL);
+}
+
+
+/**
+ * Add a specified element to the priority queue.
+ *
+ * @param q - the queue to add the specified element to.
+ * @param elem - the element to add to the queue.
+ * @return a handle for the element, usable with pq_decrease(...) until the
+ *    element is dequeued. Returns -1 if either parameter is NULL or upon
+ *    allocation error.
+ **/
+int pq_enq(pq_t* const q, void* const elem) {
+   return (q ? hp_push(q->__heap, elem) : -1);
+}
+
+
+/**
+ * Removes and returns the head of the priority queue.
+ *
+ * @param q - the queue to retrieve the element from.
+ * @return the element that ordered first. Returns NULL if the queue is empty
+ *    or NULL.
+ **/
+void* pq_deq(pq_t* const q) {
+   return (q ? hp_pop(q->__heap) : NULL);
+}
+
+
+/**
+ * Replaces a queued element by one that orders no later than it.
+ *
+ * @param q - the queue containing the element.
+ * @param hdl - the handle returned when the element was enqueued.
+ * @param elem - the replacement element.
+ * @return the element previously stored under the handle. Returns NULL if a
+ *    parameter is NULL or the handle is not in use.
+ **/
+void* pq_decrease(pq_t* const q, int hdl, void* const elem) {
+   return (q ? hp_decrease(q->__heap, hdl, elem) : NULL);
+}
+
+
+/**
+ * Creates and returns a pointer to an array representation of the priority
+ * queue, which free(...) may be called on. The head is at index zero (0); the
+ * remaining elements are in heap order, not sorted.
+ *
+ * @param q - the queue to translate to an array.
+ * @return a pointer to an array representation of the queue. Returns NULL if
+ *    the queue is NULL.
+ **/
+void** pq_toarr(pq_t* const q) {
+   return (q ? hp_toarr(q->__heap) : NULL);
+}
@@ -16,22 +16,28 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see {http://www.gnu.org/licenses/}.
  **/
-#include <stdio.h>
-#include <stdlib.h>
+#include <stdlib.h>     /* For malloc(...), free(...) */
+#include <string.h>     /* For memcpy(...) */
+#undef DSTRUCTS_INLINE  /* The out-of-line accessors are defined here */
 #include "queue.h"
-#include "list.h"
+#include "layout.h"     /* For struct que_s */
+#include "mem.h"        /* For __DS_ALLOC(...), __DS_FREE(...) */
+#include "counters.h"   /* For __DS_COUNT(...), ... */
+#include "snapshot.h"   /* For __ds_snap_open(...), ... */
 
 
-/**
- * Internal definition of a queue. Built upon a linkedlist.
- **/
-struct que_s {
-   llist_t *__list;
-};
+#define INIT_SIZE 16
+#define ADDED 1
+
+
+/* Local functions */
+static que_t* __q_create(size_t __elem_size, ds_idx_t cap, int fixed,
+                         ds_allocator_t* const alloc);
+static int __q_expand(que_t* const q);
 
 
 /**
- * A simulated constructor for a queue.
+ * A simulated constructor for a queue. The queue grows as needed.
  *
  * NOTE: This is a function that is not intended for use by the user. The user
  * should instead use the macro q_init(type), where type is the type that
@@ -42,33 +48,106 @@ struct que_s {
  *    error.
  **/
 que_t* __q_init(size_t __elem_size) {
+   return __q_create(__elem_size, INIT_SIZE, 0, NULL);
+}
+
+
+/**
+ * A simulated constructor for a fixed-capacity queue. All storage is
+ * allocated up front; enqueueing onto a full queue fails rather than
+ * allocating.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro q_init_fixed(type, cap).
+ *
+ * @param __elem_size - the size of an element in the queue.
+ * @param cap - the maximum number of elements the queue can hold.
+ * @return a pointer to an empty queue. Returns a NULL pointer if cap is less
+ *    than one (1), too large for its buffer to be sized in a size_t, or upon
+ *    allocation error.
+ **/
+que_t* __q_init_fixed(size_t __elem_size, ds_idx_t cap) {
+   if(cap < 1) return NULL;
+
+   return __q_create(__elem_size, cap, 1, NULL);
+}
+
+
+/**
+ * A simulated constructor for a queue whose memory all comes from a user
+ * allocator, including the release of elements freed by q_free(...).
+ * Elements enqueued onto such a queue must therefore come from the same
+ * allocator. The allocator must outlive the queue.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro q_init_alloc(type, alloc).
+ *
+ * @param __elem_size - the size of an element in the queue.
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty queue. Returns a NULL pointer upon allocation
+ *    error.
+ **/
+que_t* __q_init_alloc(size_t __elem_size, ds_allocator_t* const alloc) {
+   return __q_create(__elem_size, INIT_SIZE, 0, alloc);
+}
+
+
+/**
+ * Common constructor for growable and fixed queues.
+ *
+ * @param __elem_size - the size of an element in the queue.
+ * @param cap - the initial capacity of the queue.
+ * @param fixed - nonzero if the queue may never grow.
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty queue. Returns a NULL pointer if the buffer
+ *    cannot be sized in a size_t or upon allocation error.
+ **/
+static que_t* __q_create(size_t __elem_size, ds_idx_t cap, int fixed,
+                         ds_allocator_t* const alloc) {
    que_t *queue;
 
-   queue = malloc(sizeof(que_t));
+   if((size_t) cap > (size_t) -1 / sizeof(void*)) return NULL;
+
+   queue = __DS_ALLOC(alloc, sizeof(que_t));
 
    if(!queue) return NULL;
 
-   queue->__list = __ll_init(__elem_size);
+   queue->__elements = __DS_ALLOC(alloc, sizeof(void*) * cap);
 
-   if(!queue->__list) {
-      free(queue);
+   if(!queue->__elements) {
+      __DS_FREE(alloc, queue, sizeof(que_t));
       return NULL;
    }
 
+   queue->__alloc = alloc;
+   queue->__elem_size = __elem_size;
+   queue->__head = 0;
+   queue->__size = 0;
+   queue->__cap = cap;
+   queue->__fixed = fixed;
+
+   __DS_STATS_INIT(queue);
+   __DS_COUNT(queue, allocs, 2);
+   __DS_PEAK(queue, peak_cap, cap);
+
    return queue;
 }
 
 
 /**
- * A simulated destructor for a queue.
+ * A simulated destructor for a queue. Frees any elements remaining in the
+ * queue.
  *
  * @param q - the queue to destroy.
  **/
 void q_free(que_t* const q) {
    if(!q) return;
 
-   ll_free(q->__list);
-   free(q);
+   while(q->__size)
+      __DS_FREE(q->__alloc, q_deq(q), q->__elem_size);
+
+   __DS_FREE(q->__alloc, q->__elements, sizeof(void*) * q->__cap);
+   __DS_FREE(q->__alloc, q, sizeof(que_t));
 
    return;
 }
@@ -81,8 +160,21 @@ void q_free(que_t* const q) {
  * @return the number of elements in the queue. Returns -1 if the queue is
  *    NULL.
  **/
-int q_size(que_t* const q) {
-   return (q ? ll_size(q->__list) : -1);
+ds_idx_t q_size(que_t* const q) {
+   return (q ? q->__size : -1);
+}
+
+
+/**
+ * Retrieve the capacity of a queue. That is, the number of elements the queue
+ * can hold before it must grow (or, for a fixed queue, before q_enq(...)
+ * fails).
+ *
+ * @param q - the queue to retrieve the capacity of.
+ * @return the capacity of the queue. Returns -1 if the queue is NULL.
+ **/
+ds_idx_t q_cap(que_t* const q) {
+   return (q ? q->__cap : -1);
 }
 
 
@@ -96,7 +188,9 @@ int q_size(que_t* const q) {
  *    NULL if the queue is NULL.
  **/
 void* q_head(que_t* const q) {
-   return (q ? ll_first(q->__list) : NULL);
+   if(!q || !q->__size) return NULL;
+
+   return q->__elements[q->__head];
 }
 
 
@@ -110,7 +204,55 @@ void* q_head(que_t* const q) {
  *    NULL if the queue is NULL.
  **/
 void* q_tail(que_t* const q) {
-   return (q ? ll_last(q->__list) : NULL);
+   ds_idx_t tail;
+
+   if(!q || !q->__size) return NULL;
+
+   tail = q->__head + q->__size - 1;
+
+   if(tail >= q->__cap)
+      tail -= q->__cap;
+
+   return q->__elements[tail];
+}
+
+
+/**
+ * Double the capacity of a full queue, unwrapping its contents to the start
+ * of the new buffer.
+ *
+ * @param q - the queue to expand.
+ * @return 1 if the queue was expanded. Returns 0 if the doubled capacity
+ *    cannot be represented or upon allocation error.
+ **/
+static int __q_expand(que_t* const q) {
+   void **elements;
+   ds_idx_t first;
+
+   if(q->__cap > DS_IDX_MAX / 2 ||
+      (size_t) q->__cap > (size_t) -1 / 2 / sizeof(void*))
+      return !ADDED;
+
+   elements = __DS_ALLOC(q->__alloc, sizeof(void*) * q->__cap * 2);
+
+   if(!elements) return !ADDED;
+
+   /* Copy the two contiguous runs: head to end, then start to tail */
+   first = q->__cap - q->__head;
+   memcpy(elements, q->__elements + q->__head, sizeof(void*) * first);
+   memcpy(elements + first, q->__elements, sizeof(void*) * q->__head);
+
+   __DS_FREE(q->__alloc, q->__elements, sizeof(void*) * q->__cap);
+
+   q->__elements = elements;
+   q->__head = 0;
+   q->__cap *= 2;
+
+   __DS_COUNT(q, reallocs, 1);
+   __DS_COUNT(q, bytes_copied, sizeof(void*) * q->__size);
+   __DS_PEAK(q, peak_cap, q->__cap);
+
+   return ADDED;
 }
 
 
@@ -120,11 +262,29 @@ void* q_tail(que_t* const q) {
  *
  * @param q - the queue to add the specified element to.
  * @param elem - the element to add to the queue.
+ * @return 1 if the element was added. Returns 0 if either parameter is NULL,
+ *    if a fixed queue is full, or upon allocation error.
  **/
-void q_enq(que_t* const q, void* const elem) {
-   if(!q || !elem) return;
+int q_enq(que_t* const q, void* const elem) {
+   ds_idx_t tail;
+
+   if(!q || !elem) return !ADDED;
+
+   if(q->__size == q->__cap)
+      if(q->__fixed || !__q_expand(q))
+         return !ADDED;
+
+   tail = q->__head + q->__size;
 
-   ll_addl(q->__list, elem);
+   if(tail >= q->__cap)
+      tail -= q->__cap;
+
+   q->__elements[tail] = elem;
+   q->__size++;
+
+   __DS_PEAK(q, peak_size, q->__size);
+
+   return ADDED;
 }
 
 
@@ -135,19 +295,113 @@ void q_enq(que_t* const q, void* const elem) {
  * @return the head of the queue. Returns NULL if the queue is empty or NULL.
  **/
 void* q_deq(que_t* const q) {
-   return (q ? ll_remf(q->__list) : NULL);
+   void *target;
+
+   if(!q || !q->__size) return NULL;
+
+   target = q->__elements[q->__head];
+
+   if(++q->__head == q->__cap)
+      q->__head = 0;
+
+   q->__size--;
+
+   return target;
 }
 
 
 /**
  * Creates and returns a pointer to an array representation of the queue,
- * which free(...) may be called on.
+ * which free(...) may be called on. The head of the queue is at index zero
+ * (0).
  *
  * @param q - the queue to translate to an array.
  * @return a pointer to an array representation of the queue. Returns NULL if
  *    the queue is NULL.
  **/
 void** q_toarr(que_t* const q) {
-   return (q ? ll_toarr(q->__list) : NULL);
+   void **array;
+   ds_idx_t first;
+
+   if(!q) return NULL;
+
+   array = malloc(sizeof(void*) * q->__size);
+
+   if(!array) return NULL;
+
+   /* Elements from head up to the end of the buffer (or the tail) */
+   first = q->__cap - q->__head;
+
+   if(first > q->__size)
+      first = q->__size;
+
+   memcpy(array, q->__elements + q->__head, sizeof(void*) * first);
+   memcpy(array + first, q->__elements, sizeof(void*) * (q->__size - first));
+
+   return array;
 }
 
+
+/**
+ * Write the queue's elements, head to tail, to a snapshot file in the format
+ * written by v_save(...), so that it can be opened as a vector with
+ * v_open_mmap(...). The elements are written as their elem_size bytes, so
+ * only elements without pointers survive the round trip. path is left
+ * untouched unless the whole snapshot is written.
+ *
+ * @param q - the queue to save.
+ * @param path - the file to write.
+ * @return 1 if the snapshot was written. Returns 0 if the queue or path is
+ *    NULL, or upon I/O error.
+ **/
+int q_save(que_t* const q, const char* path) {
+   __ds_snap_t snap;
+   ds_idx_t i;
+
+   if(!q || !__ds_snap_open(&snap, path, q->__elem_size, q->__size))
+      return !ADDED;
+
+   for(i = 0; i < q->__size; i++)
+      __ds_snap_put(&snap, q->__elements[(q->__head + i) % q->__cap], 1);
+
+   return __ds_snap_close(&snap);
+}
+
+
+/**
+ * Returns a borrowed view of the queue without copying. The ring buffer holds
+ * the queue in at most two contiguous runs of element pointers: seg[0] runs
+ * from the head towards the end of the buffer, and seg[1], if the queue has
+ * wrapped around, from the start of the buffer up to the tail. Together they
+ * list the elements from head to tail. The view must not be freed, and is
+ * only valid until the next call that modifies the queue.
+ *
+ * @param q - the queue to view.
+ * @return a view of the queue's elements. An empty view is returned if the
+ *    queue is NULL.
+ **/
+ds_span2_t q_view(que_t* const q) {
+   ds_span2_t view;
+   ds_idx_t first;
+
+   view.seg[0].data = view.seg[1].data = NULL;
+   view.seg[0].len = view.seg[1].len = 0;
+   view.seg[0].stride = view.seg[1].stride = sizeof(void*);
+
+   if(!q || !q->__size) return view;
+
+   first = q->__cap - q->__head;
+
+   if(first > q->__size)
+      first = q->__size;
+
+   view.seg[0].data = q->__elements + q->__head;
+   view.seg[0].len = (size_t) first;
+
+   if(q->__size > first) {
+      view.seg[1].data = q->__elements;
+      view.seg[1].len = (size_t) (q->__size - first);
+   }
+
+   return view;
+}
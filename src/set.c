@@ -0,0 +1,1131 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), calloc(...), free(...) */
+#include <string.h>     /* For memcpy(...), memset(...) */
+#include "set.h"
+#include "layout.h"     /* For struct __vect_s, struct __llist_s */
+
+
+#define INIT_SIZE 16    /* Initial number of index slots; a power of two */
+#define ADDED 1
+#define EXIST 1
+#define GALLOP 8        /* Size ratio from which operands are galloped */
+
+/* Maximum load factor, as a fraction of LOAD_DEN */
+#define LOAD_NUM 3
+#define LOAD_DEN 4
+
+/* Kinds of operand */
+#define SRC_V     0
+#define SRC_LL    1
+#define SRC_SET   2
+
+
+/* Internal index slot type. Only used in this file. */
+typedef struct __set_slot_s {
+   unsigned long hash;
+   ds_idx_t pos;
+} __set_slot_t;
+
+
+/**
+ * Internal set definition. The elements are stored back to back in
+ * __elems, in no particular order; removing one moves the last element into
+ * its place. __slots indexes them by hash with linear probing, and holds each
+ * element's hash and position. A stored hash of zero (0) marks an empty slot;
+ * hashes are forced nonzero before they are stored. __cap is the number of
+ * elements __elems has room for, which keeps the index at most LOAD_NUM /
+ * LOAD_DEN full.
+ **/
+struct __set_s {
+   char *__elems;
+   __set_slot_t *__slots;
+   ds_hash_t __hash;
+   ds_eq_t __eq;
+   size_t __elem_size;
+   size_t __mask;
+   ds_idx_t __size;
+   ds_idx_t __cap;
+};
+
+
+/**
+ * Internal cursor type for walking an operand in order. Only used in this
+ * file.
+ **/
+typedef struct __set_cur_s {
+   set_src_t src;
+   ds_idx_t pos;
+   __ll_node_t *node;
+} __set_cur_t;
+
+
+/* Address of the element at the specified position */
+#define __SET_ELEM(s, i) ((s)->__elems + (size_t) (i) * (s)->__elem_size)
+
+/* Element at the specified index of a vector (assumed to be in range) */
+#define __SET_VGET(v, i) \
+   ((v)->__inl ? (void*) ((v)->__elements + (size_t) (i) * (v)->__stride) : \
+    *(void**) ((v)->__elements + (size_t) (i) * (v)->__stride))
+
+/* Whether both operands may be merged in the order of ops->cmp */
+#define __SET_SORTED(a, b, ops) \
+   ((ops) && (ops)->cmp && (a).__sorted && (b).__sorted)
+
+
+/* Local functions */
+static unsigned long __set_hash(set_t* const s, const void* const elem);
+static ds_idx_t __set_find(set_t* const s, const void* const elem,
+                           unsigned long h, size_t* const hole);
+static int __set_insert(set_t* const s, const void* const elem);
+static int __set_resize(set_t* const s, size_t slots);
+static void __set_unslot(set_t* const s, size_t i);
+static ds_idx_t __set_len(const set_src_t* const src);
+static size_t __set_elem_size(const set_src_t* const a,
+                              const set_src_t* const b);
+static void __set_begin(__set_cur_t* const cur, const set_src_t* const src);
+static void* __set_next(__set_cur_t* const cur);
+static int __set_fill(set_t* const s, const set_src_t* const src);
+static set_t* __set_probe(const set_src_t* const src,
+                          const ds_ops_t* const ops, size_t size,
+                          set_t** const tmp);
+static vect_t* __set_vect(set_t* const s);
+static int __set_emit(vect_t* const r, void* const elem, ds_cmp_t cmp);
+static ds_idx_t __set_gallop_to(vect_t* const v, ds_idx_t lo,
+                                void* const elem, ds_cmp_t cmp);
+static int __set_gallop(const set_src_t* const a, vect_t* const b,
+                        ds_cmp_t cmp, int want, vect_t* const r);
+static int __set_merge(const set_src_t* const a, const set_src_t* const b,
+                       ds_cmp_t cmp, int want, vect_t* const r);
+static int __set_walk(const set_src_t* const a, const set_src_t* const b,
+                      ds_cmp_t cmp, int want, vect_t* const r);
+
+
+/**
+ * A simulated constructor for a set.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro set_init(type) or set_init_fn(type, hash, eq),
+ * where type is the type of the elements in the set.
+ *
+ * @param __elem_size - the size of an element in the set.
+ * @param hash - the function used to hash elements. Uses ds_hash_mem(...) if
+ *    NULL.
+ * @param eq - the function used to compare elements. Uses ds_eq_mem(...) if
+ *    NULL.
+ * @return a pointer to an empty set. Returns a NULL pointer if __elem_size is
+ *    zero (0) or upon allocation error.
+ **/
+set_t* __set_init(size_t __elem_size, ds_hash_t hash, ds_eq_t eq) {
+   set_t *set;
+
+   if(!__elem_size) return NULL;
+
+   set = malloc(sizeof(set_t));
+
+   if(!set) return NULL;
+
+   set->__elems = NULL;
+   set->__slots = NULL;
+   set->__hash = (hash ? hash : ds_hash_mem);
+   set->__eq = (eq ? eq : ds_eq_mem);
+   set->__elem_size = __elem_size;
+   set->__size = 0;
+
+   if(!__set_resize(set, INIT_SIZE)) {
+      free(set);
+      return NULL;
+   }
+
+   return set;
+}
+
+
+/**
+ * A simulated destructor for a set.
+ *
+ * @param s - the set to destroy.
+ **/
+void set_free(set_t* const s) {
+   if(!s) return;
+
+   free(s->__elems);
+   free(s->__slots);
+   free(s);
+}
+
+
+/**
+ * Retrieve the size of a set.
+ *
+ * @param s - the set to retrieve the size of.
+ * @return the number of elements in the set. Returns -1 if the set is NULL.
+ **/
+ds_idx_t set_size(set_t* const s) {
+   return (s ? s->__size : -1);
+}
+
+
+/**
+ * Ensure a set can hold at least the specified number of elements without
+ * having to grow.
+ *
+ * @param s - the set to reserve space in.
+ * @param n - the number of elements the set must be able to hold.
+ * @return 1 if the set can hold n elements. Returns 0 if the set is NULL, n
+ *    is negative, or upon allocation error.
+ **/
+int set_reserve(set_t* const s, ds_idx_t n) {
+   size_t slots;
+
+   if(!s || n < 0) return !ADDED;
+
+   if(n <= s->__cap) return ADDED;
+
+   for(slots = s->__mask + 1; (size_t) n > slots / LOAD_DEN * LOAD_NUM;
+       slots <<= 1)
+      if(slots > ((size_t) -1 >> 1) / sizeof(__set_slot_t))
+         return !ADDED;
+
+   return __set_resize(s, slots);
+}
+
+
+/**
+ * Rebuild a set's index with the specified number of slots, and resize its
+ * element buffer to match.
+ *
+ * @param s - the set to resize.
+ * @param slots - the new number of slots; a power of two large enough for
+ *    the set's elements.
+ * @return 1 if the set was resized. Returns 0 upon allocation error, in which
+ *    case the set is left unchanged.
+ **/
+static int __set_resize(set_t* const s, size_t slots) {
+   __set_slot_t *fresh;
+   char *elems;
+   size_t i, j, mask;
+   ds_idx_t cap;
+
+   cap = (ds_idx_t) (slots / LOAD_DEN * LOAD_NUM);
+
+   fresh = calloc(slots, sizeof(__set_slot_t));
+
+   if(!fresh) return !ADDED;
+
+   elems = realloc(s->__elems, (size_t) cap * s->__elem_size);
+
+   if(!elems) {
+      free(fresh);
+      return !ADDED;
+   }
+
+   mask = slots - 1;
+
+   /* Stored hashes spare calling the hash function again */
+   if(s->__slots)
+      for(i = 0; i <= s->__mask; i++)
+         if(s->__slots[i].hash) {
+            j = s->__slots[i].hash & mask;
+
+            while(fresh[j].hash) j = (j + 1) & mask;
+
+            fresh[j] = s->__slots[i];
+         }
+
+   free(s->__slots);
+
+   s->__elems = elems;
+   s->__slots = fresh;
+   s->__mask = mask;
+   s->__cap = cap;
+
+   return ADDED;
+}
+
+
+/**
+ * Hash an element with a set's hash function, forcing the result nonzero.
+ *
+ * @param s - the set whose hash function to use.
+ * @param elem - the element to hash.
+ * @return the nonzero hash of the element.
+ **/
+static unsigned long __set_hash(set_t* const s, const void* const elem) {
+   unsigned long h;
+
+   h = s->__hash(elem, s->__elem_size);
+
+   return (h ? h : 1);
+}
+
+
+/**
+ * Find the index slot holding an element.
+ *
+ * @param s - the set to search.
+ * @param elem - the element to search for.
+ * @param h - the hash of the element.
+ * @param hole - if not NULL and the element is not found, set to the empty
+ *    slot it would be stored in.
+ * @return the index of the slot holding the element. Returns -1 if the
+ *    element is not in the set.
+ **/
+static ds_idx_t __set_find(set_t* const s, const void* const elem,
+                           unsigned long h, size_t* const hole) {
+   size_t i;
+
+   for(i = h & s->__mask; s->__slots[i].hash; i = (i + 1) & s->__mask)
+      if(s->__slots[i].hash == h &&
+         s->__eq(__SET_ELEM(s, s->__slots[i].pos), elem, s->__elem_size))
+         return (ds_idx_t) i;
+
+   if(hole) *hole = i;
+
+   return -1;
+}
+
+
+/**
+ * Add an element to a set.
+ *
+ * @param s - the set to add the element to.
+ * @param elem - the element to add; it is copied into the set.
+ * @return 1 if the element was added, or 0 if it was already in the set.
+ *    Returns -1 upon allocation error.
+ **/
+static int __set_insert(set_t* const s, const void* const elem) {
+   unsigned long h;
+   size_t hole;
+
+   h = __set_hash(s, elem);
+
+   if(__set_find(s, elem, h, &hole) >= 0) return 0;
+
+   if(s->__size == s->__cap) {
+      if(!__set_resize(s, (s->__mask + 1) << 1)) return -1;
+
+      __set_find(s, elem, h, &hole);
+   }
+
+   memcpy(__SET_ELEM(s, s->__size), elem, s->__elem_size);
+   s->__slots[hole].hash = h;
+   s->__slots[hole].pos = s->__size++;
+
+   return 1;
+}
+
+
+/**
+ * Add an element to a set.
+ *
+ * @param s - the set to add the element to.
+ * @param elem - the element to add; it is copied into the set.
+ * @return 1 if the element was added. Returns 0 if either parameter is NULL,
+ *    if the element is already in the set, or upon allocation error.
+ **/
+int set_add(set_t* const s, void* const elem) {
+   if(!s || !elem) return !ADDED;
+
+   return (__set_insert(s, elem) > 0 ? ADDED : !ADDED);
+}
+
+
+/**
+ * Empty an index slot, shifting back the entries probed past it so that no
+ * tombstone is needed.
+ *
+ * @param s - the set.
+ * @param i - the index of the slot to empty.
+ **/
+static void __set_unslot(set_t* const s, size_t i) {
+   size_t j, home;
+
+   for(j = (i + 1) & s->__mask; s->__slots[j].hash; j = (j + 1) & s->__mask) {
+      home = s->__slots[j].hash & s->__mask;
+
+      /* The entry at j may move to i if i lies between its home and j */
+      if(((j - home) & s->__mask) >= ((j - i) & s->__mask)) {
+         s->__slots[i] = s->__slots[j];
+         i = j;
+      }
+   }
+
+   s->__slots[i].hash = 0;
+}
+
+
+/**
+ * Remove an element from a set. The last element of the set takes its
+ * place.
+ *
+ * @param s - the set to remove the element from.
+ * @param elem - the element to remove.
+ * @return 1 if the element was removed. Returns 0 if it was not in the set or
+ *    if either parameter is NULL.
+ **/
+int set_rem(set_t* const s, void* const elem) {
+   ds_idx_t slot, pos, last;
+   size_t i;
+
+   if(!s || !elem) return !EXIST;
+
+   slot = __set_find(s, elem, __set_hash(s, elem), NULL);
+
+   if(slot < 0) return !EXIST;
+
+   pos = s->__slots[slot].pos;
+   last = s->__size - 1;
+
+   __set_unslot(s, (size_t) slot);
+
+   /* Move the last element into the hole and repoint its slot */
+   if(pos != last) {
+      for(i = __set_hash(s, __SET_ELEM(s, last)) & s->__mask;
+          s->__slots[i].pos != last || !s->__slots[i].hash;
+          i = (i + 1) & s->__mask)
+         ;
+
+      s->__slots[i].pos = pos;
+      memcpy(__SET_ELEM(s, pos), __SET_ELEM(s, last), s->__elem_size);
+   }
+
+   s->__size--;
+
+   return EXIST;
+}
+
+
+/**
+ * Determines if the specified element is contained within a set.
+ *
+ * @param s - the set possibly containing the element.
+ * @param elem - the element to search for.
+ * @return 1 if the element exists in the set. Returns 0 otherwise or if
+ *    either parameter is NULL.
+ **/
+int set_contains(set_t* const s, void* const elem) {
+   if(!s || !elem) return !EXIST;
+
+   return (__set_find(s, elem, __set_hash(s, elem), NULL) >= 0 ? EXIST :
+           !EXIST);
+}
+
+
+/**
+ * Removes all elements from a set. Its capacity is kept.
+ *
+ * @param s - the set to clear.
+ **/
+void set_clear(set_t* const s) {
+   if(!s) return;
+
+   memset(s->__slots, 0, sizeof(__set_slot_t) * (s->__mask + 1));
+   s->__size = 0;
+}
+
+
+/**
+ * Returns a borrowed view of a set's elements, in no particular order. The
+ * view is valid only until the next call that modifies the set, and must not
+ * be freed.
+ *
+ * @param s - the set to view.
+ * @return a view of the set's elements. An empty view is returned if the set
+ *    is NULL.
+ **/
+ds_span_t set_view(set_t* const s) {
+   ds_span_t span;
+
+   span.data = NULL;
+   span.len = 0;
+   span.stride = 0;
+
+   if(!s) return span;
+
+   span.data = s->__elems;
+   span.len = (size_t) s->__size;
+   span.stride = s->__elem_size;
+
+   return span;
+}
+
+
+/** Bulk Set Operations **/
+
+/**
+ * Make an operand of a vector. The vector is read in place; it is not copied
+ * or converted.
+ *
+ * @param v - the vector.
+ * @param sorted - nonzero if the vector is sorted by the cmp callback of the
+ *    ds_ops_t the operation is given, which lets the operation merge instead
+ *    of hashing.
+ * @return the operand.
+ **/
+set_src_t set_src_v(vect_t* const v, int sorted) {
+   set_src_t src;
+
+   src.__c = v;
+   src.__kind = SRC_V;
+   src.__sorted = (sorted ? 1 : 0);
+
+   return src;
+}
+
+
+/**
+ * Make an operand of a list. The list is read in place; it is not copied or
+ * converted.
+ *
+ * @param list - the list.
+ * @param sorted - nonzero if the list is sorted by the cmp callback of the
+ *    ds_ops_t the operation is given.
+ * @return the operand.
+ **/
+set_src_t set_src_ll(llist_t* const list, int sorted) {
+   set_src_t src;
+
+   src.__c = list;
+   src.__kind = SRC_LL;
+   src.__sorted = (sorted ? 1 : 0);
+
+   return src;
+}
+
+
+/**
+ * Make an operand of a set. Sets are probed with their own hash and equality
+ * functions, which must agree with those of the ds_ops_t the operation is
+ * given.
+ *
+ * @param s - the set.
+ * @return the operand.
+ **/
+set_src_t set_src_set(set_t* const s) {
+   set_src_t src;
+
+   src.__c = s;
+   src.__kind = SRC_SET;
+   src.__sorted = 0;
+
+   return src;
+}
+
+
+/**
+ * Retrieve the number of elements of an operand, duplicates included.
+ *
+ * @param src - the operand.
+ * @return the number of elements.
+ **/
+static ds_idx_t __set_len(const set_src_t* const src) {
+   switch(src->__kind) {
+      case SRC_LL:
+         return ((llist_t*) src->__c)->__size;
+
+      case SRC_SET:
+         return ((set_t*) src->__c)->__size;
+
+      default:
+         return ((vect_t*) src->__c)->__size;
+   }
+}
+
+
+/**
+ * Check two operands and retrieve their element size.
+ *
+ * @param a - the first operand.
+ * @param b - the second operand.
+ * @return the size of an element of both operands. Returns 0 if either
+ *    operand is NULL or their element sizes differ.
+ **/
+static size_t __set_elem_size(const set_src_t* const a,
+                              const set_src_t* const b) {
+   const set_src_t *src[2];
+   size_t size[2];
+   int i;
+
+   src[0] = a;
+   src[1] = b;
+
+   for(i = 0; i < 2; i++) {
+      if(!src[i]->__c) return 0;
+
+      switch(src[i]->__kind) {
+         case SRC_LL:
+            size[i] = ((llist_t*) src[i]->__c)->__elem_size;
+            break;
+
+         case SRC_SET:
+            size[i] = ((set_t*) src[i]->__c)->__elem_size;
+            break;
+
+         default:
+            size[i] = ((vect_t*) src[i]->__c)->__elem_size;
+            break;
+      }
+   }
+
+   return (size[0] == size[1] ? size[0] : 0);
+}
+
+
+/**
+ * Start walking an operand from its first element.
+ *
+ * @param cur - the cursor to set up.
+ * @param src - the operand to walk.
+ **/
+static void __set_begin(__set_cur_t* const cur, const set_src_t* const src) {
+   cur->src = *src;
+   cur->pos = 0;
+   cur->node = (src->__kind == SRC_LL ?
+                (__ll_node_t*) ((llist_t*) src->__c)->__first : NULL);
+}
+
+
+/**
+ * Step a cursor to the next element of its operand.
+ *
+ * @param cur - the cursor.
+ * @return the element stepped over. Returns NULL once the end is reached.
+ **/
+static void* __set_next(__set_cur_t* const cur) {
+   vect_t *v;
+   set_t *s;
+   void *elem;
+
+   switch(cur->src.__kind) {
+      case SRC_LL:
+         if(!cur->node) return NULL;
+
+         elem = cur->node->element;
+         cur->node = cur->node->next;
+         return elem;
+
+      case SRC_SET:
+         s = cur->src.__c;
+         return (cur->pos < s->__size ? __SET_ELEM(s, cur->pos++) : NULL);
+
+      default:
+         v = cur->src.__c;
+         return (cur->pos < v->__size ? __SET_VGET(v, cur->pos++) : NULL);
+   }
+}
+
+
+/**
+ * Add every element of an operand to a set.
+ *
+ * @param s - the set to add to.
+ * @param src - the operand.
+ * @return 1 if all elements were added (or already present). Returns 0 upon
+ *    allocation error.
+ **/
+static int __set_fill(set_t* const s, const set_src_t* const src) {
+   __set_cur_t cur;
+   void *elem;
+
+   if(!set_reserve(s, s->__size + __set_len(src))) return !ADDED;
+
+   __set_begin(&cur, src);
+
+   while((elem = __set_next(&cur)))
+      if(__set_insert(s, elem) < 0) return !ADDED;
+
+   return ADDED;
+}
+
+
+/**
+ * Get a set that membership of an operand can be tested in: the operand
+ * itself if it is a set, or else a temporary set of its elements.
+ *
+ * @param src - the operand.
+ * @param ops - the callbacks to hash a temporary set with, or NULL.
+ * @param size - the size of an element.
+ * @param tmp - set to the temporary set, which the caller frees, or NULL.
+ * @return the set to probe. Returns NULL upon allocation error.
+ **/
+static set_t* __set_probe(const set_src_t* const src,
+                          const ds_ops_t* const ops, size_t size,
+                          set_t** const tmp) {
+   *tmp = NULL;
+
+   if(src->__kind == SRC_SET) return src->__c;
+
+   *tmp = __set_init(size, (ops ? ops->hash : NULL), (ops ? ops->eq : NULL));
+
+   if(*tmp && !__set_fill(*tmp, src)) {
+      set_free(*tmp);
+      *tmp = NULL;
+   }
+
+   return *tmp;
+}
+
+
+/**
+ * Copy a set's elements into a new inline vector, and free the set.
+ *
+ * @param s - the set, or NULL.
+ * @return the vector. Returns NULL if the set is NULL or upon allocation
+ *    error.
+ **/
+static vect_t* __set_vect(set_t* const s) {
+   vect_t *v;
+
+   if(!s) return NULL;
+
+   v = __v_init_cap(s->__elem_size, 1, s->__size);
+
+   if(v && !v_append_arr(v, s->__elems, s->__size)) {
+      v_free(v);
+      v = NULL;
+   }
+
+   set_free(s);
+
+   return v;
+}
+
+
+/**
+ * Append an element to a sorted result unless it equals the last element,
+ * which drops the duplicates an operand may hold.
+ *
+ * @param r - the result vector.
+ * @param elem - the element.
+ * @param cmp - the order of the result.
+ * @return 1 if the element was appended or dropped. Returns 0 upon
+ *    allocation error.
+ **/
+static int __set_emit(vect_t* const r, void* const elem, ds_cmp_t cmp) {
+   if(r->__size &&
+      cmp(__SET_VGET(r, r->__size - 1), elem, r->__elem_size) == 0)
+      return ADDED;
+
+   return v_push(r, elem);
+}
+
+
+/**
+ * Find the first element of a sorted vector, from lo onward, that does not
+ * order before a given element. The search gallops: it probes lo, lo + 1,
+ * lo + 3, lo + 7 and so on, then searches the last step by bisection, so a
+ * match i places away costs O(log i) comparisons.
+ *
+ * @param v - the vector, sorted by cmp.
+ * @param lo - the index to start from.
+ * @param elem - the element to search for.
+ * @param cmp - the order of the vector.
+ * @return the index of the first element from lo on that is not less than
+ *    elem, or the size of the vector if there is none.
+ **/
+static ds_idx_t __set_gallop_to(vect_t* const v, ds_idx_t lo,
+                                void* const elem, ds_cmp_t cmp) {
+   ds_idx_t hi, step, mid;
+
+   for(hi = lo, step = 1; hi < v->__size &&
+       cmp(__SET_VGET(v, hi), elem, v->__elem_size) < 0; step <<= 1) {
+      lo = hi + 1;
+      hi = (step > v->__size - hi ? v->__size : hi + step);
+   }
+
+   if(hi > v->__size) hi = v->__size;
+
+   while(lo < hi) {
+      mid = lo + (hi - lo) / 2;
+
+      if(cmp(__SET_VGET(v, mid), elem, v->__elem_size) < 0)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return lo;
+}
+
+
+/**
+ * Walk a sorted operand and look each element up in a much larger sorted
+ * vector by galloping from the previous match. Elements whose presence in b
+ * equals want are appended to r; with r NULL, the walk instead stops at the
+ * first element whose presence differs.
+ *
+ * @param a - the smaller operand, sorted by cmp.
+ * @param b - the larger vector, sorted by cmp.
+ * @param cmp - the order of both operands.
+ * @param want - one (1) to select the elements of a in b, zero (0) for those
+ *    not in b.
+ * @param r - the sorted result, or NULL.
+ * @return 1 if the walk completed. Returns 0 if r is NULL and an element of
+ *    a failed the test, or upon allocation error.
+ **/
+static int __set_gallop(const set_src_t* const a, vect_t* const b,
+                        ds_cmp_t cmp, int want, vect_t* const r) {
+   __set_cur_t cur;
+   ds_idx_t pos;
+   void *elem;
+   int in;
+
+   __set_begin(&cur, a);
+
+   for(pos = 0; (elem = __set_next(&cur)); ) {
+      pos = __set_gallop_to(b, pos, elem, cmp);
+      in = (pos < b->__size &&
+            cmp(__SET_VGET(b, pos), elem, b->__elem_size) == 0);
+
+      if(in != want) {
+         if(!r) return 0;
+      }
+      else if(r && !__set_emit(r, elem, cmp))
+         return 0;
+   }
+
+   return 1;
+}
+
+
+/**
+ * The merging counterpart of __set_gallop(...): walk two sorted operands
+ * side by side, testing each element of a for presence in b.
+ *
+ * @param a - the operand whose elements are tested, sorted by cmp.
+ * @param b - the operand tested against, sorted by cmp.
+ * @param cmp - the order of both operands.
+ * @param want - one (1) to select the elements of a in b, zero (0) for those
+ *    not in b.
+ * @param r - the sorted result, or NULL.
+ * @return 1 if the walk completed. Returns 0 if r is NULL and an element of
+ *    a failed the test, or upon allocation error.
+ **/
+static int __set_merge(const set_src_t* const a, const set_src_t* const b,
+                       ds_cmp_t cmp, int want, vect_t* const r) {
+   __set_cur_t ca, cb;
+   void *x, *y;
+   size_t size;
+   int c, in;
+
+   size = __set_elem_size(a, b);
+
+   __set_begin(&ca, a);
+   __set_begin(&cb, b);
+
+   x = __set_next(&ca);
+   y = __set_next(&cb);
+
+   while(x) {
+      c = (y ? cmp(x, y, size) : -1);
+
+      /* b is behind; duplicates in a still match the same y */
+      if(c > 0) {
+         y = __set_next(&cb);
+         continue;
+      }
+
+      in = (c == 0);
+
+      if(in != want) {
+         if(!r) return 0;
+      }
+      else if(r && !__set_emit(r, x, cmp))
+         return 0;
+
+      x = __set_next(&ca);
+   }
+
+   return 1;
+}
+
+
+/**
+ * Test each element of a sorted operand for presence in another, galloping
+ * through b if it is a vector much larger than a, and merging otherwise. See
+ * __set_merge(...).
+ **/
+static int __set_walk(const set_src_t* const a, const set_src_t* const b,
+                      ds_cmp_t cmp, int want, vect_t* const r) {
+   if(b->__kind == SRC_V && __set_len(a) <= __set_len(b) / GALLOP)
+      return __set_gallop(a, b->__c, cmp, want, r);
+
+   return __set_merge(a, b, cmp, want, r);
+}
+
+
+/**
+ * Compute the union of two operands: every element in either. Operands
+ * flagged sorted (see set_src_v(...)) are merged by ops->cmp and the result
+ * is sorted likewise; otherwise the elements are hashed and the result is in
+ * no particular order. Either way duplicates within an operand are ignored,
+ * so the result holds each element once.
+ *
+ * @param a - the first operand.
+ * @param b - the second operand; its elements must be the size of a's.
+ * @param ops - the callbacks used to order (cmp) or hash and compare (hash,
+ *    eq) elements. May be NULL, or have NULL members, to hash and compare
+ *    elements bytewise.
+ * @return a new inline vector holding a copy of each element of the union.
+ *    Returns NULL if either operand is NULL, their element sizes differ, or
+ *    upon allocation error.
+ **/
+vect_t* set_union(set_src_t a, set_src_t b, const ds_ops_t* const ops) {
+   __set_cur_t ca, cb;
+   vect_t *r;
+   set_t *u;
+   void *x, *y;
+   size_t size;
+   int c, ok;
+
+   size = __set_elem_size(&a, &b);
+
+   if(!size) return NULL;
+
+   if(!__SET_SORTED(a, b, ops)) {
+      u = __set_init(size, (ops ? ops->hash : NULL), (ops ? ops->eq : NULL));
+
+      if(u && (!__set_fill(u, &a) || !__set_fill(u, &b))) {
+         set_free(u);
+         return NULL;
+      }
+
+      return __set_vect(u);
+   }
+
+   r = __v_init_cap(size, 1, __set_len(&a) + __set_len(&b));
+
+   if(!r) return NULL;
+
+   __set_begin(&ca, &a);
+   __set_begin(&cb, &b);
+
+   x = __set_next(&ca);
+   y = __set_next(&cb);
+
+   for(ok = 1; ok && (x || y); ) {
+      c = (!x ? 1 : !y ? -1 : ops->cmp(x, y, size));
+
+      if(c <= 0) {
+         ok = __set_emit(r, x, ops->cmp);
+         x = __set_next(&ca);
+
+         if(c == 0) y = __set_next(&cb);
+      }
+      else {
+         ok = __set_emit(r, y, ops->cmp);
+         y = __set_next(&cb);
+      }
+   }
+
+   if(!ok) {
+      v_free(r);
+      return NULL;
+   }
+
+   return r;
+}
+
+
+/**
+ * Compute the intersection of two operands: every element in both. Operands
+ * flagged sorted are merged by ops->cmp, galloping through the larger when
+ * it is a vector at least GALLOP (8) times the size of the other, and the
+ * result is sorted likewise. Otherwise the smaller operand is hashed (a set
+ * operand is probed directly) and probed with the other, and the result is in
+ * no particular order. The result holds each element once.
+ *
+ * @param a - the first operand.
+ * @param b - the second operand; its elements must be the size of a's.
+ * @param ops - the callbacks to use; see set_union(...).
+ * @return a new inline vector holding a copy of each element of the
+ *    intersection. Returns NULL if either operand is NULL, their element
+ *    sizes differ, or upon allocation error.
+ **/
+vect_t* set_intersect(set_src_t a, set_src_t b, const ds_ops_t* const ops) {
+   const set_src_t *walk, *other;
+   __set_cur_t cur;
+   set_t *probe, *tmp, *r;
+   vect_t *v;
+   void *elem;
+   size_t size;
+   int ok;
+
+   size = __set_elem_size(&a, &b);
+
+   if(!size) return NULL;
+
+   if(__SET_SORTED(a, b, ops)) {
+      /* Walk the smaller operand, galloping through the larger */
+      walk = (__set_len(&a) <= __set_len(&b) ? &a : &b);
+      other = (walk == &a ? &b : &a);
+
+      v = __v_init_cap(size, 1, __set_len(walk));
+
+      if(v && !__set_walk(walk, other, ops->cmp, 1, v)) {
+         v_free(v);
+         v = NULL;
+      }
+
+      return v;
+   }
+
+   /* Probe a set operand if there is one, or else hash the smaller */
+   if(a.__kind == SRC_SET)
+      other = &a;
+   else if(b.__kind == SRC_SET)
+      other = &b;
+   else
+      other = (__set_len(&a) <= __set_len(&b) ? &a : &b);
+
+   walk = (other == &a ? &b : &a);
+
+   probe = __set_probe(other, ops, size, &tmp);
+   r = (probe ? __set_init(size, (ops ? ops->hash : NULL),
+                           (ops ? ops->eq : NULL)) : NULL);
+
+   ok = (r != NULL);
+
+   __set_begin(&cur, walk);
+
+   while(ok && (elem = __set_next(&cur)))
+      if(set_contains(probe, elem))
+         ok = (__set_insert(r, elem) >= 0);
+
+   set_free(tmp);
+
+   if(!ok) {
+      set_free(r);
+      return NULL;
+   }
+
+   return __set_vect(r);
+}
+
+
+/**
+ * Compute the difference of two operands: every element of a that is not in
+ * b. Operands flagged sorted are merged by ops->cmp, galloping through b when
+ * it is a vector at least GALLOP (8) times the size of a, and the result is
+ * sorted likewise. Otherwise b is hashed (or probed directly if it is a set)
+ * and the result is in no particular order. The result holds each element
+ * once.
+ *
+ * @param a - the operand to take elements from.
+ * @param b - the operand of elements to leave out; its elements must be the
+ *    size of a's.
+ * @param ops - the callbacks to use; see set_union(...).
+ * @return a new inline vector holding a copy of each element of the
+ *    difference. Returns NULL if either operand is NULL, their element sizes
+ *    differ, or upon allocation error.
+ **/
+vect_t* set_difference(set_src_t a, set_src_t b, const ds_ops_t* const ops) {
+   __set_cur_t cur;
+   set_t *probe, *tmp, *r;
+   vect_t *v;
+   void *elem;
+   size_t size;
+   int ok;
+
+   size = __set_elem_size(&a, &b);
+
+   if(!size) return NULL;
+
+   if(__SET_SORTED(a, b, ops)) {
+      v = __v_init_cap(size, 1, __set_len(&a));
+
+      if(v && !__set_walk(&a, &b, ops->cmp, 0, v)) {
+         v_free(v);
+         v = NULL;
+      }
+
+      return v;
+   }
+
+   probe = __set_probe(&b, ops, size, &tmp);
+   r = (probe ? __set_init(size, (ops ? ops->hash : NULL),
+                           (ops ? ops->eq : NULL)) : NULL);
+
+   ok = (r != NULL);
+
+   __set_begin(&cur, &a);
+
+   while(ok && (elem = __set_next(&cur)))
+      if(!set_contains(probe, elem))
+         ok = (__set_insert(r, elem) >= 0);
+
+   set_free(tmp);
+
+   if(!ok) {
+      set_free(r);
+      return NULL;
+   }
+
+   return __set_vect(r);
+}
+
+
+/**
+ * Determines if every element of a is also in b. Operands flagged sorted are
+ * merged by ops->cmp, galloping through b when it is a vector at least
+ * GALLOP (8) times the size of a; otherwise b is hashed (or probed directly
+ * if it is a set).
+ *
+ * @param a - the operand that may be the subset.
+ * @param b - the operand that may be the superset; its elements must be the
+ *    size of a's.
+ * @param ops - the callbacks to use; see set_union(...).
+ * @return 1 if a is a subset of b, or 0 if it is not. Returns -1 if either
+ *    operand is NULL, their element sizes differ, or upon allocation error.
+ **/
+int set_is_subset(set_src_t a, set_src_t b, const ds_ops_t* const ops) {
+   __set_cur_t cur;
+   set_t *probe, *tmp;
+   void *elem;
+   size_t size;
+   int subset;
+
+   size = __set_elem_size(&a, &b);
+
+   if(!size) return -1;
+
+   /* Sets hold no duplicates, so a larger set cannot be a subset */
+   if(a.__kind == SRC_SET && b.__kind == SRC_SET &&
+      __set_len(&a) > __set_len(&b))
+      return 0;
+
+   if(__SET_SORTED(a, b, ops))
+      return __set_walk(&a, &b, ops->cmp, 1, NULL);
+
+   probe = __set_probe(&b, ops, size, &tmp);
+
+   if(!probe) return -1;
+
+   subset = 1;
+
+   __set_begin(&cur, &a);
+
+   while(subset && (elem = __set_next(&cur)))
+      subset = set_contains(probe, elem);
+
+   set_free(tmp);
+
+   return subset;
+}
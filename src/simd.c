@@ -0,0 +1,760 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#define _POSIX_C_SOURCE 200112L  /* For pthread_once(...) */
+
+#include <pthread.h>    /* For pthread_once(...) */
+#include <stdint.h>     /* For int32_t, uint32_t, uint64_t */
+#include <string.h>     /* For memcpy(...) */
+#include "simd.h"
+
+#if !defined(DSTRUCTS_NO_SIMD) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define DS_SIMD_X86
+#include <immintrin.h>  /* For SSE2 and AVX2 intrinsics */
+#elif !defined(DSTRUCTS_NO_SIMD) && defined(__GNUC__) && defined(__ARM_NEON)
+#define DS_SIMD_NEON
+#include <arm_neon.h>   /* For NEON intrinsics */
+#endif
+
+
+/* Kernel signatures */
+typedef int (*__find_t)(const void* arr, int n, const void* key);
+typedef void (*__ext_t)(const void* arr, int n, int flags, uint32_t* out);
+
+
+/* Local functions */
+static void __simd_resolve(void);
+
+static int __find32_c(const void* arr, int n, const void* key);
+static int __find64_c(const void* arr, int n, const void* key);
+static int __count32_c(const void* arr, int n, const void* key);
+static int __count64_c(const void* arr, int n, const void* key);
+static void __ext32_c(const void* arr, int n, int flags, uint32_t* out);
+
+
+/**
+ * The kernels in use. They start out as the portable kernels and are
+ * replaced by __simd_resolve(...), which runs once, through __resolved, on
+ * first use; pthread_once(...) makes its stores visible to every thread that
+ * passes through it.
+ **/
+static __find_t __find32 = __find32_c;
+static __find_t __find64 = __find64_c;
+static __find_t __count32 = __count32_c;
+static __find_t __count64 = __count64_c;
+static __ext_t __ext32 = __ext32_c;
+
+static pthread_once_t __resolved = PTHREAD_ONCE_INIT;
+
+
+/* Order two 32-bit values as the flags say */
+#define __EXT_BETTER(x, y, flags) \
+   ((flags) & DS_SIMD_UNSIGNED ? \
+      ((flags) & DS_SIMD_MAX ? (x) > (y) : (x) < (y)) : \
+      ((flags) & DS_SIMD_MAX ? (int32_t) (x) > (int32_t) (y) : \
+                               (int32_t) (x) < (int32_t) (y)))
+
+
+/** Portable kernels **/
+
+/**
+ * Find the first 32-bit element equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to search for.
+ * @return the index of the first match, or -1 if there is none.
+ **/
+static int __find32_c(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   uint32_t k;
+   int i;
+
+   a = arr;
+   memcpy(&k, key, sizeof(k));
+
+   for(i = 0; i < n; i++)
+      if(a[i] == k) return i;
+
+   return -1;
+}
+
+
+/**
+ * Find the first 64-bit element equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to search for.
+ * @return the index of the first match, or -1 if there is none.
+ **/
+static int __find64_c(const void* arr, int n, const void* key) {
+   const uint64_t *a;
+   uint64_t k;
+   int i;
+
+   a = arr;
+   memcpy(&k, key, sizeof(k));
+
+   for(i = 0; i < n; i++)
+      if(a[i] == k) return i;
+
+   return -1;
+}
+
+
+/**
+ * Count the 32-bit elements equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to count.
+ * @return the number of matches.
+ **/
+static int __count32_c(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   uint32_t k;
+   int i, count;
+
+   a = arr;
+   memcpy(&k, key, sizeof(k));
+   count = 0;
+
+   for(i = 0; i < n; i++)
+      count += (a[i] == k);
+
+   return count;
+}
+
+
+/**
+ * Count the 64-bit elements equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to count.
+ * @return the number of matches.
+ **/
+static int __count64_c(const void* arr, int n, const void* key) {
+   const uint64_t *a;
+   uint64_t k;
+   int i, count;
+
+   a = arr;
+   memcpy(&k, key, sizeof(k));
+   count = 0;
+
+   for(i = 0; i < n; i++)
+      count += (a[i] == k);
+
+   return count;
+}
+
+
+/**
+ * Find the least (or greatest) 32-bit element.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements; at least one (1).
+ * @param flags - DS_SIMD_MAX and/or DS_SIMD_UNSIGNED.
+ * @param out - set to the extreme value.
+ **/
+static void __ext32_c(const void* arr, int n, int flags, uint32_t* out) {
+   const uint32_t *a;
+   uint32_t best;
+   int i;
+
+   a = arr;
+   best = a[0];
+
+   for(i = 1; i < n; i++)
+      if(__EXT_BETTER(a[i], best, flags))
+         best = a[i];
+
+   *out = best;
+}
+
+
+#ifdef DS_SIMD_X86
+
+/**
+ * x86 kernels. Both the SSE2 and the AVX2 versions are compiled for their
+ * instruction set with a target attribute, independent of the flags the
+ * library is built with, and picked at run time with __builtin_cpu_supports.
+ * Tails shorter than a vector finish in the portable kernels.
+ **/
+
+#define __SSE2 __attribute__((target("sse2")))
+#define __AVX2 __attribute__((target("avx2")))
+
+
+/* SSE2 has no 64-bit compare; a lane matches when both of its halves do */
+#define __SSE2_EQ64(x, k) \
+   (_mm_and_si128(_mm_cmpeq_epi32((x), (k)), \
+                  _mm_shuffle_epi32(_mm_cmpeq_epi32((x), (k)), 0xb1)))
+
+
+__SSE2 static int __find32_sse2(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   __m128i k;
+   uint32_t u;
+   int i, m, r;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm_set1_epi32((int) u);
+
+   for(i = 0; i + 4 <= n; i += 4) {
+      m = _mm_movemask_epi8(
+             _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*) (a + i)), k));
+
+      if(m) return i + (__builtin_ctz(m) >> 2);
+   }
+
+   r = __find32_c(a + i, n - i, key);
+   return (r < 0 ? r : i + r);
+}
+
+
+__SSE2 static int __find64_sse2(const void* arr, int n, const void* key) {
+   const uint64_t *a;
+   __m128i k, x;
+   uint64_t u;
+   int i, m, r;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm_set_epi32((int) (u >> 32), (int) u, (int) (u >> 32), (int) u);
+
+   for(i = 0; i + 2 <= n; i += 2) {
+      x = _mm_loadu_si128((const __m128i*) (a + i));
+      m = _mm_movemask_epi8(__SSE2_EQ64(x, k));
+
+      if(m) return i + (__builtin_ctz(m) >> 3);
+   }
+
+   r = __find64_c(a + i, n - i, key);
+   return (r < 0 ? r : i + r);
+}
+
+
+__SSE2 static int __count32_sse2(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   __m128i k, acc;
+   uint32_t u, lanes[4];
+   int i;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm_set1_epi32((int) u);
+   acc = _mm_setzero_si128();
+
+   /* A match is all ones, or -1; subtracting it counts it */
+   for(i = 0; i + 4 <= n; i += 4)
+      acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(
+               _mm_loadu_si128((const __m128i*) (a + i)), k));
+
+   _mm_storeu_si128((__m128i*) lanes, acc);
+
+   return (int) (lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+          __count32_c(a + i, n - i, key);
+}
+
+
+__SSE2 static int __count64_sse2(const void* arr, int n, const void* key) {
+   const uint64_t *a;
+   __m128i k, x, acc;
+   uint64_t u, lanes[2];
+   int i;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm_set_epi32((int) (u >> 32), (int) u, (int) (u >> 32), (int) u);
+   acc = _mm_setzero_si128();
+
+   for(i = 0; i + 2 <= n; i += 2) {
+      x = _mm_loadu_si128((const __m128i*) (a + i));
+      acc = _mm_sub_epi64(acc, __SSE2_EQ64(x, k));
+   }
+
+   _mm_storeu_si128((__m128i*) lanes, acc);
+
+   return (int) (lanes[0] + lanes[1]) + __count64_c(a + i, n - i, key);
+}
+
+
+__SSE2 static void __ext32_sse2(const void* arr, int n, int flags,
+                                uint32_t* out) {
+   const uint32_t *a;
+   __m128i best, x, bias, m;
+   uint32_t lanes[4];
+   int i;
+
+   if(n < 4) {
+      __ext32_c(arr, n, flags, out);
+      return;
+   }
+
+   a = arr;
+
+   /* SSE2 only compares signed; bias unsigned values into signed order */
+   bias = _mm_set1_epi32((flags & DS_SIMD_UNSIGNED) ? (int) 0x80000000U : 0);
+   best = _mm_xor_si128(_mm_loadu_si128((const __m128i*) a), bias);
+
+   for(i = 4; i + 4 <= n; i += 4) {
+      x = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (a + i)), bias);
+      m = ((flags & DS_SIMD_MAX) ? _mm_cmpgt_epi32(x, best) :
+           _mm_cmplt_epi32(x, best));
+      best = _mm_or_si128(_mm_and_si128(m, x), _mm_andnot_si128(m, best));
+   }
+
+   _mm_storeu_si128((__m128i*) lanes, _mm_xor_si128(best, bias));
+
+   /* Reduce the lanes together with the tail */
+   __ext32_c(lanes, 4, flags, out);
+
+   if(i < n) {
+      __ext32_c(a + i, n - i, flags, &lanes[0]);
+
+      if(__EXT_BETTER(lanes[0], *out, flags))
+         *out = lanes[0];
+   }
+}
+
+
+__AVX2 static int __find32_avx2(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   __m256i k;
+   uint32_t u;
+   int i, m, r;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm256_set1_epi32((int) u);
+
+   for(i = 0; i + 8 <= n; i += 8) {
+      m = _mm256_movemask_epi8(_mm256_cmpeq_epi32(
+             _mm256_loadu_si256((const __m256i*) (a + i)), k));
+
+      if(m) return i + (__builtin_ctz((unsigned) m) >> 2);
+   }
+
+   r = __find32_c(a + i, n - i, key);
+   return (r < 0 ? r : i + r);
+}
+
+
+__AVX2 static int __find64_avx2(const void* arr, int n, const void* key) {
+   const uint64_t *a;
+   __m256i k;
+   uint64_t u;
+   int i, m, r;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm256_set1_epi64x((long long) u);
+
+   for(i = 0; i + 4 <= n; i += 4) {
+      m = _mm256_movemask_epi8(_mm256_cmpeq_epi64(
+             _mm256_loadu_si256((const __m256i*) (a + i)), k));
+
+      if(m) return i + (__builtin_ctz((unsigned) m) >> 3);
+   }
+
+   r = __find64_c(a + i, n - i, key);
+   return (r < 0 ? r : i + r);
+}
+
+
+__AVX2 static int __count32_avx2(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   __m256i k, acc;
+   uint32_t u, lanes[8];
+   int i, count;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm256_set1_epi32((int) u);
+   acc = _mm256_setzero_si256();
+
+   for(i = 0; i + 8 <= n; i += 8)
+      acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(
+               _mm256_loadu_si256((const __m256i*) (a + i)), k));
+
+   _mm256_storeu_si256((__m256i*) lanes, acc);
+
+   for(count = 0, u = 0; u < 8; u++)
+      count += (int) lanes[u];
+
+   return count + __count32_c(a + i, n - i, key);
+}
+
+
+__AVX2 static int __count64_avx2(const void* arr, int n, const void* key) {
+   const uint64_t *a;
+   __m256i k, acc;
+   uint64_t u, lanes[4];
+   int i;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = _mm256_set1_epi64x((long long) u);
+   acc = _mm256_setzero_si256();
+
+   for(i = 0; i + 4 <= n; i += 4)
+      acc = _mm256_sub_epi64(acc, _mm256_cmpeq_epi64(
+               _mm256_loadu_si256((const __m256i*) (a + i)), k));
+
+   _mm256_storeu_si256((__m256i*) lanes, acc);
+
+   return (int) (lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+          __count64_c(a + i, n - i, key);
+}
+
+
+__AVX2 static void __ext32_avx2(const void* arr, int n, int flags,
+                                uint32_t* out) {
+   const uint32_t *a;
+   __m256i best, x;
+   uint32_t lanes[8];
+   int i;
+
+   if(n < 8) {
+      __ext32_c(arr, n, flags, out);
+      return;
+   }
+
+   a = arr;
+   best = _mm256_loadu_si256((const __m256i*) a);
+
+   for(i = 8; i + 8 <= n; i += 8) {
+      x = _mm256_loadu_si256((const __m256i*) (a + i));
+
+      switch(flags & (DS_SIMD_MAX | DS_SIMD_UNSIGNED)) {
+         case 0:
+            best = _mm256_min_epi32(best, x);
+            break;
+         case DS_SIMD_MAX:
+            best = _mm256_max_epi32(best, x);
+            break;
+         case DS_SIMD_UNSIGNED:
+            best = _mm256_min_epu32(best, x);
+            break;
+         default:
+            best = _mm256_max_epu32(best, x);
+            break;
+      }
+   }
+
+   _mm256_storeu_si256((__m256i*) lanes, best);
+
+   /* Reduce the lanes together with the tail */
+   __ext32_c(lanes, 8, flags, out);
+
+   if(i < n) {
+      __ext32_c(a + i, n - i, flags, &lanes[0]);
+
+      if(__EXT_BETTER(lanes[0], *out, flags))
+         *out = lanes[0];
+   }
+}
+
+#endif   /* DS_SIMD_X86 */
+
+
+#ifdef DS_SIMD_NEON
+
+/**
+ * NEON kernels. NEON is part of every AArch64 CPU and of the ARMv7 targets
+ * that define __ARM_NEON, so no run time check is needed. A compare result is
+ * narrowed to 16 bits per 32-bit lane to test and locate matches through a
+ * single 64-bit scalar.
+ **/
+
+/* NEON on ARMv7 has no 64-bit compare; a lane matches when both halves do */
+#define __NEON_EQ64(x, k) \
+   (vandq_u32(vceqq_u32((x), (k)), vrev64q_u32(vceqq_u32((x), (k)))))
+
+/* Narrow a 32-bit lane mask to a 64-bit scalar, 16 bits per lane */
+#define __NEON_BITS(m) \
+   (vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(m)), 0))
+
+
+static int __find32_neon(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   uint32x4_t k;
+   uint64_t bits;
+   uint32_t u;
+   int i, r;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = vdupq_n_u32(u);
+
+   for(i = 0; i + 4 <= n; i += 4) {
+      bits = __NEON_BITS(vceqq_u32(vld1q_u32(a + i), k));
+
+      if(bits) return i + (__builtin_ctzll(bits) >> 4);
+   }
+
+   r = __find32_c(a + i, n - i, key);
+   return (r < 0 ? r : i + r);
+}
+
+
+static int __find64_neon(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   uint32x4_t k;
+   uint64_t bits, u;
+   int i, r;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = vreinterpretq_u32_u64(vdupq_n_u64(u));
+
+   for(i = 0; i + 2 <= n; i += 2) {
+      bits = __NEON_BITS(__NEON_EQ64(vld1q_u32(a + 2 * i), k));
+
+      if(bits) return i + (__builtin_ctzll(bits) >> 5);
+   }
+
+   r = __find64_c(a + 2 * i, n - i, key);
+   return (r < 0 ? r : i + r);
+}
+
+
+static int __count32_neon(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   uint32x4_t k, acc;
+   uint32_t u;
+   int i;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = vdupq_n_u32(u);
+   acc = vdupq_n_u32(0);
+
+   for(i = 0; i + 4 <= n; i += 4)
+      acc = vsubq_u32(acc, vceqq_u32(vld1q_u32(a + i), k));
+
+   return (int) (vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) +
+                 vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3)) +
+          __count32_c(a + i, n - i, key);
+}
+
+
+static int __count64_neon(const void* arr, int n, const void* key) {
+   const uint32_t *a;
+   uint32x4_t k;
+   uint64x2_t acc;
+   uint64_t u;
+   int i;
+
+   a = arr;
+   memcpy(&u, key, sizeof(u));
+   k = vreinterpretq_u32_u64(vdupq_n_u64(u));
+   acc = vdupq_n_u64(0);
+
+   for(i = 0; i + 2 <= n; i += 2)
+      acc = vsubq_u64(acc, vreinterpretq_u64_u32(
+               __NEON_EQ64(vld1q_u32(a + 2 * i), k)));
+
+   return (int) (vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1)) +
+          __count64_c(a + 2 * i, n - i, key);
+}
+
+
+static void __ext32_neon(const void* arr, int n, int flags, uint32_t* out) {
+   const uint32_t *a;
+   uint32x4_t best, x;
+   uint32_t lanes[4];
+   int i;
+
+   if(n < 4) {
+      __ext32_c(arr, n, flags, out);
+      return;
+   }
+
+   a = arr;
+   best = vld1q_u32(a);
+
+   for(i = 4; i + 4 <= n; i += 4) {
+      x = vld1q_u32(a + i);
+
+      switch(flags & (DS_SIMD_MAX | DS_SIMD_UNSIGNED)) {
+         case 0:
+            best = vreinterpretq_u32_s32(vminq_s32(vreinterpretq_s32_u32(best),
+                                                   vreinterpretq_s32_u32(x)));
+            break;
+         case DS_SIMD_MAX:
+            best = vreinterpretq_u32_s32(vmaxq_s32(vreinterpretq_s32_u32(best),
+                                                   vreinterpretq_s32_u32(x)));
+            break;
+         case DS_SIMD_UNSIGNED:
+            best = vminq_u32(best, x);
+            break;
+         default:
+            best = vmaxq_u32(best, x);
+            break;
+      }
+   }
+
+   vst1q_u32(lanes, best);
+
+   /* Reduce the lanes together with the tail */
+   __ext32_c(lanes, 4, flags, out);
+
+   if(i < n) {
+      __ext32_c(a + i, n - i, flags, &lanes[0]);
+
+      if(__EXT_BETTER(lanes[0], *out, flags))
+         *out = lanes[0];
+   }
+}
+
+#endif   /* DS_SIMD_NEON */
+
+
+/**
+ * Pick the fastest kernels the running CPU supports.
+ **/
+static void __simd_resolve(void) {
+   __find_t find32, find64, count32, count64;
+   __ext_t ext32;
+
+   find32 = __find32_c;
+   find64 = __find64_c;
+   count32 = __count32_c;
+   count64 = __count64_c;
+   ext32 = __ext32_c;
+
+#ifdef DS_SIMD_X86
+   __builtin_cpu_init();
+
+   if(__builtin_cpu_supports("avx2")) {
+      find32 = __find32_avx2;
+      find64 = __find64_avx2;
+      count32 = __count32_avx2;
+      count64 = __count64_avx2;
+      ext32 = __ext32_avx2;
+   }
+   else if(__builtin_cpu_supports("sse2")) {
+      find32 = __find32_sse2;
+      find64 = __find64_sse2;
+      count32 = __count32_sse2;
+      count64 = __count64_sse2;
+      ext32 = __ext32_sse2;
+   }
+#endif
+
+#ifdef DS_SIMD_NEON
+   find32 = __find32_neon;
+   find64 = __find64_neon;
+   count32 = __count32_neon;
+   count64 = __count64_neon;
+   ext32 = __ext32_neon;
+#endif
+
+   __find32 = find32;
+   __find64 = find64;
+   __count32 = count32;
+   __count64 = count64;
+   __ext32 = ext32;
+}
+
+
+/**
+ * Find the first 32-bit element equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to search for.
+ * @return the index of the first match, or -1 if there is none.
+ **/
+int __ds_simd_find32(const void* arr, int n, const void* key) {
+   pthread_once(&__resolved, __simd_resolve);
+
+   return (__find32)(arr, n, key);
+}
+
+
+/**
+ * Find the first 64-bit element equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to search for.
+ * @return the index of the first match, or -1 if there is none.
+ **/
+int __ds_simd_find64(const void* arr, int n, const void* key) {
+   pthread_once(&__resolved, __simd_resolve);
+
+   return (__find64)(arr, n, key);
+}
+
+
+/**
+ * Count the 32-bit elements equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to count.
+ * @return the number of matches.
+ **/
+int __ds_simd_count32(const void* arr, int n, const void* key) {
+   pthread_once(&__resolved, __simd_resolve);
+
+   return (__count32)(arr, n, key);
+}
+
+
+/**
+ * Count the 64-bit elements equal to key.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param key - the element to count.
+ * @return the number of matches.
+ **/
+int __ds_simd_count64(const void* arr, int n, const void* key) {
+   pthread_once(&__resolved, __simd_resolve);
+
+   return (__count64)(arr, n, key);
+}
+
+
+/**
+ * Find the first least (or greatest) 32-bit element.
+ *
+ * @param arr - the elements to search.
+ * @param n - the number of elements.
+ * @param flags - DS_SIMD_MAX and/or DS_SIMD_UNSIGNED.
+ * @return the index of the first extreme element, or -1 if n is zero (0).
+ **/
+int __ds_simd_ext32(const void* arr, int n, int flags) {
+   uint32_t best;
+
+   if(n <= 0) return -1;
+
+   pthread_once(&__resolved, __simd_resolve);
+
+   (__ext32)(arr, n, flags, &best);
+
+   return (__find32)(arr, n, &best);
+}
@@ -0,0 +1,42 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_SIMD_H__
+#define __LIBDSTRUCTS_SIMD_H__   /* Guard against multiple inclusion */
+
+/**
+ * Internal header for the vectorized search kernels. Not installed.
+ *
+ * Each kernel scans a contiguous array of n 4-byte (32) or 8-byte (64)
+ * integers. The best implementation for the running CPU (AVX2, SSE2, NEON or
+ * plain C) is chosen on first use. Kernels compare bit patterns, so they only
+ * serve integer element kinds; floating point keys use the scalar loops.
+ **/
+
+/* Flags for __ds_simd_ext32(...) */
+#define DS_SIMD_MAX        1  /* Find the maximum rather than the minimum */
+#define DS_SIMD_UNSIGNED   2  /* Order elements as unsigned integers */
+
+
+extern   int   __ds_simd_find32  (const void* arr, int n, const void* key);
+extern   int   __ds_simd_find64  (const void* arr, int n, const void* key);
+extern   int   __ds_simd_count32 (const void* arr, int n, const void* key);
+extern   int   __ds_simd_count64 (const void* arr, int n, const void* key);
+extern   int   __ds_simd_ext32   (const void* arr, int n, int flags);
+
+#endif   /* __LIBDSTRUCTS_SIMD_H__ */
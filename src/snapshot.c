@@ -0,0 +1,249 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#define _POSIX_C_SOURCE 200112L  /* For fileno(...), fsync(...) */
+
+#include <stdlib.h>     /* For malloc(...), free(...) */
+#include <string.h>     /* For memcmp(...), memcpy(...), memset(...) */
+#include <sys/types.h>
+#include <sys/stat.h>   /* For fstat(...) */
+#include <sys/mman.h>   /* For mmap(...), munmap(...) */
+#include <fcntl.h>      /* For open(...) */
+#include <unistd.h>     /* For close(...), fsync(...), read(...) */
+#include "snapshot.h"
+
+#define SUFFIX ".tmp"   /* Appended to the path while a snapshot is written */
+
+/* 64-bit FNV-1a parameters, assembled from halves to stay within C89 */
+#define FNV_BASIS (((uint64_t) 0xcbf29ce4UL << 32) | 0x84222325UL)
+#define FNV_PRIME (((uint64_t) 0x00000100UL << 32) | 0x000001b3UL)
+
+/* Fails to compile unless the header is exactly 64 bytes */
+typedef char __ds_snap_size_check[sizeof(__ds_snap_hdr_t) == 64 ? 1 : -1];
+
+
+static uint64_t __ds_snap_hash(uint64_t h, const unsigned char *p, size_t n);
+static int __ds_snap_valid(const __ds_snap_hdr_t* const hdr, size_t elem_size,
+                           uint64_t file_size);
+
+
+/**
+ * Extend a 64-bit FNV-1a hash over n bytes.
+ *
+ * @param h - the hash so far, or FNV_BASIS to start a new one.
+ * @param p - the bytes to hash.
+ * @param n - the number of bytes.
+ * @return the extended hash.
+ **/
+static uint64_t __ds_snap_hash(uint64_t h, const unsigned char *p, size_t n) {
+   while(n--) {
+      h ^= *p++;
+      h *= FNV_PRIME;
+   }
+
+   return h;
+}
+
+
+/**
+ * Begin writing a snapshot of count elements of elem_size bytes each. The
+ * elements are then written with __ds_snap_put(...), and the snapshot
+ * finished with __ds_snap_close(...).
+ *
+ * @param s - the snapshot to begin.
+ * @param path - the file to write; it must outlive the snapshot.
+ * @param elem_size - the size of an element in bytes.
+ * @param count - the number of elements that will be written.
+ * @return 1 if the snapshot was begun. Returns 0 if path is NULL, elem_size
+ *    is zero (0), count is negative, or the temporary file cannot be
+ *    created.
+ **/
+int __ds_snap_open(__ds_snap_t* const s, const char* path, size_t elem_size,
+                   ds_idx_t count) {
+   size_t len;
+
+   if(!path || !elem_size || count < 0) return 0;
+
+   len = strlen(path);
+
+   s->__tmp = malloc(len + sizeof(SUFFIX));
+
+   if(!s->__tmp) return 0;
+
+   memcpy(s->__tmp, path, len);
+   memcpy(s->__tmp + len, SUFFIX, sizeof(SUFFIX));
+
+   s->__file = fopen(s->__tmp, "wb");
+
+   if(!s->__file) {
+      free(s->__tmp);
+      return 0;
+   }
+
+   s->__path = path;
+
+   memset(&s->__hdr, 0, sizeof(__ds_snap_hdr_t));
+   memcpy(s->__hdr.magic, DS_SNAP_MAGIC, sizeof(s->__hdr.magic));
+   s->__hdr.version = DS_SNAP_VERSION;
+   s->__hdr.order = DS_SNAP_ORDER;
+   s->__hdr.elem_size = elem_size;
+   s->__hdr.count = (uint64_t) count;
+   s->__hdr.checksum = FNV_BASIS;
+
+   /* Rewritten with the final checksum by __ds_snap_close(...) */
+   fwrite(&s->__hdr, sizeof(__ds_snap_hdr_t), 1, s->__file);
+
+   return 1;
+}
+
+
+/**
+ * Append n elements, stored back to back, to a snapshot. Errors are caught
+ * by __ds_snap_close(...).
+ *
+ * @param s - the snapshot to append to.
+ * @param elems - the elements to append.
+ * @param n - the number of elements.
+ **/
+void __ds_snap_put(__ds_snap_t* const s, const void* elems, size_t n) {
+   size_t bytes;
+
+   if(!n) return;
+
+   bytes = n * (size_t) s->__hdr.elem_size;
+
+   s->__hdr.checksum = __ds_snap_hash(s->__hdr.checksum, elems, bytes);
+   fwrite(elems, 1, bytes, s->__file);
+}
+
+
+/**
+ * Finish a snapshot: write the padding and the final header, flush the file
+ * to disk, and rename it over the destination. Upon any error the temporary
+ * file is removed and the destination left untouched.
+ *
+ * @param s - the snapshot to finish.
+ * @return 1 if the snapshot was written. Returns 0 upon I/O error.
+ **/
+int __ds_snap_close(__ds_snap_t* const s) {
+   uint64_t i;
+   int ok;
+
+   for(i = 0; i < s->__hdr.elem_size; i++)
+      putc(0, s->__file);
+
+   ok = (fseek(s->__file, 0L, SEEK_SET) == 0 &&
+         fwrite(&s->__hdr, sizeof(__ds_snap_hdr_t), 1, s->__file) == 1 &&
+         fflush(s->__file) == 0 && !ferror(s->__file) &&
+         fsync(fileno(s->__file)) == 0);
+
+   if(fclose(s->__file) != 0) ok = 0;
+
+   if(ok && rename(s->__tmp, s->__path) != 0) ok = 0;
+
+   if(!ok) remove(s->__tmp);
+
+   free(s->__tmp);
+
+   return ok;
+}
+
+
+/**
+ * Check a snapshot's header against the element size expected and the size
+ * of its file.
+ *
+ * @param hdr - the header to check.
+ * @param elem_size - the element size expected.
+ * @param file_size - the size of the file in bytes.
+ * @return 1 if the header describes a snapshot this build can map. Returns 0
+ *    otherwise.
+ **/
+static int __ds_snap_valid(const __ds_snap_hdr_t* const hdr, size_t elem_size,
+                           uint64_t file_size) {
+   if(memcmp(hdr->magic, DS_SNAP_MAGIC, sizeof(hdr->magic)) ||
+      hdr->version != DS_SNAP_VERSION || hdr->order != DS_SNAP_ORDER ||
+      hdr->elem_size != elem_size || !elem_size)
+      return 0;
+
+   /* The elements and padding must be addressable as a single buffer */
+   if(hdr->count > (uint64_t) DS_IDX_MAX ||
+      hdr->count >= (SIZE_MAX - sizeof(__ds_snap_hdr_t)) / elem_size)
+      return 0;
+
+   return (file_size == sizeof(__ds_snap_hdr_t) +
+           (hdr->count + 1) * (uint64_t) elem_size);
+}
+
+
+/**
+ * Map a snapshot into memory. The mapping is private and copy-on-write: its
+ * pages are shared with every other process mapping the same file until
+ * written to, and writes never reach the file.
+ *
+ * @param path - the file to map.
+ * @param elem_size - the element size the snapshot must have.
+ * @param verify - nonzero to check the elements against the checksum, which
+ *    reads the whole file.
+ * @param count - set to the number of elements in the snapshot.
+ * @param len - set to the length of the mapping.
+ * @return the start of the mapping, where the header is; the elements follow
+ *    it. Returns NULL if the file cannot be read or mapped, is not a
+ *    snapshot of elem_size elements, or fails verification.
+ **/
+char* __ds_snap_map(const char* path, size_t elem_size, int verify,
+                    ds_idx_t* count, size_t* len) {
+   __ds_snap_hdr_t hdr;
+   struct stat st;
+   char *base;
+   int fd;
+
+   if(!path) return NULL;
+
+   fd = open(path, O_RDONLY);
+
+   if(fd < 0) return NULL;
+
+   if(fstat(fd, &st) != 0 ||
+      read(fd, &hdr, sizeof(hdr)) != (ssize_t) sizeof(hdr) ||
+      !__ds_snap_valid(&hdr, elem_size, (uint64_t) st.st_size)) {
+      close(fd);
+      return NULL;
+   }
+
+   base = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+               fd, 0);
+
+   /* The mapping holds its own reference to the file */
+   close(fd);
+
+   if(base == MAP_FAILED) return NULL;
+
+   if(verify && __ds_snap_hash(FNV_BASIS,
+                               (unsigned char*) base + sizeof(hdr),
+                               (size_t) hdr.count * elem_size) !=
+      hdr.checksum) {
+      munmap(base, (size_t) st.st_size);
+      return NULL;
+   }
+
+   *count = (ds_idx_t) hdr.count;
+   *len = (size_t) st.st_size;
+
+   return base;
+}
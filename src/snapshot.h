@@ -0,0 +1,76 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#ifndef __LIBDSTRUCTS_SNAPSHOT_H__
+#define __LIBDSTRUCTS_SNAPSHOT_H__   /* Guard against multiple inclusion */
+
+/**
+ * Internal header for the snapshot format written by v_save(...),
+ * ll_save(...) and q_save(...) and mapped by v_open_mmap(...). Not
+ * installed.
+ *
+ * A snapshot is a 64-byte header followed by count elements of elem_size
+ * bytes each, back to back, and one zeroed element of padding (the scratch
+ * slot an inline vector keeps past its capacity). All fields are in host byte
+ * order; the order field tells a snapshot from another architecture apart.
+ * The checksum is the 64-bit FNV-1a hash of the count elements.
+ **/
+
+#include <stdio.h>      /* For FILE */
+#include <stdint.h>     /* For uint32_t, uint64_t */
+#include "index.h"      /* For ds_idx_t */
+
+#define DS_SNAP_MAGIC "dstructs"
+#define DS_SNAP_VERSION 1
+#define DS_SNAP_ORDER 0x01020304UL
+
+
+/* The header at the start of every snapshot; exactly 64 bytes */
+typedef struct __ds_snap_hdr_s {
+   char magic[8];
+   uint32_t version;
+   uint32_t order;
+   uint64_t elem_size;
+   uint64_t count;
+   uint64_t checksum;
+   uint64_t reserved[3];
+} __ds_snap_hdr_t;
+
+
+/**
+ * A snapshot being written. Elements go to a temporary file next to the
+ * destination, which __ds_snap_close(...) renames over it once complete, so
+ * a process that has the old snapshot mapped keeps seeing the old contents.
+ **/
+typedef struct __ds_snap_s {
+   FILE *__file;
+   char *__tmp;
+   const char *__path;
+   __ds_snap_hdr_t __hdr;
+} __ds_snap_t;
+
+
+extern   int   __ds_snap_open    (__ds_snap_t* const s, const char* path,
+                                  size_t elem_size, ds_idx_t count);
+extern   void  __ds_snap_put     (__ds_snap_t* const s, const void* elems,
+                                  size_t n);
+extern   int   __ds_snap_close   (__ds_snap_t* const s);
+extern   char* __ds_snap_map     (const char* path, size_t elem_size,
+                                  int verify, ds_idx_t* count, size_t* len);
+
+#endif   /* __LIBDSTRUCTS_SNAPSHOT_H__ */
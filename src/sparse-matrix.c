@@ -0,0 +1,679 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), realloc(...), free(...) */
+#include "sparse-matrix.h"
+#include "pool.h"       /* For __ds_pool_run(...) */
+
+
+#define INIT_SIZE 16    /* Initial number of entries room is made for */
+#define ADDED 1
+#define PAR_CHUNKS 4    /* Chunks per thread for parallel multiply */
+#define PAR_MIN 4096    /* Fewest nonzeros per chunk for parallel multiply */
+
+
+/**
+ * Internal sparse matrix definition. __nnz entries are stored, with room for
+ * __cap of them in coordinate format.
+ *
+ * In coordinate format, entry k is at row __coo_rows[k] and column
+ * __idx[k], holds __vals[k], and __ptr is NULL. Once compressed, __coo_rows
+ * is NULL, and the entries of major line k (a row for SPM_CSR, a column for
+ * SPM_CSC) are those from __ptr[k] up to __ptr[k + 1], ordered by their minor
+ * index __idx (a column for SPM_CSR, a row for SPM_CSC), with no repeats.
+ **/
+struct __spm_s {
+   double *__vals;
+   ds_idx_t *__idx;
+   ds_idx_t *__ptr;
+   ds_idx_t *__coo_rows;
+   ds_idx_t __rows;
+   ds_idx_t __cols;
+   ds_idx_t __nnz;
+   ds_idx_t __cap;
+   int __format;
+};
+
+
+/**
+ * Internal job description for spm_mulv_par(...). Task i computes the rows
+ * from __SPM_CHUNK(job, i) up to __SPM_CHUNK(job, i + 1).
+ **/
+typedef struct __spm_job_s {
+   spm_t *m;
+   const double *x;
+   double *y;
+   int ntasks;
+} __spm_job_t;
+
+
+/* Local functions */
+static int __spm_grow(spm_t* const m, ds_idx_t cap);
+static void __spm_scatter(spm_t* const m, const ds_idx_t* maj,
+                          const ds_idx_t* min, ds_idx_t nmaj,
+                          ds_idx_t* ptr, ds_idx_t* idx, double* vals);
+static void __spm_transpose(ds_idx_t nmaj, ds_idx_t nmin,
+                            const ds_idx_t* ptr, const ds_idx_t* idx,
+                            const double* vals, ds_idx_t* tptr,
+                            ds_idx_t* tidx, double* tvals);
+static void __spm_merge(spm_t* const m, ds_idx_t nmaj);
+static void __spm_rows(spm_t* const m, const double* x, double* y,
+                       ds_idx_t first, ds_idx_t end);
+static ds_idx_t __spm_chunk(__spm_job_t* const job, int task);
+static void __spm_mulv_task(void* ctx, int task);
+
+
+/**
+ * A simulated constructor for a sparse matrix. The matrix starts out empty,
+ * that is all zeros, in coordinate format.
+ *
+ * @param rows - the number of rows.
+ * @param cols - the number of columns.
+ * @return a pointer to an empty rows x cols matrix. Returns a NULL pointer if
+ *    either dimension is less than one (1), or upon allocation error.
+ **/
+spm_t* spm_init(ds_idx_t rows, ds_idx_t cols) {
+   spm_t *m;
+
+   if(rows < 1 || cols < 1) return NULL;
+
+   m = malloc(sizeof(spm_t));
+
+   if(!m) return NULL;
+
+   m->__vals = NULL;
+   m->__idx = NULL;
+   m->__ptr = NULL;
+   m->__coo_rows = NULL;
+   m->__rows = rows;
+   m->__cols = cols;
+   m->__nnz = 0;
+   m->__cap = 0;
+   m->__format = SPM_COO;
+
+   if(!__spm_grow(m, INIT_SIZE)) {
+      spm_free(m);
+      return NULL;
+   }
+
+   return m;
+}
+
+
+/**
+ * A simulated destructor for a sparse matrix.
+ *
+ * @param m - the matrix to destroy.
+ **/
+void spm_free(spm_t* const m) {
+   if(!m) return;
+
+   free(m->__vals);
+   free(m->__idx);
+   free(m->__ptr);
+   free(m->__coo_rows);
+   free(m);
+}
+
+
+/**
+ * Retrieve the number of rows of a sparse matrix.
+ *
+ * @param m - the matrix.
+ * @return the number of rows. Returns -1 if the matrix is NULL.
+ **/
+ds_idx_t spm_rows(spm_t* const m) {
+   return (m ? m->__rows : -1);
+}
+
+
+/**
+ * Retrieve the number of columns of a sparse matrix.
+ *
+ * @param m - the matrix.
+ * @return the number of columns. Returns -1 if the matrix is NULL.
+ **/
+ds_idx_t spm_cols(spm_t* const m) {
+   return (m ? m->__cols : -1);
+}
+
+
+/**
+ * Retrieve the number of entries stored in a sparse matrix. In coordinate
+ * format this counts every spm_add(...); once compressed, entries at the same
+ * position count once.
+ *
+ * @param m - the matrix.
+ * @return the number of stored entries. Returns -1 if the matrix is NULL.
+ **/
+ds_idx_t spm_nnz(spm_t* const m) {
+   return (m ? m->__nnz : -1);
+}
+
+
+/**
+ * Retrieve the storage format of a sparse matrix.
+ *
+ * @param m - the matrix.
+ * @return SPM_COO, SPM_CSR or SPM_CSC. Returns -1 if the matrix is NULL.
+ **/
+int spm_format(spm_t* const m) {
+   return (m ? m->__format : -1);
+}
+
+
+/**
+ * Make room for entries in a matrix in coordinate format, so that adding
+ * them does not reallocate.
+ *
+ * @param m - the matrix.
+ * @param nnz - the total number of entries to make room for.
+ * @return 1 if there is room for nnz entries. Returns 0 if the matrix is NULL
+ *    or compressed, nnz is negative, or upon allocation error.
+ **/
+int spm_reserve(spm_t* const m, ds_idx_t nnz) {
+   if(!m || m->__format != SPM_COO || nnz < 0) return !ADDED;
+
+   return (nnz <= m->__cap ? ADDED : __spm_grow(m, nnz));
+}
+
+
+/**
+ * Resize the entry arrays of a matrix in coordinate format.
+ *
+ * @param m - the matrix.
+ * @param cap - the new number of entries to make room for; at least __nnz.
+ * @return 1 if the arrays were resized. Returns 0 upon allocation error, in
+ *    which case the matrix keeps its contents and capacity.
+ **/
+static int __spm_grow(spm_t* const m, ds_idx_t cap) {
+   double *vals;
+   ds_idx_t *idx, *rows;
+
+   if((size_t) cap > ((size_t) -1) / sizeof(double)) return !ADDED;
+
+   /* Arrays already grown are kept; only __cap records what they all hold */
+   vals = realloc(m->__vals, sizeof(double) * (size_t) cap);
+
+   if(!vals) return !ADDED;
+
+   m->__vals = vals;
+
+   idx = realloc(m->__idx, sizeof(ds_idx_t) * (size_t) cap);
+
+   if(!idx) return !ADDED;
+
+   m->__idx = idx;
+
+   rows = realloc(m->__coo_rows, sizeof(ds_idx_t) * (size_t) cap);
+
+   if(!rows) return !ADDED;
+
+   m->__coo_rows = rows;
+   m->__cap = cap;
+
+   return ADDED;
+}
+
+
+/**
+ * Add an entry to a matrix in coordinate format. Entries may be added in any
+ * order; entries added at the same position are summed by
+ * spm_compress(...).
+ *
+ * @param m - the matrix.
+ * @param i - the row of the entry.
+ * @param j - the column of the entry.
+ * @param val - the value of the entry.
+ * @return 1 if the entry was added. Returns 0 if the matrix is NULL or
+ *    compressed, (i, j) is out of range, or upon allocation error.
+ **/
+int spm_add(spm_t* const m, ds_idx_t i, ds_idx_t j, double val) {
+   if(!m || m->__format != SPM_COO) return !ADDED;
+
+   if(i < 0 || i >= m->__rows || j < 0 || j >= m->__cols) return !ADDED;
+
+   if(m->__nnz == m->__cap && !__spm_grow(m, m->__cap * 2)) return !ADDED;
+
+   m->__coo_rows[m->__nnz] = i;
+   m->__idx[m->__nnz] = j;
+   m->__vals[m->__nnz] = val;
+   m->__nnz++;
+
+   return ADDED;
+}
+
+
+/**
+ * Bucket the coordinate entries of a matrix by a major index, keeping the
+ * order they were added in within each bucket (a counting sort).
+ *
+ * @param m - the matrix, in coordinate format.
+ * @param maj - the major index of each entry.
+ * @param min - the minor index of each entry.
+ * @param nmaj - the number of major lines.
+ * @param ptr - receives the nmaj + 1 line offsets.
+ * @param idx - receives the minor index of each entry.
+ * @param vals - receives the value of each entry.
+ **/
+static void __spm_scatter(spm_t* const m, const ds_idx_t* maj,
+                          const ds_idx_t* min, ds_idx_t nmaj,
+                          ds_idx_t* ptr, ds_idx_t* idx, double* vals) {
+   ds_idx_t k, slot;
+
+   for(k = 0; k <= nmaj; k++)
+      ptr[k] = 0;
+
+   for(k = 0; k < m->__nnz; k++)
+      ptr[maj[k] + 1]++;
+
+   for(k = 0; k < nmaj; k++)
+      ptr[k + 1] += ptr[k];
+
+   /* ptr[k] serves as line k's cursor, and ends at the start of line k + 1 */
+   for(k = 0; k < m->__nnz; k++) {
+      slot = ptr[maj[k]]++;
+      idx[slot] = min[k];
+      vals[slot] = m->__vals[k];
+   }
+
+   for(k = nmaj; k > 0; k--)
+      ptr[k] = ptr[k - 1];
+
+   ptr[0] = 0;
+}
+
+
+/**
+ * Transpose compressed storage: turn the lines of one compressed format into
+ * those of the other. Lines are read in order, so the minor indices of each
+ * output line come out sorted whatever the order of the input's.
+ *
+ * @param nmaj - the number of major lines of the input.
+ * @param nmin - the number of minor lines of the input.
+ * @param ptr - the nmaj + 1 line offsets of the input.
+ * @param idx - the minor index of each entry of the input.
+ * @param vals - the value of each entry of the input.
+ * @param tptr - receives the nmin + 1 line offsets of the output.
+ * @param tidx - receives the minor index of each entry of the output.
+ * @param tvals - receives the value of each entry of the output.
+ **/
+static void __spm_transpose(ds_idx_t nmaj, ds_idx_t nmin,
+                            const ds_idx_t* ptr, const ds_idx_t* idx,
+                            const double* vals, ds_idx_t* tptr,
+                            ds_idx_t* tidx, double* tvals) {
+   ds_idx_t k, e, slot;
+
+   for(k = 0; k <= nmin; k++)
+      tptr[k] = 0;
+
+   for(e = 0; e < ptr[nmaj]; e++)
+      tptr[idx[e] + 1]++;
+
+   for(k = 0; k < nmin; k++)
+      tptr[k + 1] += tptr[k];
+
+   for(k = 0; k < nmaj; k++)
+      for(e = ptr[k]; e < ptr[k + 1]; e++) {
+         slot = tptr[idx[e]]++;
+         tidx[slot] = k;
+         tvals[slot] = vals[e];
+      }
+
+   for(k = nmin; k > 0; k--)
+      tptr[k] = tptr[k - 1];
+
+   tptr[0] = 0;
+}
+
+
+/**
+ * Sum the repeated entries of a compressed matrix whose lines are sorted,
+ * compacting its arrays in place.
+ *
+ * @param m - the matrix.
+ * @param nmaj - the number of major lines.
+ **/
+static void __spm_merge(spm_t* const m, ds_idx_t nmaj) {
+   ds_idx_t k, e, start, out;
+
+   for(out = 0, start = 0, k = 0; k < nmaj; k++) {
+      e = start;
+      start = m->__ptr[k + 1];
+      m->__ptr[k] = out;
+
+      for(; e < start; e++)
+         if(out > m->__ptr[k] && m->__idx[out - 1] == m->__idx[e])
+            m->__vals[out - 1] += m->__vals[e];
+         else {
+            m->__idx[out] = m->__idx[e];
+            m->__vals[out] = m->__vals[e];
+            out++;
+         }
+   }
+
+   m->__ptr[nmaj] = out;
+   m->__nnz = out;
+}
+
+
+/**
+ * Convert a sparse matrix to a compressed format. From coordinate format,
+ * the entries are bucketed by the other axis and then transposed into the
+ * requested one, two counting passes that leave every line sorted without
+ * comparing entries, and repeated entries are summed. Between SPM_CSR and
+ * SPM_CSC it is a single transposition. Both take O(nnz + rows + cols) time.
+ * Converting to the matrix's own format does nothing.
+ *
+ * @param m - the matrix.
+ * @param format - SPM_CSR or SPM_CSC.
+ * @return 1 if the matrix is in the requested format. Returns 0 if the
+ *    matrix is NULL, the format is not SPM_CSR or SPM_CSC, or upon allocation
+ *    error, in which case the matrix is left unchanged.
+ **/
+int spm_compress(spm_t* const m, int format) {
+   ds_idx_t *ptr, *idx, *tptr, *tidx, nmaj, nmin;
+   double *vals, *tvals;
+
+   if(!m || (format != SPM_CSR && format != SPM_CSC)) return !ADDED;
+
+   if(m->__format == format) return ADDED;
+
+   nmaj = (format == SPM_CSR ? m->__rows : m->__cols);
+   nmin = (format == SPM_CSR ? m->__cols : m->__rows);
+
+   ptr = NULL;
+   idx = NULL;
+   vals = NULL;
+
+   /* From coordinates, first bucket by the minor axis of the target */
+   if(m->__format == SPM_COO) {
+      ptr = malloc(sizeof(ds_idx_t) * ((size_t) nmin + 1));
+      idx = malloc(sizeof(ds_idx_t) * ((size_t) m->__nnz + 1));
+      vals = malloc(sizeof(double) * ((size_t) m->__nnz + 1));
+   }
+
+   tptr = malloc(sizeof(ds_idx_t) * ((size_t) nmaj + 1));
+   tidx = malloc(sizeof(ds_idx_t) * ((size_t) m->__nnz + 1));
+   tvals = malloc(sizeof(double) * ((size_t) m->__nnz + 1));
+
+   if(!tptr || !tidx || !tvals ||
+      (m->__format == SPM_COO && (!ptr || !idx || !vals))) {
+      free(ptr);
+      free(idx);
+      free(vals);
+      free(tptr);
+      free(tidx);
+      free(tvals);
+      return !ADDED;
+   }
+
+   if(m->__format == SPM_COO) {
+      if(format == SPM_CSR)
+         __spm_scatter(m, m->__idx, m->__coo_rows, nmin, ptr, idx, vals);
+      else
+         __spm_scatter(m, m->__coo_rows, m->__idx, nmin, ptr, idx, vals);
+
+      __spm_transpose(nmin, nmaj, ptr, idx, vals, tptr, tidx, tvals);
+
+      free(ptr);
+      free(idx);
+      free(vals);
+   }
+   else
+      __spm_transpose(nmin, nmaj, m->__ptr, m->__idx, m->__vals, tptr, tidx,
+                      tvals);
+
+   free(m->__ptr);
+   free(m->__idx);
+   free(m->__vals);
+   free(m->__coo_rows);
+
+   m->__ptr = tptr;
+   m->__idx = tidx;
+   m->__vals = tvals;
+   m->__coo_rows = NULL;
+   m->__cap = 0;
+
+   if(m->__format == SPM_COO)
+      __spm_merge(m, nmaj);
+
+   m->__format = format;
+
+   return ADDED;
+}
+
+
+/**
+ * Retrieve an element of a sparse matrix. A compressed matrix finds it by
+ * binary search within its row or column; a matrix in coordinate format
+ * scans all of its entries.
+ *
+ * @param m - the matrix.
+ * @param i - the row of the element.
+ * @param j - the column of the element.
+ * @return the element at (i, j), or 0.0 if no entry is stored there. Returns
+ *    0.0 if the matrix is NULL or (i, j) is out of range.
+ **/
+double spm_get(spm_t* const m, ds_idx_t i, ds_idx_t j) {
+   ds_idx_t lo, hi, mid, key;
+   double sum;
+
+   if(!m || i < 0 || i >= m->__rows || j < 0 || j >= m->__cols) return 0.0;
+
+   if(m->__format == SPM_COO) {
+      for(sum = 0.0, lo = 0; lo < m->__nnz; lo++)
+         if(m->__coo_rows[lo] == i && m->__idx[lo] == j)
+            sum += m->__vals[lo];
+
+      return sum;
+   }
+
+   lo = m->__ptr[m->__format == SPM_CSR ? i : j];
+   hi = m->__ptr[(m->__format == SPM_CSR ? i : j) + 1];
+   key = (m->__format == SPM_CSR ? j : i);
+
+   while(lo < hi) {
+      mid = lo + (hi - lo) / 2;
+
+      if(m->__idx[mid] < key)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return (lo < m->__ptr[(m->__format == SPM_CSR ? i : j) + 1] &&
+           m->__idx[lo] == key ? m->__vals[lo] : 0.0);
+}
+
+
+/**
+ * Retrieve the entries of a row of a matrix in SPM_CSR format, or of a
+ * column of a matrix in SPM_CSC format, such as the neighbours of a vertex
+ * in an adjacency matrix. The arrays are the matrix's own storage and stay
+ * valid until it is converted or freed.
+ *
+ * @param m - the compressed matrix.
+ * @param k - the row (SPM_CSR) or column (SPM_CSC).
+ * @param idx - if not NULL, set to the column (SPM_CSR) or row (SPM_CSC) of
+ *    each entry, in ascending order.
+ * @param vals - if not NULL, set to the value of each entry.
+ * @return the number of entries in the line. Returns -1 if the matrix is
+ *    NULL or not compressed, or k is out of range.
+ **/
+ds_idx_t spm_line(spm_t* const m, ds_idx_t k, const ds_idx_t** idx,
+                  const double** vals) {
+   if(!m || m->__format == SPM_COO || k < 0) return -1;
+
+   if(k >= (m->__format == SPM_CSR ? m->__rows : m->__cols)) return -1;
+
+   if(idx) *idx = m->__idx + m->__ptr[k];
+   if(vals) *vals = m->__vals + m->__ptr[k];
+
+   return m->__ptr[k + 1] - m->__ptr[k];
+}
+
+
+/**
+ * Compute rows of the product of a matrix in SPM_CSR format and a vector.
+ *
+ * @param m - the matrix.
+ * @param x - the vector.
+ * @param y - receives the product.
+ * @param first - the first row to compute.
+ * @param end - the row after the last to compute.
+ **/
+static void __spm_rows(spm_t* const m, const double* x, double* y,
+                       ds_idx_t first, ds_idx_t end) {
+   ds_idx_t i, e, stop;
+   double sum;
+
+   for(i = first; i < end; i++) {
+      stop = m->__ptr[i + 1];
+
+      for(sum = 0.0, e = m->__ptr[i]; e < stop; e++)
+         sum += m->__vals[e] * x[m->__idx[e]];
+
+      y[i] = sum;
+   }
+}
+
+
+/**
+ * Multiply a sparse matrix by a dense vector: y = m * x. SPM_CSR computes
+ * each element of y as one pass over a row; SPM_CSC and SPM_COO scatter each
+ * entry's contribution into y instead. All take O(nnz + rows) time.
+ *
+ * @param m - the matrix.
+ * @param x - the spm_cols(m) elements of the vector to multiply.
+ * @param y - receives the spm_rows(m) elements of the product. Must not
+ *    overlap x.
+ * @return 1 if the product was computed. Returns 0 if any argument is NULL.
+ **/
+int spm_mulv(spm_t* const m, const double* x, double* y) {
+   ds_idx_t i, e;
+
+   if(!m || !x || !y) return !ADDED;
+
+   if(m->__format == SPM_CSR) {
+      __spm_rows(m, x, y, 0, m->__rows);
+      return ADDED;
+   }
+
+   for(i = 0; i < m->__rows; i++)
+      y[i] = 0.0;
+
+   if(m->__format == SPM_CSC) {
+      for(i = 0; i < m->__cols; i++)
+         for(e = m->__ptr[i]; e < m->__ptr[i + 1]; e++)
+            y[m->__idx[e]] += m->__vals[e] * x[i];
+   }
+   else
+      for(e = 0; e < m->__nnz; e++)
+         y[m->__coo_rows[e]] += m->__vals[e] * x[m->__idx[e]];
+
+   return ADDED;
+}
+
+
+/**
+ * Find the first row of a chunk of an spm_mulv_par(...) job. Chunks are cut
+ * so that each holds about the same number of nonzeros, rather than of rows,
+ * so a few dense rows do not leave one thread with most of the work.
+ *
+ * @param job - the job.
+ * @param task - the chunk, from zero (0) to job->ntasks.
+ * @return the first row of the chunk; the number of rows for task ntasks.
+ **/
+static ds_idx_t __spm_chunk(__spm_job_t* const job, int task) {
+   ds_idx_t lo, hi, mid, target;
+
+   if(task >= job->ntasks) return job->m->__rows;
+
+   target = (ds_idx_t) ((double) job->m->__nnz * task / job->ntasks);
+
+   for(lo = 0, hi = job->m->__rows; lo < hi; ) {
+      mid = lo + (hi - lo) / 2;
+
+      if(job->m->__ptr[mid] < target)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return lo;
+}
+
+
+/**
+ * Multiply a sparse matrix by a dense vector using several threads: y = m *
+ * x. A matrix in SPM_CSR format is split into chunks of rows that are handed
+ * out to the shared pool of worker threads behind the *_apply_par(...)
+ * functions; each thread writes only its own rows of y. Other formats
+ * scatter into shared elements of y, so they are multiplied on the calling
+ * thread, as are matrices too small to be worth splitting.
+ *
+ * @param m - the matrix.
+ * @param x - the spm_cols(m) elements of the vector to multiply.
+ * @param y - receives the spm_rows(m) elements of the product. Must not
+ *    overlap x.
+ * @param nthreads - the most threads to use, the calling thread included. If
+ *    zero (0) or less, uses one thread per online processor.
+ * @return 1 if the product was computed. Returns 0 if any argument is NULL.
+ **/
+int spm_mulv_par(spm_t* const m, const double* x, double* y, int nthreads) {
+   __spm_job_t job;
+   ds_idx_t chunks;
+
+   if(!m || !x || !y) return !ADDED;
+
+   if(m->__format != SPM_CSR) return spm_mulv(m, x, y);
+
+   chunks = __ds_pool_threads(nthreads) * PAR_CHUNKS;
+
+   /* Keep chunks large enough to outweigh the cost of handing them out */
+   if(chunks > m->__nnz / PAR_MIN)
+      chunks = m->__nnz / PAR_MIN;
+
+   if(chunks < 2) return spm_mulv(m, x, y);
+
+   job.m = m;
+   job.x = x;
+   job.y = y;
+   job.ntasks = (int) chunks;
+
+   __ds_pool_run(__spm_mulv_task, &job, job.ntasks, nthreads);
+
+   return ADDED;
+}
+
+
+/**
+ * Multiply one chunk of rows of an spm_mulv_par(...) job.
+ *
+ * @param ctx - the job.
+ * @param task - the chunk to multiply.
+ **/
+static void __spm_mulv_task(void* ctx, int task) {
+   __spm_job_t *job;
+
+   job = ctx;
+
+   __spm_rows(job->m, job->x, job->y, __spm_chunk(job, task),
+              __spm_chunk(job, task + 1));
+}
@@ -17,17 +17,12 @@
  * along with this program.  If not, see {http://www.gnu.org/licenses/}.
  **/
 #include <stdlib.h>
+#undef DSTRUCTS_INLINE  /* The out-of-line accessors are defined here */
 #include "stack.h"
-#include "list.h"
-
-
-/**
- * Stack public, opaque data type. Contents only accessable through function
- * calls.
- **/
-struct stack_s {
-   llist_t *__list;
-};
+#include "vector.h"
+#include "layout.h"     /* For struct stack_s */
+#include "mem.h"        /* For __DS_ALLOC(...), __DS_FREE(...) */
+#include "counters.h"   /* For __DS_STATS_SYNC(...) */
 
 
 /* Wrapper macro for __s_init(...) */
@@ -47,19 +42,41 @@ struct stack_s {
  *    error.
  **/
 stack_t* __s_init(size_t __elem_size) {
+   return __s_init_alloc(__elem_size, NULL);
+}
+
+
+/**
+ * A simulated constructor for a stack whose memory all comes from a user
+ * allocator, including the release of elements freed by s_free(...).
+ * Elements pushed onto such a stack must therefore come from the same
+ * allocator. The allocator must outlive the stack.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro s_init_alloc(type, alloc).
+ *
+ * @param __elem_size - the size of an element in the stack.
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty stack. Returns a NULL pointer upon allocation
+ *    error.
+ **/
+stack_t* __s_init_alloc(size_t __elem_size, ds_allocator_t* const alloc) {
    stack_t *stack;
 
-   stack = malloc(sizeof(stack_t));
+   stack = __DS_ALLOC(alloc, sizeof(stack_t));
 
    if(!stack) return NULL;
 
-   stack->__list = __ll_init(__elem_size);
+   stack->__alloc = alloc;
+   stack->__vector = __v_init_alloc(__elem_size, 0, alloc);
 
-   if(!stack->__list) {
-      free(stack);
+   if(!stack->__vector) {
+      __DS_FREE(alloc, stack, sizeof(stack_t));
       return NULL;
    }
 
+   __DS_STATS_SYNC(stack, stack->__vector);
+
    return stack;
 }
 
@@ -72,8 +89,8 @@ stack_t* __s_init(size_t __elem_size) {
 void s_free(stack_t* const s) {
    if(!s) return;
 
-   ll_free(s->__list);
-   free(s);
+   v_free(s->__vector);
+   __DS_FREE(s->__alloc, s, sizeof(stack_t));
 }
 
 
@@ -84,8 +101,29 @@ void s_free(stack_t* const s) {
  * @return the number of elements in the stack. Returns -1 if the stack is
  *    NULL.
  **/
-int s_size(stack_t* const s) {
-   return (s ? ll_size(s->__list) : -1);
+ds_idx_t s_size(stack_t* const s) {
+   return (s ? v_size(s->__vector) : -1);
+}
+
+
+/**
+ * Ensure a stack can hold at least the specified number of elements without
+ * reallocating.
+ *
+ * @param s - the stack to reserve space in.
+ * @param n - the minimum number of elements the stack can hold.
+ * @return 1 if the stack can hold n elements. Returns 0 if the stack is NULL,
+ *    n is negative, or upon allocation error.
+ **/
+int s_reserve(stack_t* const s, ds_idx_t n) {
+   int reserved;
+
+   if(!s) return 0;
+
+   reserved = v_reserve(s->__vector, n);
+   __DS_STATS_SYNC(s, s->__vector);
+
+   return reserved;
 }
 
 
@@ -99,7 +137,7 @@ int s_size(stack_t* const s) {
  *    NULL if the stack is NULL.
  **/
 void* s_top(stack_t* const s) {
-   return (s ? ll_first(s->__list) : NULL);
+   return (s ? v_last(s->__vector) : NULL);
 }
 
 
@@ -109,11 +147,17 @@ void* s_top(stack_t* const s) {
  *
  * @param s - the stack to add the specified element to.
  * @param elem - the element to add to the stack.
+ * @return 1 if the element was added. Returns 0 if either parameter is NULL.
  **/
-void s_push(stack_t* const s, void* const elem) {
-   if(!s || !elem) return;
+int s_push(stack_t* const s, void* const elem) {
+   int added;
+
+   if(!s || !elem) return 0;
 
-   ll_addf(s->__list, elem);
+   added = v_push(s->__vector, elem);
+   __DS_STATS_SYNC(s, s->__vector);
+
+   return added;
 }
 
 
@@ -124,19 +168,56 @@ void s_push(stack_t* const s, void* const elem) {
  * @return the top of the stack. Returns NULL if the stack is empty or NULL.
  **/
 void* s_pop(stack_t* const s) {
-   return (s ? ll_remf(s->__list) : NULL);
+   void *elem;
+
+   if(!s) return NULL;
+
+   elem = v_reml(s->__vector);
+   __DS_STATS_SYNC(s, s->__vector);
+
+   return elem;
 }
 
 
 /**
  * Creates and returns a pointer to an array representation of the stack,
- * which free(...) may be called on.
+ * which free(...) may be called on. The top of the stack is at index zero
+ * (0).
  *
  * @param s - the stack to translate to an array.
  * @return a pointer to an array representation of the stack. Returns NULL if
  *    the stack is NULL.
  **/
 void** s_toarr(stack_t* const s) {
-   return (s ? ll_toarr(s->__list) : NULL);
+   void **array;
+   ds_idx_t i, size;
+
+   if(!s) return NULL;
+
+   size = s->__vector->__size;
+
+   array = malloc(sizeof(void*) * (size_t) size);
+
+   if(!array) return NULL;
+
+   /* Top of the stack first */
+   for(i = 0; i < size; i++)
+      array[i] = v_get(s->__vector, size - 1 - i);
+
+   return array;
 }
 
+
+/**
+ * Returns a borrowed view of the stack without copying. The view is of the
+ * underlying vector, so unlike s_toarr(...) it lists the stack from the
+ * bottom up: the top of the stack is the last element of the view. The view
+ * must not be freed, and is only valid until the next push or pop.
+ *
+ * @param s - the stack to view.
+ * @return a view of the stack's elements. An empty view is returned if the
+ *    stack is NULL.
+ **/
+ds_span_t s_view(stack_t* const s) {
+   return v_span(s ? s->__vector : NULL);
+}
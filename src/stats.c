@@ -0,0 +1,50 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <string.h>     /* For memset(...) */
+#include "stats.h"
+
+
+/**
+ * Retrieve the instrumentation counters of a container. Every instrumented
+ * container keeps its counters as its first member, so any of them may be
+ * passed here.
+ *
+ * @param container - the vector, stack, list, unrolled list or queue to
+ *    inspect.
+ * @param stats - set to the container's counters, or to all zeros if they are
+ *    not kept.
+ * @return 1 if the counters were retrieved. Returns 0 if either argument is
+ *    NULL or the library was built without DSTRUCTS_STATS.
+ **/
+int ds_stats_get(const void* const container, ds_stats_t* const stats) {
+   if(!stats) return 0;
+
+#ifdef DSTRUCTS_STATS
+   if(container) {
+      *stats = *(const ds_stats_t*) container;
+      return 1;
+   }
+#else
+   (void) container;
+#endif
+
+   memset(stats, 0, sizeof(ds_stats_t));
+
+   return 0;
+}
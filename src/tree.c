@@ -19,23 +19,103 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tree.h"
+#include "pool.h"       /* For __ds_pool_run(...) */
+#include "mem.h"        /* For __DS_ALLOC(...), __DS_FREE(...) */
 
 
 #define EXIST 1
 #define ADDED 1
+#define PAR_CHUNKS 4    /* Subtrees per thread for parallel apply */
+#define PAR_MIN 1024    /* Smallest subtree split further for parallel apply */
 
 
 /**
- * Internal binary search tree definition.
+ * Internal binary search tree definition. Each node is the root of its own
+ * subtree and records that subtree's height and size. An empty tree is a
+ * single node with a NULL element and a height of zero (0).
+ *
+ * Rotations swap elements between nodes rather than relinking the top node,
+ * so a pointer to any (sub)tree stays valid while the tree rebalances.
+ *
+ * __alloc is the allocator nodes and freed elements go through, or NULL for
+ * the C library. Like the comparator, every node carries it. Nodes built by
+ * bst_build_sorted(...) share a single allocation, __slab, which is released
+ * once the last of them is; other nodes have a NULL __slab.
  **/
 struct __bst_s {
    void *__elem;
    size_t __elem_size;
+   ds_cmp_t __cmp;
+   ds_allocator_t *__alloc;
    struct __bst_s *__left;
    struct __bst_s *__right;
+   union __bst_slab_u *__slab;
+   int __height;
+   int __size;
 };
 
 
+/**
+ * Internal slab type. Slot 0 of a block of slots is the header, counting the
+ * nodes of the block still in use and recording the block's size; the other
+ * slots are nodes. Only used in this file.
+ **/
+typedef union __bst_slab_u {
+   struct {
+      size_t live;
+      size_t bytes;
+   } head;
+   struct __bst_s node;
+} __bst_slab_t;
+
+
+/* Height and size of a possibly NULL subtree */
+#define __BST_HEIGHT(t) ((t) ? (t)->__height : 0)
+#define __BST_SIZE(t) ((t) ? (t)->__size : 0)
+
+/* Compare an element against the element at the top of a tree */
+#define __BST_CMP(t, e) ((t)->__cmp((e), (t)->__elem, (t)->__elem_size))
+
+
+/* Local functions */
+static bst_t* __bst_node(bst_t* const tree, void* const elem);
+static void __bst_release(bst_t* const node);
+static void __bst_build(bst_t* const tree, void** const arr, int n,
+                        __bst_slab_t* const slab, int* const next);
+static bst_t* __bst_carve(bst_t* const tree, __bst_slab_t* const slab,
+                          int* const next);
+static void __bst_update(bst_t* const tree);
+static void __bst_rotl(bst_t* const tree);
+static void __bst_rotr(bst_t* const tree);
+static void __bst_balance(bst_t* const tree);
+static void __bst_take(bst_t* const tree, bst_t* const child);
+static void* __bst_remove(bst_t* const tree, void* const elem,
+                          int* const empty);
+static void* __bst_popmin(bst_t* const tree, int* const empty);
+static void __bst_inorder(bst_t* const tree, void** const array,
+                          int* const pos);
+static void __bst_walk(bst_t* const tree, void (*funct)(void* const));
+static void __bst_split(bst_t* const tree, int depth, bst_t** const tasks,
+                        int* const whole, int* const n);
+static void __bst_apply_task(void* ctx, int task);
+static void __bst_walk_ctx(bst_t* const tree,
+                           void (*funct)(void* const, void*), void* ctx);
+static void* __bst_visit(bst_t* const tree, int (*visit)(void* const, void*),
+                         void* ctx);
+
+
+/**
+ * Internal job description for bst_apply_par(...). Task i applies the
+ * function to all of subtree tasks[i] if whole[i] is set, or else only to
+ * the element at its top.
+ **/
+typedef struct __bst_job_s {
+   bst_t **tasks;
+   int *whole;
+   void (*funct)(void* const);
+} __bst_job_t;
+
+
 
 /** FUNCTION PROTOTYPES **/
 
@@ -44,24 +124,54 @@ struct __bst_s {
  * binary search tree to be created.
  *
  * NOTE: This is a function that is not intended for use by the user. The user
- * should instead use the macro bst_init(type), where type is the type that
- * the user wishes to restrict the binary search tree to.
+ * should instead use the macro bst_init(type) or bst_init_cmp(type, cmp),
+ * where type is the type that the user wishes to restrict the binary search
+ * tree to.
  *
  * @param __elem_size - the size of an element in the binary search tree.
+ * @param cmp - the function used to order elements. Uses ds_cmp_mem(...) if
+ *    NULL.
  * @return a pointer to an empty binary search tree. Returns a NULL pointer
  *    upon allocation error.
  **/
-bst_t* __bst_init(size_t __elem_size) {
+bst_t* __bst_init(size_t __elem_size, ds_cmp_t cmp) {
+   return __bst_init_alloc(__elem_size, cmp, NULL);
+}
+
+
+/**
+ * A simulated constructor for a binary search tree whose nodes all come from
+ * a user allocator, which also releases the elements freed by bst_free(...).
+ * Elements added to such a tree must therefore come from the same allocator.
+ * The allocator must outlive the tree.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro bst_init_alloc(type, cmp, alloc).
+ *
+ * @param __elem_size - the size of an element in the binary search tree.
+ * @param cmp - the function used to order elements. Uses ds_cmp_mem(...) if
+ *    NULL.
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty binary search tree. Returns a NULL pointer
+ *    upon allocation error.
+ **/
+bst_t* __bst_init_alloc(size_t __elem_size, ds_cmp_t cmp,
+                        ds_allocator_t* const alloc) {
    bst_t *tree;
 
-   tree = malloc(sizeof(bst_t));
+   tree = __DS_ALLOC(alloc, sizeof(bst_t));
 
    if(!tree) return NULL;
 
    tree->__elem = NULL;
    tree->__elem_size = __elem_size;
+   tree->__cmp = (cmp ? cmp : ds_cmp_mem);
+   tree->__alloc = alloc;
    tree->__left = NULL;
    tree->__right = NULL;
+   tree->__slab = NULL;
+   tree->__height = 0;
+   tree->__size = 0;
 
    return tree;
 }
@@ -88,39 +198,35 @@ void bst_free(bst_t* const tree) {
    }
 
    /* No more children; destroy */
-   free(tree->__elem);
-   free(tree);
+   if(tree->__elem)
+      __DS_FREE(tree->__alloc, tree->__elem, tree->__elem_size);
+
+   __bst_release(tree);
 }
 
 
 /**
- * TODO:
- *
  * Get the root of a binary search tree.
  *
  * @param tree - the binary search tree to get the root of.
  * @return the element at the root of the binary search tree.
  **/
 void* bst_root(bst_t* const tree) {
-   return NULL;
+   return (tree ? tree->__elem : NULL);
 }
 
 
 /**
- * TODO:
- *
- * Get the height of a binary search tree.
+ * Get the height of a binary search tree. That is, the number of levels in
+ * the tree; an empty tree has a height of zero (0) and a single element a
+ * height of one (1).
  *
  * @param tree - the binary search tree to get the height of.
  * @return the height of the binary search tree. Return -1 if the tree is NULL.
  *    Returns the height of the tree otherwise.
  **/
 int bst_height(bst_t* const tree) {
-   if(!tree) return -1;
-
-   /* TODO: calculate the height */
-
-   return 0;
+   return (tree ? tree->__height : -1);
 }
 
 
@@ -133,11 +239,7 @@ int bst_height(bst_t* const tree) {
  *    elements in the tree. Returns -1 if the tree is NULL.
  **/
 int bst_size(bst_t* const tree) {
-   if(!tree) return -1;
-
-   /* TODO: calculate the size */
-
-   return 0;
+   return (tree ? tree->__size : -1);
 }
 
 
@@ -151,38 +253,11 @@ int bst_size(bst_t* const tree) {
  *    or if the list is NULL;
  **/
 int bst_contains(bst_t* const tree, void* const elem) {
-   int cmp;
-
-   if(!tree || !elem) return !EXIST;
-
-   cmp = memcmp(elem, tree->__elem, tree->__elem_size);
-
-   switch(cmp) {
-         /* Not here; search left tree */
-      case -1:
-         return bst_contains(tree->__left, elem);
-
-         /* Here; element exists */
-      case 0:
-         return EXIST;
-
-         /* Not here; search right tree */
-      case 1:
-         return bst_contains(tree->__right, elem);
-
-         /* Error; should never occur */
-      default:
-         return !EXIST;
-   }
-
-   /* Error; should never occur */
-   return !EXIST;
+   return (bst_tree(tree, elem) ? EXIST : !EXIST);
 }
 
 
 /**
- * TODO:
- *
  * Gets (but does not remove) a subtree of a binary search tree with the root
  * as element.
  *
@@ -192,31 +267,25 @@ int bst_contains(bst_t* const tree, void* const elem) {
  *    either parameter is NULL or if the element does not exist in the tree.
  **/
 bst_t* bst_tree(bst_t* const tree, void* const elem) {
+   bst_t *temp;
    int cmp;
 
-   if(!tree || !elem) return NULL;
-
-   cmp = memcmp(elem, tree->__elem, tree->__elem_size);
+   if(!tree || !elem || !tree->__elem) return NULL;
 
-   switch(cmp) {
-         /* Not here; search left tree */
-      case -1:
-         return bst_tree(tree->__left, elem);
+   temp = tree;
 
-         /* Here; return tree */
-      case 0:
-         return tree;
+   while(temp) {
+      cmp = __BST_CMP(temp, elem);
 
-         /* Not here; search right tree */
-      case 1:
-         return bst_tree(tree->__right, elem);
+      /* Here; return tree */
+      if(cmp == 0)
+         return temp;
 
-         /* Error; should never occur */
-      default:
-         return NULL;
+      /* Not here; search left or right tree */
+      temp = (cmp < 0 ? temp->__left : temp->__right);
    }
 
-   /* Should never occur */
+   /* Element does not exist */
    return NULL;
 }
 
@@ -282,28 +351,108 @@ bst_t* bst_right(bst_t* const tree) {
 }
 
 /**
- * TODO:
- *
  * Add an element to a binary search tree. If an element already exists in the
  * tree, it is not added. In other words, duplicate elements are not added.
+ * The tree is rebalanced on the way back up.
  *
  * @param tree - the binary search tree to add an element to.
  * @param elem - the element to add to a binary search tree.
- * @return 1 if the element was added to the binary search tree.
+ * @return 1 if the element was added to the binary search tree. Returns 0 if
+ *    either parameter is NULL, if the element already exists, or upon
+ *    allocation error.
  **/
 int bst_add(bst_t* const tree, void* const elem) {
+   bst_t **child;
+   int cmp, added;
+
    if(!tree || !elem) return !ADDED;
 
-   /* TODO: add element to the tree */
+   /* Adding to empty tree */
+   if(!tree->__elem) {
+      tree->__elem = elem;
+      tree->__height = 1;
+      tree->__size = 1;
+
+      return ADDED;
+   }
+
+   cmp = __BST_CMP(tree, elem);
+
+   /* Duplicate */
+   if(cmp == 0) return !ADDED;
+
+   child = (cmp < 0 ? &tree->__left : &tree->__right);
+
+   if(!*child) {
+      *child = __bst_node(tree, elem);
+      added = (*child ? ADDED : !ADDED);
+   }
+   else
+      added = bst_add(*child, elem);
 
-   return !ADDED;
+   if(added) {
+      __bst_update(tree);
+      __bst_balance(tree);
+   }
+
+   return added;
 }
 
 
 /**
- * TODO:
+ * Fill an empty binary search tree from an array of elements already in
+ * ascending order, in O(n) time and without comparing elements beyond
+ * checking that order. The middle element becomes the root and each half is
+ * built the same way, so the tree is perfectly balanced. Every node but the
+ * root is carved from one allocation, which is released once the last of
+ * those nodes is removed or the tree is freed. The tree takes ownership of
+ * the elements, as with bst_add(...).
  *
- * Remove an element from a binary search tree.
+ * @param tree - the empty binary search tree to fill.
+ * @param arr - the n elements, strictly ascending by the tree's comparator.
+ * @param n - the number of elements.
+ * @return 1 if the tree was built. Returns 0 if the tree is NULL or not
+ *    empty, arr is NULL, n is negative, an element is NULL, the elements are
+ *    not strictly ascending, or upon allocation error, in which case the tree
+ *    is left empty.
+ **/
+int bst_build_sorted(bst_t* const tree, void** const arr, int n) {
+   __bst_slab_t *slab;
+   size_t bytes;
+   int i, next;
+
+   if(!tree || tree->__elem || !arr || n < 0) return !ADDED;
+
+   for(i = 0; i < n; i++)
+      if(!arr[i] ||
+         (i > 0 && tree->__cmp(arr[i - 1], arr[i], tree->__elem_size) >= 0))
+         return !ADDED;
+
+   if(n == 0) return ADDED;
+
+   slab = NULL;
+
+   /* The root stays the caller's node; the rest share one block */
+   if(n > 1) {
+      bytes = sizeof(__bst_slab_t) * (size_t) n;
+      slab = __DS_ALLOC(tree->__alloc, bytes);
+
+      if(!slab) return !ADDED;
+
+      slab[0].head.live = (size_t) n - 1;
+      slab[0].head.bytes = bytes;
+   }
+
+   next = 1;
+   __bst_build(tree, arr, n, slab, &next);
+
+   return ADDED;
+}
+
+
+/**
+ * Remove an element from a binary search tree. The tree is rebalanced on the
+ * way back up.
  *
  * @param tree - the binary search tree to remove an element from.
  * @param elem - the element to remove from a binary search tree.
@@ -312,16 +461,19 @@ int bst_add(bst_t* const tree, void* const elem) {
  *    tree.
  **/
 void* bst_rem(bst_t* const tree, void* const elem) {
-   if(!tree || !elem) return NULL;
+   int empty;
 
-   /* TODO: remove an element from the tree */
+   if(!tree || !elem || !tree->__elem) return NULL;
 
-   return NULL;
+   empty = 0;
+
+   return __bst_remove(tree, elem, &empty);
 }
 
 
 /**
- * Apply a given function over a binary search tree.
+ * Apply a given function over a binary search tree, visiting elements in
+ * order.
  *
  * @param tree - the binary search tree to apply a function over.
  * @param funct - the function to apply over a binary search tree.
@@ -334,35 +486,585 @@ void bst_apply(bst_t* const tree, void (*funct)(void* const)) {
       return;
    }
 
-   /* Apply the function */
-   (funct)(tree->__elem);
+   if(!tree->__elem) return;
 
-   /* Apply to left and right subtrees */
+   /* Apply to left subtree, this element, then right subtree */
    bst_apply(tree->__left, funct);
+   (funct)(tree->__elem);
    bst_apply(tree->__right, funct);
 }
 
 
 /**
- * TODO:
+ * Apply a function over all the elements in a binary search tree, in order,
+ * handing each call a user supplied context pointer so that results can be
+ * accumulated without global state.
  *
+ * @param tree - the binary search tree to apply an operation over.
+ * @param funct - the function to apply, where the first argument is an element
+ *    in the binary search tree and the second argument is ctx.
+ * @param ctx - the context passed to every call of funct.
+ **/
+void bst_apply_ctx(bst_t* const tree, void (*funct)(void* const, void*),
+                   void* ctx) {
+   if(!tree || !tree->__elem) return;
+
+   __bst_walk_ctx(tree, funct, ctx);
+}
+
+
+/**
+ * Apply a function with a context to every element of a non-empty tree, in
+ * order.
+ *
+ * @param tree - the tree to walk.
+ * @param funct - the function to apply.
+ * @param ctx - the context passed to every call of funct.
+ **/
+static void __bst_walk_ctx(bst_t* const tree,
+                           void (*funct)(void* const, void*), void* ctx) {
+   if(tree->__left)
+      __bst_walk_ctx(tree->__left, funct, ctx);
+
+   (funct)(tree->__elem, ctx);
+
+   if(tree->__right)
+      __bst_walk_ctx(tree->__right, funct, ctx);
+}
+
+
+/**
+ * Visit the elements in a binary search tree, in order, stopping at the first
+ * element for which the visitor returns nonzero. Searches such as "find the
+ * first match" can stop there instead of walking the whole binary search tree.
+ *
+ * @param tree - the binary search tree to visit.
+ * @param visit - the visitor, where the first argument is an element in the
+ *    binary search tree and the second argument is ctx. Returns nonzero to
+ *    stop.
+ * @param ctx - the context passed to every call of visit.
+ * @return the element the visit stopped at. Returns NULL if the visitor never
+ *    returned nonzero or the binary search tree is NULL.
+ **/
+void* bst_visit(bst_t* const tree, int (*visit)(void* const, void*),
+                void* ctx) {
+   if(!tree || !tree->__elem) return NULL;
+
+   return __bst_visit(tree, visit, ctx);
+}
+
+
+/**
+ * Visit the elements of a non-empty tree in order until the visitor returns
+ * nonzero.
+ *
+ * @param tree - the tree to visit.
+ * @param visit - the visitor.
+ * @param ctx - the context passed to every call of visit.
+ * @return the element the visit stopped at, or NULL.
+ **/
+static void* __bst_visit(bst_t* const tree, int (*visit)(void* const, void*),
+                         void* ctx) {
+   void *found;
+
+   if(tree->__left && (found = __bst_visit(tree->__left, visit, ctx)))
+      return found;
+
+   if((visit)(tree->__elem, ctx))
+      return tree->__elem;
+
+   return (tree->__right ? __bst_visit(tree->__right, visit, ctx) : NULL);
+}
+
+
+/**
+ * Apply a function over all the elements in a binary search tree using
+ * several threads. The tree is cut into disjoint subtrees, plus the elements
+ * above them, which are handed out to a shared pool of worker threads. Each
+ * subtree is visited in order by a single thread, but subtrees run
+ * concurrently, so funct must be safe to call that way.
+ *
+ * @param tree - the tree to apply an operation over.
+ * @param funct - the function to apply to each element.
+ * @param nthreads - the most threads to use, the calling thread included. If
+ *    zero (0) or less, uses one thread per online processor.
+ **/
+void bst_apply_par(bst_t* const tree, void (*funct)(void* const),
+                   int nthreads) {
+   __bst_job_t job;
+   int depth, n;
+
+   if(!tree || !funct) return;
+
+   /* Freeing elements frees the tree; see bst_apply(...) */
+   if(funct == free || !tree->__elem) {
+      bst_apply(tree, funct);
+      return;
+   }
+
+   /* Cut deep enough for PAR_CHUNKS subtrees per thread */
+   for(depth = 0; (1 << depth) < __ds_pool_threads(nthreads) * PAR_CHUNKS;
+       depth++);
+
+   job.funct = funct;
+   job.tasks = malloc(sizeof(bst_t*) << (depth + 1));
+   job.whole = malloc(sizeof(int) << (depth + 1));
+
+   if(!job.tasks || !job.whole) {
+      free(job.tasks);
+      free(job.whole);
+      __bst_walk(tree, funct);
+      return;
+   }
+
+   n = 0;
+   __bst_split(tree, depth, job.tasks, job.whole, &n);
+
+   __ds_pool_run(__bst_apply_task, &job, n, nthreads);
+
+   free(job.tasks);
+   free(job.whole);
+}
+
+
+/**
+ * Cut a non-empty tree into tasks, in order: subtrees at the given depth (or
+ * small enough to not be worth splitting) become whole tasks, and the nodes
+ * above them become single element tasks.
+ *
+ * @param tree - the tree to cut.
+ * @param depth - the levels left to cut.
+ * @param tasks - the task array to append to.
+ * @param whole - filled alongside tasks.
+ * @param n - the number of tasks so far.
+ **/
+static void __bst_split(bst_t* const tree, int depth, bst_t** const tasks,
+                        int* const whole, int* const n) {
+   if(!depth || tree->__size <= PAR_MIN) {
+      tasks[*n] = tree;
+      whole[(*n)++] = 1;
+      return;
+   }
+
+   if(tree->__left)
+      __bst_split(tree->__left, depth - 1, tasks, whole, n);
+
+   tasks[*n] = tree;
+   whole[(*n)++] = 0;
+
+   if(tree->__right)
+      __bst_split(tree->__right, depth - 1, tasks, whole, n);
+}
+
+
+/**
+ * Run one task of a bst_apply_par(...) job.
+ *
+ * @param ctx - the job.
+ * @param task - the task to run.
+ **/
+static void __bst_apply_task(void* ctx, int task) {
+   __bst_job_t *job;
+
+   job = ctx;
+
+   if(job->whole[task])
+      __bst_walk(job->tasks[task], job->funct);
+   else
+      (job->funct)(job->tasks[task]->__elem);
+}
+
+
+/**
+ * Apply a function to every element of a non-empty tree, in order.
+ *
+ * @param tree - the tree to walk.
+ * @param funct - the function to apply.
+ **/
+static void __bst_walk(bst_t* const tree, void (*funct)(void* const)) {
+   if(tree->__left)
+      __bst_walk(tree->__left, funct);
+
+   (funct)(tree->__elem);
+
+   if(tree->__right)
+      __bst_walk(tree->__right, funct);
+}
+
+
+/**
  * Creates and returns a pointer to an array representation of a binary search
- * tree. Returns a pointer to an array on which free(...) may be called.
+ * tree. Returns a pointer to an array on which free(...) may be called. The
+ * elements are in order.
  *
  * @param tree - the binary search tree to translate to an array.
  * @return a pointer to an array representation of the binary search tree.
  **/
 void** bst_toarr(bst_t* const tree) {
-   int **array;
+   void **array;
+   int pos;
 
    if(!tree) return NULL;
 
-   array = malloc(sizeof(void*) * bst_size(tree));
+   array = malloc(sizeof(void*) * tree->__size);
 
    if(!array) return NULL;
 
-   /* TODO: populate array */
+   pos = 0;
+
+   if(tree->__elem)
+      __bst_inorder(tree, array, &pos);
+
+   return array;
+}
+
+
+/**
+ * Allocate a node for a tree, inheriting the tree's element size and
+ * comparator.
+ *
+ * @param tree - the tree the node will belong to.
+ * @param elem - the element of the node.
+ * @return a leaf node holding elem. Returns NULL upon allocation error.
+ **/
+static bst_t* __bst_node(bst_t* const tree, void* const elem) {
+   bst_t *node;
+
+   node = __bst_init_alloc(tree->__elem_size, tree->__cmp, tree->__alloc);
+
+   if(!node) return NULL;
+
+   node->__elem = elem;
+   node->__height = 1;
+   node->__size = 1;
+
+   return node;
+}
+
+
+/**
+ * Release a node: free it, or if it was carved from a slab, free the slab
+ * once none of its nodes remain in use.
+ *
+ * @param node - the node to release.
+ **/
+static void __bst_release(bst_t* const node) {
+   __bst_slab_t *slab;
+
+   slab = node->__slab;
+
+   if(!slab) {
+      __DS_FREE(node->__alloc, node, sizeof(bst_t));
+      return;
+   }
+
+   if(--slab[0].head.live == 0)
+      __DS_FREE(node->__alloc, slab, slab[0].head.bytes);
+}
+
+
+/**
+ * Build a perfectly balanced tree from sorted elements into a node, taking
+ * the nodes of its subtrees from a slab in turn.
+ *
+ * @param tree - the node to build into.
+ * @param arr - the n elements, in ascending order.
+ * @param n - the number of elements; at least one (1).
+ * @param slab - the slab to take nodes from.
+ * @param next - the slot of the next unused node in the slab; advanced past
+ *    the nodes taken.
+ **/
+static void __bst_build(bst_t* const tree, void** const arr, int n,
+                        __bst_slab_t* const slab, int* const next) {
+   int mid;
+
+   mid = n / 2;
+
+   tree->__elem = arr[mid];
+   tree->__left = (mid > 0 ? __bst_carve(tree, slab, next) : NULL);
+   tree->__right = (mid + 1 < n ? __bst_carve(tree, slab, next) : NULL);
+
+   if(tree->__left)
+      __bst_build(tree->__left, arr, mid, slab, next);
+
+   if(tree->__right)
+      __bst_build(tree->__right, arr + mid + 1, n - mid - 1, slab, next);
+
+   __bst_update(tree);
+}
+
+
+/**
+ * Take the next unused node of a slab, inheriting a tree's element size,
+ * comparator and allocator.
+ *
+ * @param tree - the tree the node will belong to.
+ * @param slab - the slab to take the node from.
+ * @param next - the slot of the node to take; advanced past it.
+ * @return the node, with no element or children yet.
+ **/
+static bst_t* __bst_carve(bst_t* const tree, __bst_slab_t* const slab,
+                          int* const next) {
+   bst_t *node;
+
+   node = &slab[(*next)++].node;
+
+   node->__elem = NULL;
+   node->__elem_size = tree->__elem_size;
+   node->__cmp = tree->__cmp;
+   node->__alloc = tree->__alloc;
+   node->__left = NULL;
+   node->__right = NULL;
+   node->__slab = slab;
+
+   return node;
+}
+
+
+/**
+ * Recompute the height and size of a tree from its children.
+ *
+ * @param tree - the tree to update.
+ **/
+static void __bst_update(bst_t* const tree) {
+   int lh, rh;
+
+   lh = __BST_HEIGHT(tree->__left);
+   rh = __BST_HEIGHT(tree->__right);
+
+   tree->__height = 1 + (lh > rh ? lh : rh);
+   tree->__size = 1 + __BST_SIZE(tree->__left) + __BST_SIZE(tree->__right);
+}
+
+
+/**
+ * Rotate a tree left. The right child's element moves up into this node and
+ * this node's element moves down into the (reused) right child node.
+ *
+ * @param tree - the tree to rotate; must have a right child.
+ **/
+static void __bst_rotl(bst_t* const tree) {
+   bst_t *node;
+   void *temp;
+
+   node = tree->__right;
+
+   temp = tree->__elem;
+   tree->__elem = node->__elem;
+   node->__elem = temp;
+
+   tree->__right = node->__right;
+   node->__right = node->__left;
+   node->__left = tree->__left;
+   tree->__left = node;
+
+   __bst_update(node);
+   __bst_update(tree);
+}
+
+
+/**
+ * Rotate a tree right. The left child's element moves up into this node and
+ * this node's element moves down into the (reused) left child node.
+ *
+ * @param tree - the tree to rotate; must have a left child.
+ **/
+static void __bst_rotr(bst_t* const tree) {
+   bst_t *node;
+   void *temp;
+
+   node = tree->__left;
+
+   temp = tree->__elem;
+   tree->__elem = node->__elem;
+   node->__elem = temp;
+
+   tree->__left = node->__left;
+   node->__left = node->__right;
+   node->__right = tree->__right;
+   tree->__right = node;
+
+   __bst_update(node);
+   __bst_update(tree);
+}
+
+
+/**
+ * Restore the AVL property at a tree whose subtrees are balanced but whose
+ * heights may differ by two.
+ *
+ * @param tree - the tree to balance.
+ **/
+static void __bst_balance(bst_t* const tree) {
+   bst_t *child;
+   int diff;
+
+   diff = __BST_HEIGHT(tree->__left) - __BST_HEIGHT(tree->__right);
+
+   /* Left heavy */
+   if(diff > 1) {
+      child = tree->__left;
+
+      if(__BST_HEIGHT(child->__left) < __BST_HEIGHT(child->__right))
+         __bst_rotl(child);
+
+      __bst_rotr(tree);
+   }
+
+   /* Right heavy */
+   else if(diff < -1) {
+      child = tree->__right;
+
+      if(__BST_HEIGHT(child->__right) < __BST_HEIGHT(child->__left))
+         __bst_rotr(child);
+
+      __bst_rotl(tree);
+   }
+}
+
+
+/**
+ * Replace a tree's contents with those of its only child and free the child
+ * node.
+ *
+ * @param tree - the tree to replace.
+ * @param child - the only child of the tree.
+ **/
+static void __bst_take(bst_t* const tree, bst_t* const child) {
+   tree->__elem = child->__elem;
+   tree->__left = child->__left;
+   tree->__right = child->__right;
+   tree->__height = child->__height;
+   tree->__size = child->__size;
+
+   __bst_release(child);
+}
+
+
+/**
+ * Remove an element from a non-empty tree.
+ *
+ * @param tree - the tree to remove the element from.
+ * @param elem - the element to remove.
+ * @param empty - set to 1 if the tree is left empty, in which case the caller
+ *    should free the node (unless it is the root of the whole tree).
+ * @return the removed element. Returns NULL if it does not exist.
+ **/
+static void* __bst_remove(bst_t* const tree, void* const elem,
+                          int* const empty) {
+   bst_t **child;
+   void *target;
+   int cmp, gone;
+
+   cmp = __BST_CMP(tree, elem);
+   gone = 0;
+
+   /* Not here; remove from left or right tree */
+   if(cmp != 0) {
+      child = (cmp < 0 ? &tree->__left : &tree->__right);
+
+      if(!*child) return NULL;
+
+      target = __bst_remove(*child, elem, &gone);
+
+      if(gone) {
+         __bst_release(*child);
+         *child = NULL;
+      }
+   }
+
+   /* Here; replace with the in-order successor */
+   else {
+      target = tree->__elem;
+
+      if(tree->__left && tree->__right) {
+         tree->__elem = __bst_popmin(tree->__right, &gone);
+
+         if(gone) {
+            __bst_release(tree->__right);
+            tree->__right = NULL;
+         }
+      }
+
+      /* Here; pull up the only child */
+      else if(tree->__left || tree->__right) {
+         __bst_take(tree, (tree->__left ? tree->__left : tree->__right));
+         return target;
+      }
+
+      /* Here; tree is now empty */
+      else {
+         tree->__elem = NULL;
+         tree->__height = 0;
+         tree->__size = 0;
+         *empty = 1;
+
+         return target;
+      }
+   }
+
+   if(target) {
+      __bst_update(tree);
+      __bst_balance(tree);
+   }
+
+   return target;
+}
+
+
+/**
+ * Remove the smallest element from a non-empty tree.
+ *
+ * @param tree - the tree to remove the element from.
+ * @param empty - set to 1 if the tree is left empty.
+ * @return the smallest element in the tree.
+ **/
+static void* __bst_popmin(bst_t* const tree, int* const empty) {
+   void *target;
+   int gone;
+
+   /* Smallest is here; pull up the right child if there is one */
+   if(!tree->__left) {
+      target = tree->__elem;
+
+      if(tree->__right)
+         __bst_take(tree, tree->__right);
+      else
+         *empty = 1;
+
+      return target;
+   }
+
+   gone = 0;
+   target = __bst_popmin(tree->__left, &gone);
+
+   if(gone) {
+      __bst_release(tree->__left);
+      tree->__left = NULL;
+   }
+
+   __bst_update(tree);
+   __bst_balance(tree);
+
+   return target;
+}
+
+
+/**
+ * Copy the elements of a non-empty tree into an array, in order.
+ *
+ * @param tree - the tree to copy.
+ * @param array - the array to copy into.
+ * @param pos - the next free index in the array; advanced past the elements.
+ **/
+static void __bst_inorder(bst_t* const tree, void** const array,
+                          int* const pos) {
+   if(tree->__left)
+      __bst_inorder(tree->__left, array, pos);
+
+   array[(*pos)++] = tree->__elem;
 
-   return (void**) array;
+   if(tree->__right)
+      __bst_inorder(tree->__right, array, pos);
 }
 
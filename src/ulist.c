@@ -0,0 +1,1123 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), free(...) */
+#include <string.h>     /* For memcpy(...), memmove(...) */
+#include "ulist.h"      /* For ulist_t, ul_itr_t */
+#include "ops.h"        /* For __DS_EQ(...) */
+#include "counters.h"   /* For __DS_COUNT(...), ... */
+
+
+#define ADDED 1
+#define EXIST 1
+#define UL_NODE 32      /* Elements per node */
+
+
+/**
+ * Internal node type. Only used in this file. Each node holds between one (1)
+ * and UL_NODE elements in the front of its elems array; there are no empty
+ * nodes in a list.
+ **/
+typedef struct __unode_s {
+   struct __unode_s *prev;
+   struct __unode_s *next;
+   int count;
+   void *elems[UL_NODE];
+} __unode_t;
+
+
+/**
+ * Internal unrolled linkedlist definition. __ops holds the element callbacks
+ * and __kind their classification (see ops.h). __DS_STATS (see counters.h)
+ * must stay the first member.
+ **/
+struct __ulist_s {
+   __DS_STATS
+   __unode_t *__first;
+   __unode_t *__last;
+   size_t __elem_size;
+   ds_ops_t __ops;
+   int __kind;
+   int __size;
+};
+
+
+/**
+ * The unrolled linkedlist iterator (see ulist.h). The cursor sits before
+ * __node->elems[__pos]; __pos may equal __node->count, meaning the cursor is
+ * between __node and the node after it. __last records whether the element
+ * most recently returned came from ui_next(...) (1) or ui_prev(...) (-1), or
+ * zero (0) if there is no such element to remove.
+ **/
+
+
+/* Local functions */
+static __unode_t* __ul_node_new(ulist_t* const list);
+static void __ul_link(ulist_t* const list, __unode_t* const prev,
+                      __unode_t* const node);
+static void __ul_unlink(ulist_t* const list, __unode_t* const node);
+static __unode_t* __ul_locate(ulist_t* const list, int index, int *pos);
+static int __ul_insert(ulist_t* const list, __unode_t **node, int *pos,
+                       void* const elem);
+static void* __ul_erase(ulist_t* const list, __unode_t *node, int index,
+                        __unode_t **cnode, int *cpos);
+static void __ul_merge(ulist_t* const list, __unode_t* const node,
+                       __unode_t **cnode, int *cpos);
+
+
+/**
+ * A simulated constructor for an unrolled linkedlist.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro ul_init(type), where type is the type that
+ * the user wishes to restrict the list to.
+ *
+ * @param __elem_size - the size of an element in the list.
+ * @return a pointer to an empty list. Returns a NULL pointer upon allocation
+ *    error.
+ **/
+ulist_t* __ul_init(size_t __elem_size) {
+   ulist_t *list;
+
+   list = malloc(sizeof(ulist_t));
+
+   /* Alloc error */
+   if(!list) return NULL;
+
+   /* Initialize */
+   list->__first = NULL;
+   list->__last = NULL;
+   list->__elem_size = __elem_size;
+   list->__ops = ds_ops_mem;
+   list->__kind = DS_K_MEM;
+   list->__size = 0;
+
+   __DS_STATS_INIT(list);
+   __DS_COUNT(list, allocs, 1);
+
+   return list;
+}
+
+
+/**
+ * A simulated destructor for an unrolled linkedlist.
+ *
+ * @param list - the list to destroy.
+ **/
+void ul_free(ulist_t* const list) {
+   if(!list) return;
+
+   ul_clear(list);   /* Remove elements in list */
+   free(list);
+}
+
+
+/**
+ * Allocate an empty, unlinked node.
+ *
+ * @param list - the list the node will belong to.
+ * @return a pointer to the new node. Returns a NULL pointer upon allocation
+ *    error.
+ **/
+static __unode_t* __ul_node_new(ulist_t* const list) {
+   __unode_t *node;
+
+   node = malloc(sizeof(__unode_t));
+
+   if(!node) return NULL;
+
+   __DS_COUNT(list, allocs, 1);
+
+   node->prev = NULL;
+   node->next = NULL;
+   node->count = 0;
+
+   return node;
+}
+
+
+/**
+ * Link a node into a list directly after prev, or at the front of the list if
+ * prev is NULL.
+ *
+ * @param list - the list to link the node into.
+ * @param prev - the node to link after, or NULL.
+ * @param node - the node to link.
+ **/
+static void __ul_link(ulist_t* const list, __unode_t* const prev,
+                      __unode_t* const node) {
+   node->prev = prev;
+   node->next = (prev ? prev->next : list->__first);
+
+   if(node->next)
+      node->next->prev = node;
+   else
+      list->__last = node;
+
+   if(prev)
+      prev->next = node;
+   else
+      list->__first = node;
+}
+
+
+/**
+ * Unlink a node from a list and release it. The node's elements are not
+ * touched.
+ *
+ * @param list - the list to unlink the node from.
+ * @param node - the node to unlink.
+ **/
+static void __ul_unlink(ulist_t* const list, __unode_t* const node) {
+   if(node->prev)
+      node->prev->next = node->next;
+   else
+      list->__first = node->next;
+
+   if(node->next)
+      node->next->prev = node->prev;
+   else
+      list->__last = node->prev;
+
+   free(node);
+}
+
+
+/**
+ * Find the node holding the element at a given index, walking node counts
+ * from whichever end of the list is nearer. An index equal to the size of the
+ * list locates the position just past the last element.
+ *
+ * @param list - the list to search.
+ * @param index - the index to locate, between 0 and the size of the list.
+ * @param pos - set to the position of the index within the returned node.
+ * @return the node containing the index. Returns a NULL pointer if the list
+ *    is empty.
+ **/
+static __unode_t* __ul_locate(ulist_t* const list, int index, int *pos) {
+   __unode_t *node;
+   int rem;
+
+   *pos = 0;
+
+   if(!list->__first) return NULL;
+
+   /* Just past the end */
+   if(index == list->__size) {
+      *pos = list->__last->count;
+      return list->__last;
+   }
+
+   __DS_COUNT(list, walks, 1);
+
+   /* Walk forward from the front */
+   if(index < (list->__size >> 1)) {
+      node = list->__first;
+
+      while(index >= node->count) {
+         index -= node->count;
+         node = node->next;
+         __DS_COUNT(list, steps, 1);
+      }
+
+      *pos = index;
+      return node;
+   }
+
+   /* Walk backward from the back */
+   node = list->__last;
+   rem = list->__size - index;
+
+   while(rem > node->count) {
+      rem -= node->count;
+      node = node->prev;
+      __DS_COUNT(list, steps, 1);
+   }
+
+   *pos = node->count - rem;
+   return node;
+}
+
+
+/**
+ * Insert an element before position *pos of *node. A full node is split in
+ * two, except at either end of the node, where the element goes to a
+ * neighbour with room or to a fresh node so that lists built by appending
+ * stay densely packed. On return (*node, *pos) is the position just after the
+ * inserted element.
+ *
+ * @param list - the list to insert into.
+ * @param node - the node to insert into; NULL only for an empty list.
+ * @param pos - the position within the node to insert at.
+ * @param elem - the element to insert.
+ * @return 1 if the element was inserted. Returns 0 upon allocation error.
+ **/
+static int __ul_insert(ulist_t* const list, __unode_t **node, int *pos,
+                       void* const elem) {
+   __unode_t *n, *m;
+   int i, half;
+
+   n = *node;
+   i = *pos;
+
+   /* First node of an empty list */
+   if(!n) {
+      n = __ul_node_new(list);
+
+      if(!n) return !ADDED;
+
+      __ul_link(list, NULL, n);
+      i = 0;
+   }
+
+   else if(n->count == UL_NODE) {
+      /* Past the end of a full node */
+      if(i == UL_NODE) {
+         if(n->next && n->next->count < UL_NODE) {
+            n = n->next;
+         }
+         else {
+            m = __ul_node_new(list);
+
+            if(!m) return !ADDED;
+
+            __ul_link(list, n, m);
+            n = m;
+         }
+
+         i = 0;
+      }
+
+      /* Before the start of a full node */
+      else if(i == 0) {
+         if(n->prev && n->prev->count < UL_NODE) {
+            n = n->prev;
+            i = n->count;
+         }
+         else {
+            m = __ul_node_new(list);
+
+            if(!m) return !ADDED;
+
+            __ul_link(list, n->prev, m);
+            n = m;
+         }
+      }
+
+      /* Split the node, moving its upper half into a new node */
+      else {
+         m = __ul_node_new(list);
+
+         if(!m) return !ADDED;
+
+         half = UL_NODE >> 1;
+
+         memcpy(m->elems, n->elems + half, sizeof(void*) * (UL_NODE - half));
+         __DS_COUNT(list, bytes_copied, sizeof(void*) * (UL_NODE - half));
+         m->count = UL_NODE - half;
+         n->count = half;
+
+         __ul_link(list, n, m);
+
+         if(i > half) {
+            n = m;
+            i -= half;
+         }
+      }
+   }
+
+   memmove(n->elems + i + 1, n->elems + i, sizeof(void*) * (n->count - i));
+   n->elems[i] = elem;
+   n->count++;
+
+   list->__size++;
+
+   __DS_COUNT(list, bytes_copied, sizeof(void*) * (n->count - 1 - i));
+   __DS_PEAK(list, peak_size, list->__size);
+
+   *node = n;
+   *pos = i + 1;
+
+   return ADDED;
+}
+
+
+/**
+ * Remove the element at a position within a node. Empty nodes are released
+ * and sparse nodes are merged with a neighbour. If a cursor is given, it is
+ * kept at the same logical position.
+ *
+ * @param list - the list to remove from.
+ * @param node - the node holding the element.
+ * @param index - the position of the element within the node.
+ * @param cnode - the node of a cursor to keep valid, or NULL.
+ * @param cpos - the position of the cursor to keep valid, or NULL.
+ * @return the removed element.
+ **/
+static void* __ul_erase(ulist_t* const list, __unode_t *node, int index,
+                        __unode_t **cnode, int *cpos) {
+   __unode_t *tnode;
+   void *elem;
+   int tpos;
+
+   /* Without a cursor, track a dummy one */
+   if(!cnode) {
+      tnode = NULL;
+      tpos = 0;
+      cnode = &tnode;
+      cpos = &tpos;
+   }
+
+   elem = node->elems[index];
+
+   node->count--;
+   memmove(node->elems + index, node->elems + index + 1,
+           sizeof(void*) * (node->count - index));
+   __DS_COUNT(list, bytes_copied, sizeof(void*) * (node->count - index));
+
+   list->__size--;
+
+   if(*cnode == node && *cpos > index)
+      (*cpos)--;
+
+   /* Release an empty node, moving the cursor off of it */
+   if(!node->count) {
+      if(*cnode == node) {
+         if(node->next) {
+            *cnode = node->next;
+            *cpos = 0;
+         }
+         else if(node->prev) {
+            *cnode = node->prev;
+            *cpos = node->prev->count;
+         }
+         else {
+            *cnode = NULL;
+            *cpos = 0;
+         }
+      }
+
+      __ul_unlink(list, node);
+      return elem;
+   }
+
+   /* Merge a sparse node into a neighbour */
+   if(node->count <= (UL_NODE >> 2)) {
+      if(node->next && node->count + node->next->count <= UL_NODE)
+         __ul_merge(list, node, cnode, cpos);
+      else if(node->prev && node->prev->count + node->count <= UL_NODE)
+         __ul_merge(list, node->prev, cnode, cpos);
+   }
+
+   return elem;
+}
+
+
+/**
+ * Merge the node after a given node into it. The combined elements must fit
+ * in a single node.
+ *
+ * @param list - the list holding the nodes.
+ * @param node - the node to merge its successor into.
+ * @param cnode - the node of a cursor to keep valid.
+ * @param cpos - the position of the cursor to keep valid.
+ **/
+static void __ul_merge(ulist_t* const list, __unode_t* const node,
+                       __unode_t **cnode, int *cpos) {
+   __unode_t *next;
+
+   next = node->next;
+
+   if(*cnode == next) {
+      *cnode = node;
+      *cpos += node->count;
+   }
+
+   memcpy(node->elems + node->count, next->elems, sizeof(void*) * next->count);
+   __DS_COUNT(list, bytes_copied, sizeof(void*) * next->count);
+   node->count += next->count;
+
+   __ul_unlink(list, next);
+}
+
+
+/**
+ * Gets the size of the list.
+ *
+ * @param list - the list to get the size of.
+ * @return the number of elements in the list. Returns -1 if the list is NULL.
+ **/
+int ul_size(ulist_t* const list) {
+   if(!list) return -1;
+
+   return list->__size;
+}
+
+
+/**
+ * Register the element callbacks used by ul_contains(...) and
+ * ul_indexof(...) to test elements for equality. Built-in callbacks from
+ * compare.h are inlined into the search loops. The callbacks are copied, so
+ * ops need not outlive the list.
+ *
+ * @param list - the list to configure.
+ * @param ops - the callbacks to use, or NULL to compare elements bytewise.
+ * @return 1 if the callbacks were registered. Returns 0 if the list is NULL.
+ **/
+int ul_setops(ulist_t* const list, const ds_ops_t* const ops) {
+   if(!list) return !ADDED;
+
+   list->__ops = (ops ? *ops : ds_ops_mem);
+   list->__kind = __ds_kind(ops);
+
+   return ADDED;
+}
+
+
+/**
+ * Inserts the specified element at the specified position in the specified
+ * list. Shifts the element currently at that position (if any) and any
+ * subsequent elements to the right (adds one to their indices).
+ *
+ * @param list - the list to add the specified element to.
+ * @param index - the index at which to insert the element.
+ * @param elem - the element to add to the list.
+ * @return 1 if the element was added. Returns 0 if the list is NULL, the
+ *    index is less than zero (0) or greater than the size of the list, or
+ *    upon allocation error.
+ **/
+int ul_add(ulist_t* const list, int index, void* const elem) {
+   __unode_t *node;
+   int pos;
+
+   if(!list) return !ADDED;
+
+   if(index < 0 || index > list->__size)
+      return !ADDED;
+
+   node = __ul_locate(list, index, &pos);
+
+   return __ul_insert(list, &node, &pos, elem);
+}
+
+
+/**
+ * Inserts the specified element at the front of the list.
+ *
+ * @param list - the list to add the element to.
+ * @param elem - the element to add.
+ * @return 1 if the element was added. Returns 0 if the list is NULL or upon
+ *    allocation error.
+ **/
+int ul_addf(ulist_t* const list, void* const elem) {
+   __unode_t *node;
+   int pos;
+
+   if(!list) return !ADDED;
+
+   node = list->__first;
+   pos = 0;
+
+   return __ul_insert(list, &node, &pos, elem);
+}
+
+
+/**
+ * Appends the specified element to the end of the list.
+ *
+ * @param list - the list to add the element to.
+ * @param elem - the element to add.
+ * @return 1 if the element was added. Returns 0 if the list is NULL or upon
+ *    allocation error.
+ **/
+int ul_addl(ulist_t* const list, void* const elem) {
+   __unode_t *node;
+   int pos;
+
+   if(!list) return !ADDED;
+
+   node = list->__last;
+   pos = (node ? node->count : 0);
+
+   return __ul_insert(list, &node, &pos, elem);
+}
+
+
+/**
+ * Removes all of the elements from the specified list, freeing each of them.
+ *
+ * @param list - the list to clear.
+ **/
+void ul_clear(ulist_t* const list) {
+   __unode_t *node, *next;
+   int i;
+
+   if(!list) return;
+
+   node = list->__first;
+
+   while(node) {
+      next = node->next;
+
+      for(i = 0; i < node->count; i++)
+         free(node->elems[i]);
+
+      free(node);
+      node = next;
+   }
+
+   list->__first = NULL;
+   list->__last = NULL;
+   list->__size = 0;
+}
+
+
+/**
+ * Determines if the specified list contains the specified element.
+ *
+ * @param list - the list to search through.
+ * @param elem - the element whose presence in the list is to be tested.
+ * @return 1 if the list contains the specified element. Returns 0 if the
+ *    list is NULL or does not contain the element.
+ **/
+int ul_contains(ulist_t* const list, void* const elem) {
+   return (ul_indexof(list, elem) >= 0 ? EXIST : !EXIST);
+}
+
+
+/**
+ * Gets the element at the specified index in the specified list.
+ *
+ * @param list - the list to get the element from.
+ * @param index - the index of the element.
+ * @return the element at the specified index. Returns NULL if the list is
+ *    NULL or the index is out of range.
+ **/
+void* ul_get(ulist_t* const list, int index) {
+   __unode_t *node;
+   int pos;
+
+   if(!list) return NULL;
+
+   if(index < 0 || index >= list->__size)
+      return NULL;
+
+   node = __ul_locate(list, index, &pos);
+
+   return node->elems[pos];
+}
+
+
+/**
+ * Gets the first element in the specified list.
+ *
+ * @param list - the list to get the element from.
+ * @return the first element in the list. Returns NULL if the list is NULL or
+ *    empty.
+ **/
+void* ul_first(ulist_t* const list) {
+   if(!list || !list->__first) return NULL;
+
+   return list->__first->elems[0];
+}
+
+
+/**
+ * Gets the last element in the specified list.
+ *
+ * @param list - the list to get the element from.
+ * @return the last element in the list. Returns NULL if the list is NULL or
+ *    empty.
+ **/
+void* ul_last(ulist_t* const list) {
+   if(!list || !list->__last) return NULL;
+
+   return list->__last->elems[list->__last->count - 1];
+}
+
+
+/**
+ * Searches for the first occurence of the specified element in the specified
+ * list. Elements are compared as set by ul_setops(...), bytewise by default.
+ *
+ * @param list - the list to search through.
+ * @param elem - the element to search for.
+ * @return the index of the first occurence of the element. Returns -1 if the
+ *    list is NULL or does not contain the element.
+ **/
+int ul_indexof(ulist_t* const list, void* const elem) {
+   __unode_t *node;
+   size_t num_bytes;
+   int i, base, kind;
+
+   if(!list) return -1;
+
+   num_bytes = list->__elem_size;
+   kind = list->__kind;
+   base = 0;
+
+   /* Scan each node's elements in order */
+   for(node = list->__first; node; node = node->next) {
+      for(i = 0; i < node->count; i++)
+         if(__DS_EQ(kind, list->__ops, elem, node->elems[i], num_bytes)) {
+            __DS_WALK(list, base + i + 1, 1);
+            return base + i;
+         }
+
+      base += node->count;
+   }
+
+   /* Element does not exist */
+   __DS_WALK(list, base, 1);
+   return -1;
+}
+
+
+/**
+ * Applies the specified function to each element in the specified list, from
+ * first to last.
+ *
+ * @param list - the list to apply the function to.
+ * @param funct - the function to apply to each element.
+ **/
+void ul_apply(ulist_t* const list, void (*funct)(void* const)) {
+   __unode_t *node;
+   int i;
+
+   if(!list) return;
+
+   for(node = list->__first; node; node = node->next)
+      for(i = 0; i < node->count; i++)
+         (funct)(node->elems[i]);
+}
+
+
+/**
+ * Apply a function over all the elements in a list, first to last, handing each
+ * call a user supplied context pointer so that results can be accumulated
+ * without global state.
+ *
+ * @param list - the list to apply an operation over.
+ * @param funct - the function to apply, where the first argument is an element
+ *    in the list and the second argument is ctx.
+ * @param ctx - the context passed to every call of funct.
+ **/
+void ul_apply_ctx(ulist_t* const list, void (*funct)(void* const, void*),
+                  void* ctx) {
+   __unode_t *node;
+   int i;
+
+   if(!list) return;
+
+   for(node = list->__first; node; node = node->next)
+      for(i = 0; i < node->count; i++)
+         (funct)(node->elems[i], ctx);
+}
+
+
+/**
+ * Visit the elements in a list, first to last, stopping at the first element
+ * for which the visitor returns nonzero. Searches such as "find the first
+ * match" can stop there instead of walking the whole list.
+ *
+ * @param list - the list to visit.
+ * @param visit - the visitor, where the first argument is an element in the
+ *    list and the second argument is ctx. Returns nonzero to stop.
+ * @param ctx - the context passed to every call of visit.
+ * @return the element the visit stopped at. Returns NULL if the visitor never
+ *    returned nonzero or the list is NULL.
+ **/
+void* ul_visit(ulist_t* const list, int (*visit)(void* const, void*),
+               void* ctx) {
+   __unode_t *node;
+   int i;
+
+   if(!list) return NULL;
+
+   for(node = list->__first; node; node = node->next)
+      for(i = 0; i < node->count; i++)
+         if((visit)(node->elems[i], ctx))
+            return node->elems[i];
+
+   return NULL;
+}
+
+
+/**
+ * Removes the element at the specified index in the specified list. Shifts
+ * remaining elements left one position (decrementing indices).
+ *
+ * @param list - the list to remove the element from.
+ * @param index - the index of the element to be removed.
+ * @return the removed element. Returns NULL if the list is NULL or the index
+ *    is out of range.
+ **/
+void* ul_rem(ulist_t* const list, int index) {
+   __unode_t *node;
+   int pos;
+
+   if(!list) return NULL;
+
+   if(index < 0 || index >= list->__size)
+      return NULL;
+
+   node = __ul_locate(list, index, &pos);
+
+   return __ul_erase(list, node, pos, NULL, NULL);
+}
+
+
+/**
+ * Removes the first element in the specified list.
+ *
+ * @param list - the list to remove the element from.
+ * @return the removed element. Returns NULL if the list is NULL or empty.
+ **/
+void* ul_remf(ulist_t* const list) {
+   if(!list || !list->__first) return NULL;
+
+   return __ul_erase(list, list->__first, 0, NULL, NULL);
+}
+
+
+/**
+ * Removes the last element in the specified list.
+ *
+ * @param list - the list to remove the element from.
+ * @return the removed element. Returns NULL if the list is NULL or empty.
+ **/
+void* ul_reml(ulist_t* const list) {
+   if(!list || !list->__last) return NULL;
+
+   return __ul_erase(list, list->__last, list->__last->count - 1, NULL, NULL);
+}
+
+
+/**
+ * Replaces the element at the specified index in the specified list.
+ *
+ * @param list - the list whose element is to be replaced.
+ * @param index - the index of the element to replace.
+ * @param elem - the element to store at the specified index.
+ * @return the element previously at the specified index. Returns NULL if the
+ *    list is NULL or the index is out of range.
+ **/
+void* ul_set(ulist_t* const list, int index, void* const elem) {
+   __unode_t *node;
+   void *former;
+   int pos;
+
+   if(!list) return NULL;
+
+   if(index < 0 || index >= list->__size)
+      return NULL;
+
+   node = __ul_locate(list, index, &pos);
+
+   former = node->elems[pos];
+   node->elems[pos] = elem;
+
+   return former;
+}
+
+
+/**
+ * Moves every element of other into list before the specified index, leaving
+ * other empty. Nodes are relinked rather than copied; at most one node of
+ * list is split, so the cost beyond finding the index is constant.
+ *
+ * @param list - the list to splice elements into.
+ * @param index - the index at which to insert the elements of other.
+ * @param other - the list whose elements are moved. It remains valid and
+ *    must still be freed.
+ * @return 1 if the elements were moved. Returns 0 if either list is NULL, the
+ *    lists are the same, their element sizes differ, the index is out of
+ *    range, or upon allocation error.
+ **/
+int ul_splice(ulist_t* const list, int index, ulist_t* const other) {
+   __unode_t *node, *prev, *next, *m;
+   int pos;
+
+   if(!list || !other || list == other) return !ADDED;
+
+   if(list->__elem_size != other->__elem_size) return !ADDED;
+
+   if(index < 0 || index > list->__size)
+      return !ADDED;
+
+   if(!other->__first) return ADDED;
+
+   node = __ul_locate(list, index, &pos);
+
+   /* Find the nodes to splice between */
+   if(!node) {
+      prev = NULL;
+      next = NULL;
+   }
+   else if(pos == 0) {
+      prev = node->prev;
+      next = node;
+   }
+   else if(pos == node->count) {
+      prev = node;
+      next = node->next;
+   }
+
+   /* Split the node at the index */
+   else {
+      m = __ul_node_new(list);
+
+      if(!m) return !ADDED;
+
+      memcpy(m->elems, node->elems + pos, sizeof(void*) * (node->count - pos));
+      __DS_COUNT(list, bytes_copied, sizeof(void*) * (node->count - pos));
+      m->count = node->count - pos;
+      node->count = pos;
+
+      __ul_link(list, node, m);
+
+      prev = node;
+      next = m;
+   }
+
+   /* Link other's chain between prev and next */
+   other->__first->prev = prev;
+   other->__last->next = next;
+
+   if(prev)
+      prev->next = other->__first;
+   else
+      list->__first = other->__first;
+
+   if(next)
+      next->prev = other->__last;
+   else
+      list->__last = other->__last;
+
+   list->__size += other->__size;
+   __DS_PEAK(list, peak_size, list->__size);
+
+   other->__first = NULL;
+   other->__last = NULL;
+   other->__size = 0;
+
+   return ADDED;
+}
+
+
+/**
+ * Creates an array containing all of the elements in the specified list in
+ * order.
+ *
+ * @param list - the list to build an array from.
+ * @return an array of the elements in the list. Returns NULL if the list is
+ *    NULL or upon allocation error.
+ **/
+void** ul_toarr(ulist_t* const list) {
+   __unode_t *node;
+   void **array;
+   int base;
+
+   if(!list) return NULL;
+
+   array = malloc(sizeof(void*) * list->__size);
+
+   if(!array) return NULL;
+
+   /* Copy each node's elements in a block */
+   base = 0;
+
+   for(node = list->__first; node; node = node->next) {
+      memcpy(array + base, node->elems, sizeof(void*) * node->count);
+      base += node->count;
+   }
+
+   return array;
+}
+
+
+/** Unrolled Linkedlist Iterator Functions **/
+
+/**
+ * A simulated constructor for an unrolled linkedlist iterator. The iterator
+ * starts before the element at the specified index. Modifying the list other
+ * than through the iterator invalidates the iterator.
+ *
+ * @param list - the list to iterate over.
+ * @param index - the starting index, between 0 and the size of the list.
+ * @return a pointer to an iterator. Returns NULL if the list is NULL, the
+ *    index is out of range, or upon allocation error.
+ **/
+ul_itr_t* ul_itr(ulist_t* const list, int index) {
+   ul_itr_t *iterator;
+
+   iterator = malloc(sizeof(ul_itr_t));
+
+   if(!iterator) return NULL;
+
+   if(!ul_itr_init(iterator, list, index)) {
+      free(iterator);
+      return NULL;
+   }
+
+   return iterator;
+}
+
+
+/**
+ * Set up a caller provided iterator, typically one declared on the stack,
+ * over a list starting before the element at the specified index. The
+ * iterator must not be passed to ui_free(...).
+ *
+ * @param itr - the iterator to set up.
+ * @param list - the list to iterate over.
+ * @param index - the starting index, between 0 and the size of the list.
+ * @return 1 if the iterator was set up. Returns 0 if the iterator or list is
+ *    NULL or the index is out of range.
+ **/
+int ul_itr_init(ul_itr_t* const itr, ulist_t* const list, int index) {
+   if(!itr || !list) return !ADDED;
+
+   if(index < 0 || index > list->__size)
+      return !ADDED;
+
+   itr->__list = list;
+   itr->__node = __ul_locate(list, index, &itr->__pos);
+   itr->__last = 0;
+
+   return ADDED;
+}
+
+
+/**
+ * A simulated destructor for an unrolled linkedlist iterator.
+ *
+ * @param itr - the iterator to destroy.
+ **/
+void ui_free(ul_itr_t* const itr) {
+   free(itr);
+}
+
+
+/**
+ * Determines if the iterator has a next element.
+ *
+ * @param itr - the iterator to check.
+ * @return 1 if there is an element after the cursor. Returns 0 otherwise.
+ **/
+int ui_hasnext(ul_itr_t* const itr) {
+   if(!itr || !itr->__node) return !EXIST;
+
+   return (itr->__pos < itr->__node->count || itr->__node->next ? EXIST :
+           !EXIST);
+}
+
+
+/**
+ * Determines if the iterator has a previous element.
+ *
+ * @param itr - the iterator to check.
+ * @return 1 if there is an element before the cursor. Returns 0 otherwise.
+ **/
+int ui_hasprev(ul_itr_t* const itr) {
+   if(!itr || !itr->__node) return !EXIST;
+
+   return (itr->__pos > 0 || itr->__node->prev ? EXIST : !EXIST);
+}
+
+
+/**
+ * Moves the iterator ahead one element.
+ *
+ * @param itr - the iterator to advance.
+ * @return the element passed over. Returns NULL if there is no next element.
+ **/
+void* ui_next(ul_itr_t* const itr) {
+   if(!ui_hasnext(itr)) return NULL;
+
+   /* Step onto the next node */
+   if(itr->__pos == itr->__node->count) {
+      itr->__node = itr->__node->next;
+      itr->__pos = 0;
+   }
+
+   itr->__last = 1;
+
+   return itr->__node->elems[itr->__pos++];
+}
+
+
+/**
+ * Moves the iterator back one element.
+ *
+ * @param itr - the iterator to move back.
+ * @return the element passed over. Returns NULL if there is no previous
+ *    element.
+ **/
+void* ui_prev(ul_itr_t* const itr) {
+   if(!ui_hasprev(itr)) return NULL;
+
+   /* Step onto the previous node */
+   if(itr->__pos == 0) {
+      itr->__node = itr->__node->prev;
+      itr->__pos = itr->__node->count;
+   }
+
+   itr->__last = -1;
+
+   return itr->__node->elems[--itr->__pos];
+}
+
+
+/**
+ * Inserts an element at the iterator's cursor. A following ui_next(...)
+ * is unaffected, while ui_prev(...) would return the new element.
+ *
+ * @param itr - the iterator to insert at.
+ * @param elem - the element to insert.
+ * @return 1 if the element was added. Returns 0 if the iterator is NULL or
+ *    upon allocation error.
+ **/
+int ui_add(ul_itr_t* const itr, void* const elem) {
+   if(!itr) return !ADDED;
+
+   itr->__last = 0;
+
+   return __ul_insert(itr->__list, &itr->__node, &itr->__pos, elem);
+}
+
+
+/**
+ * Removes the element most recently returned by ui_next(...) or ui_prev(...).
+ * May be called once per call to either.
+ *
+ * @param itr - the iterator to remove through.
+ * @return the removed element. Returns NULL if the iterator is NULL or there
+ *    is no element to remove.
+ **/
+void* ui_rem(ul_itr_t* const itr) {
+   int index;
+
+   if(!itr || !itr->__last) return NULL;
+
+   index = (itr->__last > 0 ? itr->__pos - 1 : itr->__pos);
+   itr->__last = 0;
+
+   return __ul_erase(itr->__list, itr->__node, index, &itr->__node,
+                     &itr->__pos);
+}
@@ -16,69 +16,204 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see {http://www.gnu.org/licenses/}.
  **/
+#ifdef __linux__
+#define _GNU_SOURCE     /* For mremap(...) */
+#else
+#define _POSIX_C_SOURCE 200112L  /* For munmap(...), sysconf(...) */
+#endif
 #include <stdlib.h>     /* For malloc(...), free(...) */
 #include <string.h>     /* For memcmp(...), memcpy(...) */
+#include <sys/mman.h>   /* For mmap(...), mremap(...), munmap(...) */
+#include <unistd.h>     /* For sysconf(...) */
+#undef DSTRUCTS_INLINE  /* The out-of-line accessors are defined here */
 #include "vector.h"
+#include "layout.h"     /* For struct __vect_s */
+#include "ops.h"        /* For __DS_EQ(...) */
+#include "simd.h"       /* For __ds_simd_find32(...), ... */
+#include "pool.h"       /* For __ds_pool_run(...) */
+#include "mem.h"        /* For __DS_ALLOC(...), ... */
+#include "counters.h"   /* For __DS_COUNT(...), ... */
+#include "snapshot.h"   /* For __ds_snap_open(...), ... */
 
 #define INIT_SIZE 10
+#define SORT_SMALL 16   /* Ranges this short are left for insertion sort */
+#define RADIX_MIN 64    /* Shorter integer vectors are not radix sorted */
+#define PAR_CHUNKS 4    /* Chunks per thread for parallel apply */
+#define PAR_MIN 1024    /* Fewest elements per chunk for parallel apply */
+#define SIMD_MAX ((ds_idx_t) 1 << 30)  /* Most elements per SIMD kernel call */
 #define ADDED 1
 #define EXIST 1
 
+/* Buffers at least this large are mapped when V_GROW_MMAP is set */
+#define MMAP_MIN ((size_t) 1 << 24)
+
 
 /* Local functions */
-static void __v_expand(vect_t* const v);
+static vect_t* __v_create(size_t __elem_size, int __inl, ds_idx_t cap,
+                          ds_allocator_t* const alloc);
+static int __v_expand(vect_t* const v, ds_idx_t need);
+static int __v_resize(vect_t* const v, ds_idx_t cap);
+static void __v_release(vect_t* const v);
+static ds_idx_t __v_find(vect_t* const v, const void* const elem);
+static ds_idx_t __v_search(vect_t* const v, const void* const elem);
+static ds_idx_t __v_extreme(vect_t* const v, int max);
+static ds_cmp_t __v_cmp(vect_t* const v, ds_cmp_t cmp);
+static void __v_swap(char *a, char *b, size_t n);
+static void __v_introsort(vect_t* const v, ds_cmp_t cmp, ds_idx_t lo,
+                          ds_idx_t hi, int depth);
+static void __v_heapsort(vect_t* const v, ds_cmp_t cmp, ds_idx_t lo,
+                         ds_idx_t hi);
+static int __v_radix32(uint32_t *a, ds_idx_t n, uint32_t flip);
+static int __v_radix64(uint64_t *a, ds_idx_t n, uint64_t flip);
+static void __v_apply_task(void* ctx, int task);
+static void __v_map_task(void* ctx, int task);
+static int __v_chunks(vect_t* const v, int nthreads);
+static void* __v_elem(vect_t* const v, ds_idx_t index);
+static void __v_store(vect_t* const v, ds_idx_t index, void* const elem);
+
+
+/* Address of the slot at the specified index */
+#define __V_SLOT(v, i) ((v)->__elements + (size_t) (i) * (v)->__stride)
+
+/* Number of bytes needed to hold cap slots (plus inline scratch slot) */
+#define __V_BYTES(v, cap) (((size_t) (cap) + (v)->__inl) * (v)->__stride)
+
+/* Whether __V_BYTES(...) of cap slots of a stride can be held in a size_t */
+#define __V_FITS(stride, inl, cap) \
+   ((size_t) (cap) <= (size_t) -1 / (stride) - (inl))
+
 
 
 /**
- * Internal vector definition.
+ * A simulated constructor for a vector. Creates a vector has an initial
+ * capacity of 10 elements.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro v_init(type), where type is the type that
+ * the user wishes to restrict the list to.
+ *
+ * @param __elem_size - the size of an element in the vector.
+ * @return a pointer to an empty vector. Returns a NULL pointer upon allocation
+ *    error.
  **/
-struct __vect_s {
-   int **__elements;
-   size_t __elem_size;
-   int __cap;
-   int __size;
-};
+vect_t* __v_init(size_t __elem_size) {
+   return __v_create(__elem_size, 0, INIT_SIZE, NULL);
+}
 
 
 /**
- * Internal vector iterator definition.
+ * A simulated constructor for a vector with a chosen initial capacity. Use
+ * when the final size is known up front to avoid expanding at all.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro v_init_cap(type, n) or
+ * v_init_inline_cap(type, n).
+ *
+ * @param __elem_size - the size of an element in the vector.
+ * @param __inl - nonzero to store elements inline.
+ * @param n - the initial capacity of the vector.
+ * @return a pointer to an empty vector. Returns a NULL pointer if n is
+ *    negative, too large for the buffer to be sized in a size_t, or upon
+ *    allocation error.
  **/
-struct __v_itr_s {
-   vect_t *vector;
-   int pos;
-};
+vect_t* __v_init_cap(size_t __elem_size, int __inl, ds_idx_t n) {
+   if(n < 0) return NULL;
 
+   return __v_create(__elem_size, __inl, n, NULL);
+}
 
 
 /**
- * A simulated constructor for a vector. Creates a vector has an initial
- * capacity of 10 elements.
+ * A simulated constructor for an inline vector. Rather than storing pointers
+ * to caller-owned elements, an inline vector copies each element into one
+ * contiguous buffer. Adding an element never allocates on its own, and
+ * pointers returned by v_get(...) point into the vector's storage; they are
+ * only valid until the next call that modifies the vector.
  *
  * NOTE: This is a function that is not intended for use by the user. The user
- * should instead use the macro v_init(type), where type is the type that
- * the user wishes to restrict the list to.
+ * should instead use the macro v_init_inline(type).
+ *
+ * @param __elem_size - the size of an element in the vector.
+ * @return a pointer to an empty inline vector. Returns a NULL pointer upon
+ *    allocation error.
+ **/
+vect_t* __v_init_inline(size_t __elem_size) {
+   return __v_create(__elem_size, 1, INIT_SIZE, NULL);
+}
+
+
+/**
+ * A simulated constructor for a vector whose memory all comes from a user
+ * allocator: the vector, its buffer, and, for a plain vector, the release of
+ * the elements it frees. Elements handed to such a vector must therefore
+ * come from the same allocator. The allocator must outlive the vector.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro v_init_alloc(type, alloc) or
+ * v_init_inline_alloc(type, alloc).
  *
  * @param __elem_size - the size of an element in the vector.
+ * @param __inl - nonzero to store elements inline.
+ * @param alloc - the allocator to use, or NULL for the C library.
  * @return a pointer to an empty vector. Returns a NULL pointer upon allocation
  *    error.
  **/
-vect_t* __v_init(size_t __elem_size) {
+vect_t* __v_init_alloc(size_t __elem_size, int __inl,
+                       ds_allocator_t* const alloc) {
+   return __v_create(__elem_size, __inl, INIT_SIZE, alloc);
+}
+
+
+/**
+ * Common constructor for both vector storage modes.
+ *
+ * @param __elem_size - the size of an element in the vector.
+ * @param __inl - nonzero to store elements inline.
+ * @param cap - the initial capacity; at least one (1) slot is allocated.
+ * @param alloc - the allocator to use, or NULL for the C library.
+ * @return a pointer to an empty vector. Returns a NULL pointer if cap slots
+ *    cannot be sized in a size_t or upon allocation error.
+ **/
+static vect_t* __v_create(size_t __elem_size, int __inl, ds_idx_t cap,
+                          ds_allocator_t* const alloc) {
    vect_t *vector;
+   size_t bytes;
 
-   vector = malloc(sizeof(vect_t));
+   if(!__V_FITS(__inl ? __elem_size : sizeof(void*), __inl ? 1 : 0, cap))
+      return NULL;
+
+   vector = __DS_ALLOC(alloc, sizeof(vect_t));
 
    if(!vector) return NULL;
 
-   vector->__elements = calloc(INIT_SIZE, sizeof(void*));
+   vector->__alloc = alloc;
+   vector->__elem_size = __elem_size;
+   vector->__stride = (__inl ? __elem_size : sizeof(void*));
+   vector->__file = NULL;
+   vector->__mapped = 0;
+   vector->__ops = ds_ops_mem;
+   vector->__kind = DS_K_MEM;
+   vector->__inl = (__inl ? 1 : 0);
+   vector->__growth = V_GROW_DOUBLE;
+   vector->__chunk = 0;
+   vector->__cap = (cap > 0 ? cap : 1);
+   vector->__size = 0;
+
+   bytes = __V_BYTES(vector, vector->__cap);
+
+   if(!alloc)
+      vector->__elements = calloc(1, bytes);
+   else if((vector->__elements = alloc->alloc(alloc->ctx, bytes)))
+      memset(vector->__elements, 0, bytes);
 
    if(!vector->__elements) {
-      free(vector);
+      __DS_FREE(alloc, vector, sizeof(vect_t));
       return NULL;
    }
 
-   vector->__elem_size = __elem_size;
-   vector->__cap = INIT_SIZE;
-   vector->__size = 0;
+   __DS_STATS_INIT(vector);
+   __DS_COUNT(vector, allocs, 2);
+   __DS_PEAK(vector, peak_cap, vector->__cap);
 
    return vector;
 }
@@ -93,8 +228,8 @@ void v_free(vect_t* const v) {
    if(!v) return;
 
    v_clear(v);          /* Remove elements in vector */
-   free(v->__elements);
-   free(v);
+   __v_release(v);
+   __DS_FREE(v->__alloc, v, sizeof(vect_t));
 }
 
 
@@ -104,7 +239,7 @@ void v_free(vect_t* const v) {
  * @param v - the vector to retrieve the size of.
  * @return the length of the vector. Returns -1 if the vector is NULL.
  **/
-int v_size(vect_t* const v) {
+ds_idx_t v_size(vect_t* const v) {
    return (v ? v->__size : -1);
 }
 
@@ -115,22 +250,279 @@ int v_size(vect_t* const v) {
  * @param v - the vector to retrieve the capacity of.
  * @return the capacity of the vector. Returns -1 if the vector is NULL.
  **/
-int v_cap(vect_t* const v) {
+ds_idx_t v_cap(vect_t* const v) {
    return (v ? v->__cap : -1);
 }
 
 
 /**
- * If a vector is full, expand it by a factor of 2 times its capacity plus 1.
- * In other words expand by ((2 * v->__cap) + 1).
+ * Register the element callbacks used by v_contains(...) and
+ * v_indexof(...) to test elements for equality. Built-in callbacks from
+ * compare.h are inlined into the search loops. The callbacks are copied, so
+ * ops need not outlive the vector.
+ *
+ * @param v - the vector to configure.
+ * @param ops - the callbacks to use, or NULL to compare elements bytewise.
+ * @return 1 if the callbacks were registered. Returns 0 if the vector is
+ *    NULL.
+ **/
+int v_setops(vect_t* const v, const ds_ops_t* const ops) {
+   if(!v) return !ADDED;
+
+   v->__ops = (ops ? *ops : ds_ops_mem);
+   v->__kind = __ds_kind(ops);
+
+   return ADDED;
+}
+
+
+/**
+ * Select how a vector expands when it runs out of room.
+ *
+ *    V_GROW_DOUBLE  - grow to ((2 * capacity) + 1). The default.
+ *    V_GROW_HALF    - grow by half again, trading more frequent expansion
+ *                     for less unused space.
+ *    V_GROW_CHUNK   - grow by chunk elements at a time, bounding the unused
+ *                     space of very large vectors.
+ *
+ * Any policy may be combined with V_GROW_MMAP (e.g.
+ * V_GROW_HALF | V_GROW_MMAP). On Linux, buffers of 16 MiB and up are then
+ * placed in their own memory mapping and grown with mremap(...), which moves
+ * page tables instead of copying elements. Elsewhere, and for vectors with an
+ * allocator, the flag is ignored.
+ *
+ * @param v - the vector to configure.
+ * @param policy - the growth policy.
+ * @param chunk - the number of elements to grow by for V_GROW_CHUNK. Ignored
+ *    otherwise.
+ * @return 1 if the policy was set. Returns 0 if the vector is NULL, the
+ *    policy is unknown, or chunk is not positive for V_GROW_CHUNK.
+ **/
+int v_growth(vect_t* const v, int policy, ds_idx_t chunk) {
+   if(!v) return !ADDED;
+
+   switch(policy & ~V_GROW_MMAP) {
+      case V_GROW_DOUBLE:
+      case V_GROW_HALF:
+         break;
+
+      case V_GROW_CHUNK:
+         if(chunk <= 0) return !ADDED;
+         break;
+
+      default:
+         return !ADDED;
+   }
+
+   v->__growth = policy;
+   v->__chunk = chunk;
+
+   return ADDED;
+}
+
+
+/**
+ * Expand a vector so that it can hold at least need elements. The capacity
+ * grows according to the vector's growth policy, or straight to need if that
+ * is not enough. Either way the buffer is reallocated only once.
  *
  * @param v - the vector to expand.
+ * @param need - the number of elements the vector must be able to hold.
+ * @return 1 if the vector was expanded. Returns 0 upon allocation error, in
+ *    which case the vector is left unchanged.
+ **/
+static int __v_expand(vect_t* const v, ds_idx_t need) {
+   ds_idx_t cap, step;
+
+   switch(v->__growth & ~V_GROW_MMAP) {
+      case V_GROW_HALF:
+         step = (v->__cap >> 1) + 1;
+         break;
+
+      case V_GROW_CHUNK:
+         step = v->__chunk;
+         break;
+
+      default:
+         step = v->__cap + 1;
+         break;
+   }
+
+   /* Clamp rather than overflow */
+   cap = (v->__cap > DS_IDX_MAX - step ? DS_IDX_MAX : v->__cap + step);
+
+   if(cap < need)
+      cap = need;
+
+   return __v_resize(v, cap);
+}
+
+
+/**
+ * Reallocate a vector's buffer to hold exactly cap slots. Mapped buffers are
+ * resized with mremap(...); malloc'd buffers large enough to be mapped under
+ * V_GROW_MMAP move into a mapping. A vector opened from a snapshot moves to
+ * the heap, releasing the snapshot's mapping.
+ *
+ * @param v - the vector to resize.
+ * @param cap - the new capacity; must hold the vector's elements.
+ * @return 1 if the buffer was resized. Returns 0 upon allocation error, in
+ *    which case the vector is left unchanged.
+ **/
+static int __v_resize(vect_t* const v, ds_idx_t cap) {
+   char *elements;
+   size_t bytes;
+#ifdef __linux__
+   size_t page;
+#endif
+
+   if(cap < 1) cap = 1;
+
+   if(!__V_FITS(v->__stride, v->__inl, cap)) return !ADDED;
+
+   bytes = __V_BYTES(v, cap);
+
+   if(v->__file) {
+      elements = malloc(bytes);
+
+      if(!elements) return !ADDED;
+
+      memcpy(elements, v->__elements, __V_BYTES(v, v->__size));
+      munmap(v->__file, v->__mapped);
+
+      __DS_COUNT(v, reallocs, 1);
+      __DS_COUNT(v, bytes_copied, __V_BYTES(v, v->__size));
+
+      v->__elements = elements;
+      v->__file = NULL;
+      v->__mapped = 0;
+      v->__cap = cap;
+
+      __DS_PEAK(v, peak_cap, cap);
+
+      return ADDED;
+   }
+
+#ifdef __linux__
+   if(v->__mapped || ((v->__growth & V_GROW_MMAP) && bytes >= MMAP_MIN &&
+                      !v->__alloc)) {
+      page = (size_t) sysconf(_SC_PAGESIZE);
+      bytes = (bytes + page - 1) / page * page;
+
+      if(v->__mapped)
+         elements = mremap(v->__elements, v->__mapped, bytes, MREMAP_MAYMOVE);
+      else
+         elements = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+      if(elements == MAP_FAILED) return !ADDED;
+
+      /* Moving out of the heap costs a single copy */
+      if(!v->__mapped) {
+         memcpy(elements, v->__elements, __V_BYTES(v, v->__size));
+         free(v->__elements);
+         __DS_COUNT(v, bytes_copied, __V_BYTES(v, v->__size));
+      }
+
+      v->__elements = elements;
+      v->__mapped = bytes;
+      v->__cap = (ds_idx_t) (bytes / v->__stride - v->__inl);
+
+      if(v->__cap < cap) v->__cap = cap;
+
+      __DS_COUNT(v, reallocs, 1);
+      __DS_PEAK(v, peak_cap, v->__cap);
+
+      return ADDED;
+   }
+#endif
+
+   elements = __DS_REALLOC(v->__alloc, v->__elements,
+                           __V_BYTES(v, v->__cap), bytes);
+
+   if(!elements) return !ADDED;
+
+   __DS_COUNT(v, reallocs, 1);
+   __DS_COUNT(v, bytes_copied, __V_BYTES(v, v->__size));
+
+   v->__elements = elements;
+   v->__cap = cap;
+
+   __DS_PEAK(v, peak_cap, cap);
+
+   return ADDED;
+}
+
+
+/**
+ * Release a vector's buffer, however it was obtained.
+ *
+ * @param v - the vector whose buffer to release.
+ **/
+static void __v_release(vect_t* const v) {
+   if(v->__file) {
+      munmap(v->__file, v->__mapped);
+      return;
+   }
+
+#ifdef __linux__
+   if(v->__mapped) {
+      munmap(v->__elements, v->__mapped);
+      return;
+   }
+#endif
+
+   __DS_FREE(v->__alloc, v->__elements, __V_BYTES(v, v->__cap));
+}
+
+
+/**
+ * Ensure a vector can hold at least the specified number of elements without
+ * having to expand.
+ *
+ * @param v - the vector to reserve space in.
+ * @param n - the minimum capacity of the vector.
+ * @return 1 if the vector can hold n elements. Returns 0 if the vector is
+ *    NULL, n is negative, or upon allocation error.
+ **/
+int v_reserve(vect_t* const v, ds_idx_t n) {
+   if(!v || n < 0) return !ADDED;
+
+   if(n <= v->__cap) return ADDED;
+
+   return __v_resize(v, n);
+}
+
+
+/**
+ * Retrieve the element stored in a slot. For inline vectors this is the
+ * address of the slot itself.
+ *
+ * @param v - the vector to retrieve the element from.
+ * @param index - the index of the slot (assumed to be in range).
+ * @return the element at the specified index.
  **/
-static void __v_expand(vect_t* const v) {
-   v->__cap <<= 1;
-   v->__cap++;
+static void* __v_elem(vect_t* const v, ds_idx_t index) {
+   if(v->__inl)
+      return __V_SLOT(v, index);
+
+   return *((void**) __V_SLOT(v, index));
+}
+
 
-   v->__elements = realloc(v->__elements, v->__cap * sizeof(void*));
+/**
+ * Store an element in a slot. Inline vectors copy the element's bytes into
+ * the slot; pointer vectors store the pointer itself.
+ *
+ * @param v - the vector to store the element in.
+ * @param index - the index of the slot (assumed to be in range).
+ * @param elem - the element to store.
+ **/
+static void __v_store(vect_t* const v, ds_idx_t index, void* const elem) {
+   if(v->__inl)
+      memcpy(__V_SLOT(v, index), elem, v->__elem_size);
+   else
+      *((void**) __V_SLOT(v, index)) = elem;
 }
 
 
@@ -145,24 +537,28 @@ static void __v_expand(vect_t* const v) {
  *    NULL, or if the specified index is less than zero (0) or larger than the
  *    size of the vector.
  **/
-int v_add(vect_t* const v, int index, void* const elem) {
-   int i, size;
-
+int v_add(vect_t* const v, ds_idx_t index, void* const elem) {
    if(!v) return !ADDED;
 
    if(index < 0 || index > v->__size)
       return !ADDED;
 
-   size = ++v->__size;
+   if(v->__inl && !elem)
+      return !ADDED;
 
-   if(size == v->__cap)
-      __v_expand(v);
+   if(v->__size == v->__cap)
+      if(!__v_expand(v, v->__size + 1))
+         return !ADDED;
 
    /* Move elements right one position */
-   for(i = size; i > index; i--)
-      v->__elements[i] = v->__elements[i - 1];
+   memmove(__V_SLOT(v, index + 1), __V_SLOT(v, index),
+           (size_t) (v->__size - index) * v->__stride);
+
+   __v_store(v, index, elem);
+   v->__size++;
 
-   v->__elements[index] = elem;
+   __DS_COUNT(v, bytes_copied, (size_t) (v->__size - 1 - index) * v->__stride);
+   __DS_PEAK(v, peak_size, v->__size);
 
    return ADDED;
 }
@@ -192,14 +588,156 @@ void v_addl(vect_t* const v, void* const elem) {
 }
 
 
+/**
+ * Append a specified element to the end of this vector. For inline vectors
+ * the element is copied into the vector's storage, so the caller may reuse or
+ * discard elem afterwards.
+ *
+ * @param v - the vector to add the specified element to.
+ * @param elem - the element to add to the vector.
+ * @return 1 if the element is added to the vector. Returns 0 if the vector is
+ *    NULL.
+ **/
+int v_push(vect_t* const v, void* const elem) {
+   if(!v) return !ADDED;
+
+   return v_add(v, v->__size, elem);
+}
+
+
+/**
+ * Replaces a range of elements in a vector with the contents of an array. The
+ * elements after the range are shifted once, by a single bulk move, and the
+ * vector grows at most once.
+ *
+ * For pointer vectors, arr and out are arrays of element pointers. For inline
+ * vectors they hold elements back to back, exactly as the vector stores them.
+ *
+ * @param v - the vector to splice.
+ * @param index - the index of the first element to replace.
+ * @param nrem - the number of elements to remove, starting at index.
+ * @param arr - the elements to insert at index. May be NULL if nins is zero.
+ * @param nins - the number of elements in arr.
+ * @param out - if not NULL, receives the removed elements. Otherwise removed
+ *    elements of a pointer vector have free(...) applied to them, as
+ *    v_clear(...) does.
+ * @return 1 if the vector was spliced. Returns 0 if the vector is NULL, the
+ *    range is out of bounds, or upon allocation error, in which case the
+ *    vector is left unchanged.
+ **/
+int v_splice(vect_t* const v, ds_idx_t index, ds_idx_t nrem, void* const arr,
+             ds_idx_t nins, void* const out) {
+   ds_idx_t i, size, tail;
+
+   if(!v) return !ADDED;
+
+   if(index < 0 || index > v->__size || nrem < 0 || nins < 0)
+      return !ADDED;
+
+   if(nrem > v->__size - index || (nins && !arr))
+      return !ADDED;
+
+   size = v->__size - nrem + nins;
+
+   /* Grow first so that failure leaves the vector untouched */
+   if(size > v->__cap)
+      if(!__v_expand(v, size))
+         return !ADDED;
+
+   /* Hand back or release the removed elements */
+   if(out)
+      memcpy(out, __V_SLOT(v, index), (size_t) nrem * v->__stride);
+   else if(!v->__inl)
+      for(i = 0; i < nrem; i++)
+         __DS_FREE(v->__alloc, __v_elem(v, index + i), v->__elem_size);
+
+   /* Shift the tail once, then copy the new elements into the gap */
+   tail = v->__size - index - nrem;
+
+   memmove(__V_SLOT(v, index + nins), __V_SLOT(v, index + nrem),
+           (size_t) tail * v->__stride);
+
+   if(nins)
+      memcpy(__V_SLOT(v, index), arr, (size_t) nins * v->__stride);
+
+   v->__size = size;
+
+   __DS_COUNT(v, bytes_copied, (size_t) tail * v->__stride);
+   __DS_PEAK(v, peak_size, size);
+
+   return ADDED;
+}
+
+
+/**
+ * Inserts the elements of an array at the specified index in a vector. See
+ * v_splice(...) for the layout of arr.
+ *
+ * @param v - the vector to add the elements to.
+ * @param index - the index to insert the first element at.
+ * @param arr - the elements to insert.
+ * @param n - the number of elements in arr.
+ * @return 1 if the elements were added. Returns 0 if the vector is NULL, the
+ *    index is out of bounds, or upon allocation error.
+ **/
+int v_add_range(vect_t* const v, ds_idx_t index, void* const arr,
+                ds_idx_t n) {
+   return v_splice(v, index, 0, arr, n, NULL);
+}
+
+
+/**
+ * Appends the elements of an array to the end of a vector. See v_splice(...)
+ * for the layout of arr.
+ *
+ * @param v - the vector to add the elements to.
+ * @param arr - the elements to append.
+ * @param n - the number of elements in arr.
+ * @return 1 if the elements were added. Returns 0 if the vector is NULL or
+ *    upon allocation error.
+ **/
+int v_append_arr(vect_t* const v, void* const arr, ds_idx_t n) {
+   if(!v) return !ADDED;
+
+   return v_splice(v, v->__size, 0, arr, n, NULL);
+}
+
+
+/**
+ * Removes a range of elements from a vector. See v_splice(...) for the layout
+ * of out and what happens to removed elements when out is NULL.
+ *
+ * @param v - the vector to remove the elements from.
+ * @param index - the index of the first element to remove.
+ * @param n - the number of elements to remove.
+ * @param out - receives the removed elements, or NULL.
+ * @return 1 if the elements were removed. Returns 0 if the vector is NULL or
+ *    the range is out of bounds.
+ **/
+int v_rem_range(vect_t* const v, ds_idx_t index, ds_idx_t n,
+                void* const out) {
+   return v_splice(v, index, n, NULL, 0, out);
+}
+
+
 /**
  * Attempts to remove all elements in the specified vector. Applies free(...)
- * to each element in a vector and sets the size of the vector to 0.
+ * (or the vector's allocator) to each element in a plain vector and sets the
+ * size of the vector to 0.
  *
  * @param v - the vector to clear.
  **/
 void v_clear(vect_t* const v) {
-   v_apply(v, free);
+   ds_idx_t i;
+
+   if(!v) return;
+
+   /* Inline elements are owned by the vector's buffer */
+   if(!v->__inl)
+      for(i = 0; i < v->__size; i++)
+         __DS_FREE(v->__alloc, __v_elem(v, i), v->__elem_size);
+
+   v->__size = 0;
 }
 
 
@@ -212,21 +750,9 @@ void v_clear(vect_t* const v) {
  *    or if the list is NULL;
  **/
 int v_contains(vect_t* const v, void* const elem) {
-   size_t num_bytes;
-   int i, size;
-
    if(!v) return !EXIST;
 
-   num_bytes = v->__elem_size;
-   size = v->__size;
-
-   /* Loop through to find the element */
-   for(i = 0; i < size; i++)
-      if(memcmp(elem, v->__elements[i], num_bytes) == 0)
-         return EXIST;
-
-   /* Element does not exist */
-   return !EXIST;
+   return (__v_find(v, elem) >= 0 ? EXIST : !EXIST);
 }
 
 
@@ -240,13 +766,30 @@ int v_contains(vect_t* const v, void* const elem) {
  *    if the index is less than zero (0), or if the index is greater than the
  *    size of the vector.
  **/
-void* v_get(vect_t* const v, int index) {
+void* v_get(vect_t* const v, ds_idx_t index) {
    if(!v) return NULL;
 
    if(index < 0 || index >= v->__size)
       return NULL;
 
-   return v->__elements[index];
+   return __v_elem(v, index);
+}
+
+
+/**
+ * Retrieves a reference to the element at the specified index. For inline
+ * vectors the reference points into the vector's contiguous storage and may be
+ * used to modify the element in place; it is only valid until the next call
+ * that modifies the vector. For pointer vectors this is the same as
+ * v_get(...).
+ *
+ * @param v - the vector to retrieve the reference from.
+ * @param index - the index in the specified vector to retrieve.
+ * @return a reference to the element at the specified index. Returns NULL if
+ *    the vector is NULL or the index is out of range.
+ **/
+void* v_get_ref(vect_t* const v, ds_idx_t index) {
+   return v_get(v, index);
 }
 
 
@@ -285,61 +828,485 @@ void* v_last(vect_t* const v) {
  * @return the index of the first occurrence of the specified element, or -1 if
  *    the vector is NULL or does not contain the specified element.
  **/
-int v_indexof(vect_t* const v, void* const elem) {
-   size_t num_bytes;
-   int i, size;
-
+ds_idx_t v_indexof(vect_t* const v, void* const elem) {
    if(!v) return -1;
 
-   num_bytes = v->__elem_size;
-   size = v->__size;
+   return __v_find(v, elem);
+}
 
-   /* Look for first occurance */
-   for(i = 0; i < size; i++)
-      if(memcmp(elem, v->__elements[i], num_bytes) == 0)
-         return i;
 
-   /* Element not found */
-   return -1;
-}
+/* Element kinds whose equality is bitwise, as the SIMD kernels test it */
+#define __V_BITWISE(k) ((k) == DS_K_MEM || (k) == DS_K_INT || \
+                        (k) == DS_K_UINT || (k) == DS_K_I64 || \
+                        (k) == DS_K_U64)
 
+/* Scan inline storage for a scalar key of the given type */
+#define __V_SCAN(type) \
+   for(i = 0; i < size; i++) \
+      if(((const type*) v->__elements)[i] == *(const type*) elem) \
+         return i; \
+   return -1
 
 /**
- * Apply a function over all the elements in a vector.
+ * Find the first element equal to elem under the vector's callbacks, counting
+ * the elements compared.
  *
- * @param v - the vector to apply an operation over.
- * @param funct - the function to apply over the specified vector, where the
- *    argument to the function is an element in the vector.
+ * @param v - the vector to search.
+ * @param elem - the element to search for.
+ * @return the index of the first equal element, or -1 if there is none.
  **/
-void v_apply(vect_t* const v, void (*funct)(void* const)) {
-   int i, size;
+static ds_idx_t __v_find(vect_t* const v, const void* const elem) {
+   ds_idx_t index;
 
-   if(!v) return;
-
-   size = v->__size;
+   index = __v_search(v, elem);
 
-   /* For each element in the list */
-   for(i = 0; i < size; i++)
-      (funct)(v->__elements[i]);
+   __DS_WALK(v, (index < 0 ? v->__size : index + 1), 1);
 
-   if(funct == free)
-      v->__size = 0;
+   return index;
 }
 
 
 /**
- * Removes the element at the specified index in the specified vector. Shifts
- * remaining elements left one position (decrementing indices).
+ * Search behind __v_find(...). Inline vectors of 4- or 8-byte elements
+ * compared bitwise go to the SIMD kernels; other built-in scalar kinds are
+ * scanned directly as an array.
  *
- * @param v - the vector to remove the specified element from.
- * @param index - the index of the element to be removed.
- * @return 1 if the vector contained the specified element. Returns 0 if the
- *    vector is NULL or the index is less than zero (0) or the index is greater
- *    than the size of the vector.
+ * @param v - the vector to search.
+ * @param elem - the element to search for.
+ * @return the index of the first equal element, or -1 if there is none.
  **/
-void* v_rem(vect_t* const v, int index) {
-   void *target;
-   int i, size;
+static ds_idx_t __v_search(vect_t* const v, const void* const elem) {
+   size_t num_bytes;
+   ds_idx_t i, n, size;
+   int kind, found;
+
+   num_bytes = v->__elem_size;
+   size = v->__size;
+   kind = v->__kind;
+
+   /* The kernels take int lengths, so long vectors go in pieces */
+   if(v->__inl && __V_BITWISE(kind) && (num_bytes == 4 || num_bytes == 8)) {
+      for(i = 0; i < size; i += n) {
+         n = (size - i < SIMD_MAX ? size - i : SIMD_MAX);
+         found = (num_bytes == 4 ?
+                  __ds_simd_find32(__V_SLOT(v, i), (int) n, elem) :
+                  __ds_simd_find64(__V_SLOT(v, i), (int) n, elem));
+
+         if(found >= 0) return i + found;
+      }
+
+      return -1;
+   }
+
+   if(v->__inl) {
+      switch(kind) {
+         case DS_K_FLOAT:
+            __V_SCAN(float);
+         case DS_K_DOUBLE:
+            __V_SCAN(double);
+      }
+   }
+
+   /* Look for first occurance */
+   for(i = 0; i < size; i++)
+      if(__DS_EQ(kind, v->__ops, elem, __v_elem(v, i), num_bytes))
+         return i;
+
+   /* Element not found */
+   return -1;
+}
+
+
+/**
+ * Count the elements in a vector equal to the specified element, as set by
+ * v_setops(...).
+ *
+ * @param v - the vector to search.
+ * @param elem - the element to count.
+ * @return the number of equal elements. Returns -1 if the vector is NULL.
+ **/
+ds_idx_t v_count(vect_t* const v, void* const elem) {
+   size_t num_bytes;
+   ds_idx_t i, n, size, count;
+   int kind;
+
+   if(!v) return -1;
+
+   num_bytes = v->__elem_size;
+   size = v->__size;
+   kind = v->__kind;
+
+   __DS_WALK(v, size, 1);
+
+   count = 0;
+
+   if(v->__inl && __V_BITWISE(kind) && (num_bytes == 4 || num_bytes == 8)) {
+      for(i = 0; i < size; i += n) {
+         n = (size - i < SIMD_MAX ? size - i : SIMD_MAX);
+         count += (num_bytes == 4 ?
+                   __ds_simd_count32(__V_SLOT(v, i), (int) n, elem) :
+                   __ds_simd_count64(__V_SLOT(v, i), (int) n, elem));
+      }
+
+      return count;
+   }
+
+   for(i = 0; i < size; i++)
+      if(__DS_EQ(kind, v->__ops, elem, __v_elem(v, i), num_bytes))
+         count++;
+
+   return count;
+}
+
+
+/**
+ * Retrieves (but does not remove) the least element in the vector, ordered
+ * by the cmp callback set by v_setops(...), or bytewise if there is none.
+ * Ties go to the element with the lowest index.
+ *
+ * @param v - the vector to search.
+ * @return the least element. Returns NULL if the vector is NULL or empty.
+ **/
+void* v_min(vect_t* const v) {
+   if(!v || !v->__size) return NULL;
+
+   return __v_elem(v, __v_extreme(v, 0));
+}
+
+
+/**
+ * Retrieves (but does not remove) the greatest element in the vector, ordered
+ * by the cmp callback set by v_setops(...), or bytewise if there is none.
+ * Ties go to the element with the lowest index.
+ *
+ * @param v - the vector to search.
+ * @return the greatest element. Returns NULL if the vector is NULL or empty.
+ **/
+void* v_max(vect_t* const v) {
+   if(!v || !v->__size) return NULL;
+
+   return __v_elem(v, __v_extreme(v, 1));
+}
+
+
+/* Scan inline storage for the first extreme scalar of the given type */
+#define __V_EXT(type) \
+   for(i = 1; i < size; i++) \
+      if(max ? ((const type*) v->__elements)[i] > \
+               ((const type*) v->__elements)[best] : \
+               ((const type*) v->__elements)[i] < \
+               ((const type*) v->__elements)[best]) \
+         best = i; \
+   return best
+
+/**
+ * Find the index of the first least or greatest element of a non-empty
+ * vector. Inline vectors of 32-bit integers go to the SIMD kernels.
+ *
+ * @param v - the vector to search.
+ * @param max - nonzero to find the greatest element.
+ * @return the index of the extreme element.
+ **/
+static ds_idx_t __v_extreme(vect_t* const v, int max) {
+   ds_cmp_t cmp;
+   size_t num_bytes;
+   ds_idx_t i, j, n, best, size;
+   int c, flags;
+
+   num_bytes = v->__elem_size;
+   size = v->__size;
+   best = 0;
+
+   __DS_WALK(v, size - 1, 1);
+
+   /* An integer comparator fixes the kind, even alongside a custom eq */
+   cmp = (v->__ops.cmp ? v->__ops.cmp : ds_cmp_mem);
+
+   if(v->__inl) {
+      /* Take the first extreme of each piece the kernel is handed */
+      if((cmp == ds_cmp_int || cmp == ds_cmp_uint) && num_bytes == 4) {
+         flags = (cmp == ds_cmp_uint ? DS_SIMD_UNSIGNED : 0) |
+                 (max ? DS_SIMD_MAX : 0);
+
+         for(i = 0; i < size; i += n) {
+            n = (size - i < SIMD_MAX ? size - i : SIMD_MAX);
+            j = i + __ds_simd_ext32(__V_SLOT(v, i), (int) n, flags);
+            c = cmp(__V_SLOT(v, j), __V_SLOT(v, best), num_bytes);
+
+            if(max ? c > 0 : c < 0)
+               best = j;
+         }
+
+         return best;
+      }
+
+      if(cmp == ds_cmp_i64) {
+         __V_EXT(int64_t);
+      }
+
+      if(cmp == ds_cmp_u64) {
+         __V_EXT(uint64_t);
+      }
+   }
+
+   for(i = 1; i < size; i++) {
+      c = cmp(__v_elem(v, i), __v_elem(v, best), num_bytes);
+
+      if(max ? c > 0 : c < 0)
+         best = i;
+   }
+
+   return best;
+}
+
+
+/**
+ * Apply a function over all the elements in a vector.
+ *
+ * @param v - the vector to apply an operation over.
+ * @param funct - the function to apply over the specified vector, where the
+ *    argument to the function is an element in the vector.
+ **/
+void v_apply(vect_t* const v, void (*funct)(void* const)) {
+   ds_idx_t i, size;
+
+   if(!v) return;
+
+   size = v->__size;
+
+   /* For each element in the list */
+   for(i = 0; i < size; i++)
+      (funct)(__v_elem(v, i));
+
+   if(funct == free)
+      v->__size = 0;
+}
+
+
+/**
+ * Apply a function over all the elements in a vector, first to last, handing
+ * each call a user supplied context pointer so that results can be accumulated
+ * without global state.
+ *
+ * @param v - the vector to apply an operation over.
+ * @param funct - the function to apply, where the first argument is an element
+ *    in the vector and the second argument is ctx.
+ * @param ctx - the context passed to every call of funct.
+ **/
+void v_apply_ctx(vect_t* const v, void (*funct)(void* const, void*),
+                 void* ctx) {
+   ds_idx_t i, size;
+
+   if(!v) return;
+
+   size = v->__size;
+
+   for(i = 0; i < size; i++)
+      (funct)(__v_elem(v, i), ctx);
+}
+
+
+/**
+ * Visit the elements in a vector, first to last, stopping at the first element
+ * for which the visitor returns nonzero. Searches such as "find the first
+ * match" can stop there instead of walking the whole vector.
+ *
+ * @param v - the vector to visit.
+ * @param visit - the visitor, where the first argument is an element in the
+ *    vector and the second argument is ctx. Returns nonzero to stop.
+ * @param ctx - the context passed to every call of visit.
+ * @return the element the visit stopped at. Returns NULL if the visitor never
+ *    returned nonzero or the vector is NULL.
+ **/
+void* v_visit(vect_t* const v, int (*visit)(void* const, void*), void* ctx) {
+   ds_idx_t i, size;
+
+   if(!v) return NULL;
+
+   size = v->__size;
+
+   for(i = 0; i < size; i++)
+      if((visit)(__v_elem(v, i), ctx))
+         return __v_elem(v, i);
+
+   return NULL;
+}
+
+
+/**
+ * Internal job description for v_apply_par(...) and v_mapreduce_par(...).
+ * The elements are split into ntasks contiguous chunks; chunk i of a
+ * map/reduce job folds into the accumulator at parts + i * acc_size.
+ **/
+typedef struct __v_job_s {
+   vect_t *v;
+   void (*funct)(void* const);
+   void (*map)(void* const, void*);
+   char *parts;
+   size_t acc_size;
+   int ntasks;
+} __v_job_t;
+
+
+/* First index of chunk i of a job */
+#define __V_CHUNK(job, i) \
+   ((ds_idx_t) ((double) (job)->v->__size * (i) / (job)->ntasks))
+
+
+/**
+ * Choose how many chunks to split a vector into for a parallel job.
+ *
+ * @param v - the vector to split.
+ * @param nthreads - the number of threads asked for.
+ * @return the number of chunks; at least one (1).
+ **/
+static int __v_chunks(vect_t* const v, int nthreads) {
+   int chunks;
+
+   chunks = __ds_pool_threads(nthreads) * PAR_CHUNKS;
+
+   /* Keep chunks large enough to outweigh the cost of handing them out */
+   if(chunks > v->__size / PAR_MIN)
+      chunks = (int) (v->__size / PAR_MIN);
+
+   return (chunks > 0 ? chunks : 1);
+}
+
+
+/**
+ * Apply a function over all the elements in a vector using several threads.
+ * The elements are split into contiguous chunks that are handed out to a
+ * shared pool of worker threads, so funct is called concurrently and in no
+ * particular order, and must be safe to call that way. The call returns once
+ * funct has been applied to every element.
+ *
+ * @param v - the vector to apply an operation over.
+ * @param funct - the function to apply to each element.
+ * @param nthreads - the most threads to use, the calling thread included. If
+ *    zero (0) or less, uses one thread per online processor.
+ **/
+void v_apply_par(vect_t* const v, void (*funct)(void* const), int nthreads) {
+   __v_job_t job;
+
+   if(!v || !funct) return;
+
+   job.v = v;
+   job.funct = funct;
+   job.ntasks = __v_chunks(v, nthreads);
+
+   __ds_pool_run(__v_apply_task, &job, job.ntasks, nthreads);
+
+   if(funct == free)
+      v->__size = 0;
+}
+
+
+/**
+ * Apply one chunk of a v_apply_par(...) job.
+ *
+ * @param ctx - the job.
+ * @param task - the chunk to apply.
+ **/
+static void __v_apply_task(void* ctx, int task) {
+   __v_job_t *job;
+   ds_idx_t i, end;
+
+   job = ctx;
+   end = __V_CHUNK(job, task + 1);
+
+   for(i = __V_CHUNK(job, task); i < end; i++)
+      (job->funct)(__v_elem(job->v, i));
+}
+
+
+/**
+ * Fold every element of a vector into an accumulator using several threads.
+ * Each chunk of the vector gets a private copy of acc, which map folds the
+ * chunk's elements into one at a time. The partial results are then merged
+ * into acc with reduce, in chunk order, on the calling thread. acc must hold
+ * an identity value for reduce (zero for a sum, for example), since every
+ * chunk starts from a copy of it.
+ *
+ * @param v - the vector to fold.
+ * @param map - folds an element (first argument) into a chunk's accumulator
+ *    (second argument). Called concurrently for different chunks.
+ * @param reduce - merges a chunk's accumulator (second argument) into acc
+ *    (first argument).
+ * @param acc - the accumulator; holds the result upon return.
+ * @param acc_size - the size of the accumulator in bytes; must be nonzero.
+ * @param nthreads - the most threads to use, the calling thread included. If
+ *    zero (0) or less, uses one thread per online processor.
+ * @return 1 if the vector was folded. Returns 0 if an argument is NULL,
+ *    acc_size is zero (0), the private copies of acc would not fit in a
+ *    size_t, or upon allocation error, in which case acc is unchanged.
+ **/
+int v_mapreduce_par(vect_t* const v, void (*map)(void* const, void*),
+                    void (*reduce)(void*, const void*), void* acc,
+                    size_t acc_size, int nthreads) {
+   __v_job_t job;
+   int i;
+
+   if(!v || !map || !reduce || !acc || !acc_size) return !ADDED;
+
+   job.v = v;
+   job.map = map;
+   job.acc_size = acc_size;
+   job.ntasks = __v_chunks(v, nthreads);
+
+   if(acc_size > (size_t) -1 / (size_t) job.ntasks) return !ADDED;
+
+   job.parts = malloc(acc_size * (size_t) job.ntasks);
+
+   if(!job.parts) return !ADDED;
+
+   for(i = 0; i < job.ntasks; i++)
+      memcpy(job.parts + acc_size * i, acc, acc_size);
+
+   __ds_pool_run(__v_map_task, &job, job.ntasks, nthreads);
+
+   for(i = 0; i < job.ntasks; i++)
+      (reduce)(acc, job.parts + acc_size * i);
+
+   free(job.parts);
+
+   return ADDED;
+}
+
+
+/**
+ * Fold one chunk of a v_mapreduce_par(...) job into its accumulator.
+ *
+ * @param ctx - the job.
+ * @param task - the chunk to fold.
+ **/
+static void __v_map_task(void* ctx, int task) {
+   __v_job_t *job;
+   void *part;
+   ds_idx_t i, end;
+
+   job = ctx;
+   part = job->parts + job->acc_size * task;
+   end = __V_CHUNK(job, task + 1);
+
+   for(i = __V_CHUNK(job, task); i < end; i++)
+      (job->map)(__v_elem(job->v, i), part);
+}
+
+
+/**
+ * Removes the element at the specified index in the specified vector. Shifts
+ * remaining elements left one position (decrementing indices). For inline
+ * vectors the returned element is a copy held by the vector, valid until the
+ * next call that modifies the vector.
+ *
+ * @param v - the vector to remove the specified element from.
+ * @param index - the index of the element to be removed.
+ * @return 1 if the vector contained the specified element. Returns 0 if the
+ *    vector is NULL or the index is less than zero (0) or the index is greater
+ *    than the size of the vector.
+ **/
+void* v_rem(vect_t* const v, ds_idx_t index) {
+   void *target;
 
    if(!v) return NULL;
 
@@ -349,12 +1316,19 @@ void* v_rem(vect_t* const v, int index) {
    /* Removing from empty list */
    if(v_empty(v)) return NULL;
 
-   size = v->__size;
-   target = v->__elements[index];
+   /* Keep a copy of an inline element in the scratch slot */
+   if(v->__inl) {
+      target = __V_SLOT(v, v->__cap);
+      memcpy(target, __V_SLOT(v, index), v->__elem_size);
+   }
+   else
+      target = __v_elem(v, index);
 
    /* Shift elements left one position */
-   for(i = index; i < size; i++)
-      v->__elements[i] = v->__elements[i + 1];
+   memmove(__V_SLOT(v, index), __V_SLOT(v, index + 1),
+           (size_t) (v->__size - index - 1) * v->__stride);
+
+   __DS_COUNT(v, bytes_copied, (size_t) (v->__size - index - 1) * v->__stride);
 
    v->__size--;
    return target;
@@ -389,13 +1363,16 @@ void* v_reml(vect_t* const v) {
 
 /**
  * Replaces the element at the specified index with the specified element.
+ * For inline vectors the element is copied in, and the returned former element
+ * is a copy held by the vector, valid until the next call that modifies the
+ * vector.
  *
  * @param v - the vector in which to replace the specified element.
  * @param index - specified index of the element to replace.
  * @param elem - element to be stored at the specified index.
  * @return the element previously stored at the specified index.
  **/
-void* v_set(vect_t* const v, int index, void* const elem) {
+void* v_set(vect_t* const v, ds_idx_t index, void* const elem) {
    void *target;
 
    if(!v) return NULL;
@@ -403,8 +1380,16 @@ void* v_set(vect_t* const v, int index, void* const elem) {
    if(index < 0 || index >= v->__size)
       return NULL;
 
-   target = v->__elements[index];
-   v->__elements[index] = elem;
+   if(v->__inl) {
+      if(!elem) return NULL;
+
+      target = __V_SLOT(v, v->__cap);
+      memcpy(target, __V_SLOT(v, index), v->__elem_size);
+   }
+   else
+      target = __v_elem(v, index);
+
+   __v_store(v, index, elem);
 
    return target;
 }
@@ -412,44 +1397,659 @@ void* v_set(vect_t* const v, int index, void* const elem) {
 
 /**
  * Creates and returns a pointer to an array representation of the vector.
- * Returns a pointer to an array on which free(...) may be called.
+ * Returns a pointer to an array on which free(...) may be called. For inline
+ * vectors the array holds pointers into the vector's storage.
  *
  * @param v - the vector to translate to an array.
  * @return a pointer to an array representation of the vector.
  **/
 void** v_toarr(vect_t* const v) {
-   int **array;
-   int size;
+   void **array;
+   ds_idx_t i, size;
 
    if(!v) return NULL;
 
    size = v->__size;
 
-   array = malloc(sizeof(void*) * size);
+   array = malloc(sizeof(void*) * (size_t) size);
 
    if(!array) return NULL;
 
    /* Assign pointers to new array */
-   array = memcpy(array, v->__elements, sizeof(void*) * size);
+   if(!v->__inl)
+      return memcpy(array, v->__elements, sizeof(void*) * (size_t) size);
+
+   for(i = 0; i < size; i++)
+      array[i] = __V_SLOT(v, i);
+
+   return array;
+}
+
+
+/**
+ * Returns a pointer to the vector's own storage, without copying. Element i
+ * is at byte offset i * elem_size for inline vectors; a plain vector stores
+ * an array of element pointers. The pointer is borrowed: it must not be
+ * freed, and it is only valid until the next call that modifies the vector.
+ *
+ * @param v - the vector whose storage to expose.
+ * @return a pointer to the first slot of the vector. Returns NULL if the
+ *    vector is NULL.
+ **/
+void* v_data(vect_t* const v) {
+   return (v ? v->__elements : NULL);
+}
+
 
-   return (void**) array;
+/**
+ * Returns a borrowed view of the vector's elements in index order, as a
+ * zero-copy alternative to v_toarr(...). The view is valid only until the
+ * next call that modifies the vector, and must not be freed.
+ *
+ * @param v - the vector to view.
+ * @return a view of the vector's elements. An empty view is returned if the
+ *    vector is NULL.
+ **/
+ds_span_t v_span(vect_t* const v) {
+   ds_span_t span;
+
+   span.data = NULL;
+   span.len = 0;
+   span.stride = 0;
+
+   if(!v) return span;
+
+   span.data = v->__elements;
+   span.len = (size_t) v->__size;
+   span.stride = v->__stride;
+
+   return span;
 }
 
 
 /**
- * Trim the capacity of the vector to the current size of the vector.
+ * Trim the capacity of the vector to the current size of the vector. Mapped
+ * buffers are trimmed to the nearest page. A vector opened from a snapshot is
+ * left in its mapping unless elements have been removed from it. If the
+ * buffer cannot be reallocated the vector is left as it was.
  *
  * @param v - the vector to trim to size.
- * @return the vector trimmed to its size. Returns NULL if the vector is NULL.
  **/
 void v_trim(vect_t* const v) {
-   int size;
+   if(!v) return;
+
+   if(v->__file && v->__size == v->__cap) return;
+
+   __v_resize(v, v->__size);
+}
+
+
+/** Persistence **/
+
+/**
+ * Write a vector's elements to a snapshot file that v_open_mmap(...) can map
+ * back in. Each element is written as its elem_size bytes, so only vectors of
+ * self-contained elements (no pointers) survive the round trip; plain vectors
+ * have the elements they point to written. The file is written under a
+ * temporary name and renamed over path once complete, so processes that have
+ * path mapped are not disturbed.
+ *
+ * @param v - the vector to save.
+ * @param path - the file to write.
+ * @return 1 if the snapshot was written. Returns 0 if the vector or path is
+ *    NULL, or upon I/O error, in which case path is left untouched.
+ **/
+int v_save(vect_t* const v, const char* path) {
+   __ds_snap_t snap;
+   ds_idx_t i;
+
+   if(!v || !__ds_snap_open(&snap, path, v->__elem_size, v->__size))
+      return !ADDED;
+
+   if(v->__inl)
+      __ds_snap_put(&snap, v->__elements, (size_t) v->__size);
+   else
+      for(i = 0; i < v->__size; i++)
+         __ds_snap_put(&snap, __v_elem(v, i), 1);
+
+   return __ds_snap_close(&snap);
+}
+
+
+/**
+ * NOTE: This function is not intended for use by the user. Use the wrapper
+ * macro v_open_mmap(...) instead.
+ *
+ * Open a snapshot written by v_save(...), ll_save(...) or q_save(...) as an
+ * inline vector, without reading or copying its elements: they are mapped
+ * straight from the file and paged in as they are touched. The mapping is
+ * copy-on-write, so pages are shared between all processes that open the
+ * same snapshot until one of them modifies the vector, and changes never
+ * reach the file. The first time the vector has to grow (or shrink) it moves
+ * its elements to the heap. The file must not be truncated or written to in
+ * place while the vector is open.
+ *
+ * @param __elem_size - the size of an element, which must match the
+ *    snapshot's.
+ * @param path - the file to open.
+ * @param flags - V_MAP_VERIFY to check the elements against the snapshot's
+ *    checksum, which reads the whole file; zero (0) otherwise.
+ * @return a pointer to an inline vector of the snapshot's elements. Returns
+ *    a NULL pointer if the file cannot be opened or mapped, is not a
+ *    snapshot of __elem_size elements, fails verification, or upon
+ *    allocation error.
+ **/
+vect_t* __v_open_mmap(size_t __elem_size, const char* path, int flags) {
+   vect_t *vector;
+   char *base;
+   ds_idx_t count;
+   size_t len;
+
+   base = __ds_snap_map(path, __elem_size, flags & V_MAP_VERIFY, &count,
+                        &len);
+
+   if(!base) return NULL;
+
+   vector = malloc(sizeof(vect_t));
+
+   if(!vector) {
+      munmap(base, len);
+      return NULL;
+   }
+
+   vector->__elements = base + sizeof(__ds_snap_hdr_t);
+   vector->__file = base;
+   vector->__alloc = NULL;
+   vector->__elem_size = __elem_size;
+   vector->__stride = __elem_size;
+   vector->__mapped = len;
+   vector->__ops = ds_ops_mem;
+   vector->__kind = DS_K_MEM;
+   vector->__inl = 1;
+   vector->__growth = V_GROW_DOUBLE;
+   vector->__chunk = 0;
+   vector->__cap = count;
+   vector->__size = count;
+
+   __DS_STATS_INIT(vector);
+   __DS_COUNT(vector, allocs, 1);
+   __DS_PEAK(vector, peak_cap, count);
+
+   return vector;
+}
+
+
+/** Sorting and Searching **/
+
+/* The element (or pointer to it) a slot holds */
+#define __V_KEY(v, slot) ((v)->__inl ? (void*) (slot) : *(void**) (slot))
+
+/* Whether slot a orders strictly before slot b */
+#define __V_LESS(v, cmp, a, b) \
+   ((cmp)(__V_KEY(v, a), __V_KEY(v, b), (v)->__elem_size) < 0)
+
+
+/**
+ * Pick the comparator a sorting or searching call uses.
+ *
+ * @param v - the vector being sorted or searched.
+ * @param cmp - the comparator passed by the user, or NULL.
+ * @return cmp, else the cmp callback set by v_setops(...), else
+ *    ds_cmp_mem(...).
+ **/
+static ds_cmp_t __v_cmp(vect_t* const v, ds_cmp_t cmp) {
+   if(cmp) return cmp;
+
+   return (v->__ops.cmp ? v->__ops.cmp : ds_cmp_mem);
+}
+
+
+/**
+ * Swap two non-overlapping blocks of n bytes.
+ *
+ * @param a - the first block.
+ * @param b - the second block.
+ * @param n - the number of bytes in a block.
+ **/
+static void __v_swap(char *a, char *b, size_t n) {
+   char tmp[64];
+   size_t k;
+
+   while(n) {
+      k = (n < sizeof(tmp) ? n : sizeof(tmp));
+
+      memcpy(tmp, a, k);
+      memcpy(a, b, k);
+      memcpy(b, tmp, k);
+
+      a += k;
+      b += k;
+      n -= k;
+   }
+}
+
+
+/**
+ * Sort the elements of a vector. Integer elements of an inline vector
+ * ordered by ds_cmp_int(...), ds_cmp_uint(...), ds_cmp_i64(...) or
+ * ds_cmp_u64(...) are radix sorted; everything else is sorted with an
+ * introsort, a quicksort that falls back to heapsort on bad inputs, so the
+ * sort is O(n log n) in the worst case. The sort is not stable.
+ *
+ * @param v - the vector to sort.
+ * @param cmp - the comparator to order elements by. If NULL, uses the cmp
+ *    callback set by v_setops(...), or bytewise order if there is none.
+ **/
+void v_sort(vect_t* const v, ds_cmp_t cmp) {
+   size_t s;
+   ds_idx_t n, i, j;
+   int depth;
 
    if(!v) return;
 
-   size = v->__size;
-   v->__elements = realloc(v->__elements, sizeof(void*) * size);
-   v->__cap = size;
+   n = v->__size;
+   cmp = __v_cmp(v, cmp);
+
+   if(n < 2) return;
+
+   /* Radix sort integer keys; fall through only upon allocation error */
+   if(v->__inl && n >= RADIX_MIN) {
+      if(cmp == ds_cmp_int && v->__elem_size == 4 &&
+         __v_radix32((uint32_t*) v->__elements, n, 0x80000000UL))
+         return;
+
+      if(cmp == ds_cmp_uint && v->__elem_size == 4 &&
+         __v_radix32((uint32_t*) v->__elements, n, 0))
+         return;
+
+      if(cmp == ds_cmp_i64 && v->__elem_size == 8 &&
+         __v_radix64((uint64_t*) v->__elements, n, (uint64_t) 1 << 63))
+         return;
+
+      if(cmp == ds_cmp_u64 && v->__elem_size == 8 &&
+         __v_radix64((uint64_t*) v->__elements, n, 0))
+         return;
+   }
+
+   /* Allow 2 * log2(n) levels of quicksort before switching to heapsort */
+   for(depth = 0; (n >> depth) > 1; depth++);
+
+   __v_introsort(v, cmp, 0, n, 2 * depth);
+
+   /* Finish the short ranges quicksort left unsorted */
+   s = v->__stride;
+
+   for(i = 1; i < n; i++)
+      for(j = i; j > 0 && __V_LESS(v, cmp, __V_SLOT(v, j),
+                                  __V_SLOT(v, j - 1)); j--)
+         __v_swap(__V_SLOT(v, j), __V_SLOT(v, j - 1), s);
+}
+
+
+/**
+ * Quicksort slots [lo, hi) down to unsorted ranges of at most SORT_SMALL,
+ * which v_sort(...) finishes with a single insertion sort. Recurses on the
+ * smaller side of each partition so the stack stays O(log n).
+ *
+ * @param v - the vector to sort.
+ * @param cmp - the comparator to order elements by.
+ * @param lo - the first slot to sort.
+ * @param hi - one past the last slot to sort.
+ * @param depth - the levels of quicksort left before switching to heapsort.
+ **/
+static void __v_introsort(vect_t* const v, ds_cmp_t cmp, ds_idx_t lo,
+                          ds_idx_t hi, int depth) {
+   char *first, *pivot;
+   size_t s;
+   ds_idx_t i, j;
+
+   s = v->__stride;
+
+   while(hi - lo > SORT_SMALL) {
+      if(depth-- == 0) {
+         __v_heapsort(v, cmp, lo, hi);
+         break;
+      }
+
+      /* Median of three, moved to lo as the pivot */
+      first = __V_SLOT(v, lo);
+      pivot = __V_SLOT(v, lo + ((hi - lo) >> 1));
+
+      if(__V_LESS(v, cmp, pivot, first))
+         __v_swap(pivot, first, s);
+      if(__V_LESS(v, cmp, __V_SLOT(v, hi - 1), pivot)) {
+         __v_swap(pivot, __V_SLOT(v, hi - 1), s);
+
+         if(__V_LESS(v, cmp, pivot, first))
+            __v_swap(pivot, first, s);
+      }
+
+      __v_swap(pivot, first, s);
+      pivot = first;
+
+      /* Hoare partition around the pivot */
+      i = lo;
+      j = hi;
+
+      for(;;) {
+         do i++; while(i < hi && __V_LESS(v, cmp, __V_SLOT(v, i), pivot));
+         do j--; while(__V_LESS(v, cmp, pivot, __V_SLOT(v, j)));
+
+         if(i >= j) break;
+
+         __v_swap(__V_SLOT(v, i), __V_SLOT(v, j), s);
+      }
+
+      __v_swap(pivot, __V_SLOT(v, j), s);
+
+      /* Recurse on the smaller side, loop on the larger */
+      if(j - lo < hi - j - 1) {
+         __v_introsort(v, cmp, lo, j, depth);
+         lo = j + 1;
+      }
+      else {
+         __v_introsort(v, cmp, j + 1, hi, depth);
+         hi = j;
+      }
+   }
+}
+
+
+/**
+ * Heapsort slots [lo, hi).
+ *
+ * @param v - the vector to sort.
+ * @param cmp - the comparator to order elements by.
+ * @param lo - the first slot to sort.
+ * @param hi - one past the last slot to sort.
+ **/
+static void __v_heapsort(vect_t* const v, ds_cmp_t cmp, ds_idx_t lo,
+                         ds_idx_t hi) {
+   char *base;
+   size_t s;
+   ds_idx_t n, i, root, child;
+
+   base = __V_SLOT(v, lo);
+   s = v->__stride;
+   n = hi - lo;
+
+   /* Build a max-heap bottom up, then move its root to the end n times */
+   for(i = n / 2 - 1 + n; i > 0; i--) {
+      if(i >= n) {
+         root = i - n;
+      }
+      else {
+         __v_swap(base, base + (size_t) i * s, s);
+         n = i;
+         root = 0;
+      }
+
+      /* Sift the root down */
+      while((child = 2 * root + 1) < n) {
+         if(child + 1 < n && __V_LESS(v, cmp, base + (size_t) child * s,
+                                      base + (size_t) (child + 1) * s))
+            child++;
+
+         if(!__V_LESS(v, cmp, base + (size_t) root * s,
+                      base + (size_t) child * s))
+            break;
+
+         __v_swap(base + (size_t) root * s, base + (size_t) child * s, s);
+         root = child;
+      }
+   }
+}
+
+
+/**
+ * LSD radix sort 32-bit keys a byte at a time. Keys are XORed with flip
+ * before ordering as unsigned integers, so flipping the sign bit sorts
+ * signed keys. Bytes every key shares are skipped.
+ *
+ * @param a - the keys to sort.
+ * @param n - the number of keys.
+ * @param flip - the bits to flip before ordering.
+ * @return 1 if the keys were sorted. Returns 0 upon allocation error.
+ **/
+static int __v_radix32(uint32_t *a, ds_idx_t n, uint32_t flip) {
+   uint32_t *src, *dst, *tmp, u;
+   ds_idx_t hist[4][256];
+   ds_idx_t i, sum, c;
+   int b;
+
+   tmp = malloc(sizeof(uint32_t) * (size_t) n);
+
+   if(!tmp) return !ADDED;
+
+   memset(hist, 0, sizeof(hist));
+
+   /* Count every byte position in one pass */
+   for(i = 0; i < n; i++) {
+      u = a[i] ^ flip;
+
+      for(b = 0; b < 4; b++)
+         hist[b][(u >> (8 * b)) & 0xff]++;
+   }
+
+   src = a;
+   dst = tmp;
+
+   for(b = 0; b < 4; b++) {
+      if(hist[b][((src[0] ^ flip) >> (8 * b)) & 0xff] == n)
+         continue;
+
+      /* Turn counts into starting offsets */
+      for(sum = 0, i = 0; i < 256; i++) {
+         c = hist[b][i];
+         hist[b][i] = sum;
+         sum += c;
+      }
+
+      for(i = 0; i < n; i++)
+         dst[hist[b][((src[i] ^ flip) >> (8 * b)) & 0xff]++] = src[i];
+
+      tmp = src;
+      src = dst;
+      dst = tmp;
+   }
+
+   if(src != a)
+      memcpy(a, src, sizeof(uint32_t) * (size_t) n);
+
+   free(src == a ? dst : src);
+
+   return ADDED;
+}
+
+
+/**
+ * LSD radix sort 64-bit keys a byte at a time. Keys are XORed with flip
+ * before ordering as unsigned integers, so flipping the sign bit sorts
+ * signed keys. Bytes every key shares are skipped.
+ *
+ * @param a - the keys to sort.
+ * @param n - the number of keys.
+ * @param flip - the bits to flip before ordering.
+ * @return 1 if the keys were sorted. Returns 0 upon allocation error.
+ **/
+static int __v_radix64(uint64_t *a, ds_idx_t n, uint64_t flip) {
+   uint64_t *src, *dst, *tmp, u;
+   ds_idx_t hist[8][256];
+   ds_idx_t i, sum, c;
+   int b;
+
+   tmp = malloc(sizeof(uint64_t) * (size_t) n);
+
+   if(!tmp) return !ADDED;
+
+   memset(hist, 0, sizeof(hist));
+
+   /* Count every byte position in one pass */
+   for(i = 0; i < n; i++) {
+      u = a[i] ^ flip;
+
+      for(b = 0; b < 8; b++)
+         hist[b][(u >> (8 * b)) & 0xff]++;
+   }
+
+   src = a;
+   dst = tmp;
+
+   for(b = 0; b < 8; b++) {
+      if(hist[b][((src[0] ^ flip) >> (8 * b)) & 0xff] == n)
+         continue;
+
+      /* Turn counts into starting offsets */
+      for(sum = 0, i = 0; i < 256; i++) {
+         c = hist[b][i];
+         hist[b][i] = sum;
+         sum += c;
+      }
+
+      for(i = 0; i < n; i++)
+         dst[hist[b][((src[i] ^ flip) >> (8 * b)) & 0xff]++] = src[i];
+
+      tmp = src;
+      src = dst;
+      dst = tmp;
+   }
+
+   if(src != a)
+      memcpy(a, src, sizeof(uint64_t) * (size_t) n);
+
+   free(src == a ? dst : src);
+
+   return ADDED;
+}
+
+
+/**
+ * Find the first position in a sorted vector whose element does not order
+ * before the specified element.
+ *
+ * @param v - the vector to search, sorted by cmp.
+ * @param elem - the element to search for.
+ * @param cmp - the comparator the vector is sorted by. If NULL, uses the cmp
+ *    callback set by v_setops(...), or bytewise order if there is none.
+ * @return the index of the first element not less than elem, or the size of
+ *    the vector if there is none. Returns -1 if the vector is NULL.
+ **/
+ds_idx_t v_lower_bound(vect_t* const v, void* const elem, ds_cmp_t cmp) {
+   ds_idx_t lo, half;
+   size_t num_bytes;
+
+   if(!v) return -1;
+
+   cmp = __v_cmp(v, cmp);
+   num_bytes = v->__elem_size;
+
+   /* Halve the range [lo, lo + n) until it is empty */
+   lo = 0;
+
+   __DS_COUNT(v, walks, 1);
+
+   for(half = v->__size; half > 0; ) {
+      __DS_WALK_STEP(v);
+
+      if(cmp(__v_elem(v, lo + half / 2), elem, num_bytes) < 0) {
+         lo += half / 2 + 1;
+         half -= half / 2 + 1;
+      }
+      else {
+         half /= 2;
+      }
+   }
+
+   return lo;
+}
+
+
+/**
+ * Find the first position in a sorted vector whose element orders after the
+ * specified element.
+ *
+ * @param v - the vector to search, sorted by cmp.
+ * @param elem - the element to search for.
+ * @param cmp - the comparator the vector is sorted by. If NULL, uses the cmp
+ *    callback set by v_setops(...), or bytewise order if there is none.
+ * @return the index of the first element greater than elem, or the size of
+ *    the vector if there is none. Returns -1 if the vector is NULL.
+ **/
+ds_idx_t v_upper_bound(vect_t* const v, void* const elem, ds_cmp_t cmp) {
+   ds_idx_t lo, half;
+   size_t num_bytes;
+
+   if(!v) return -1;
+
+   cmp = __v_cmp(v, cmp);
+   num_bytes = v->__elem_size;
+
+   lo = 0;
+
+   __DS_COUNT(v, walks, 1);
+
+   for(half = v->__size; half > 0; ) {
+      __DS_WALK_STEP(v);
+
+      if(cmp(elem, __v_elem(v, lo + half / 2), num_bytes) >= 0) {
+         lo += half / 2 + 1;
+         half -= half / 2 + 1;
+      }
+      else {
+         half /= 2;
+      }
+   }
+
+   return lo;
+}
+
+
+/**
+ * Search a sorted vector for the specified element in O(log n) comparisons.
+ *
+ * @param v - the vector to search, sorted by cmp.
+ * @param elem - the element to search for.
+ * @param cmp - the comparator the vector is sorted by. If NULL, uses the cmp
+ *    callback set by v_setops(...), or bytewise order if there is none.
+ * @return the index of the first element comparing equal to elem. Returns -1
+ *    if the vector is NULL or does not contain the element.
+ **/
+ds_idx_t v_bsearch(vect_t* const v, void* const elem, ds_cmp_t cmp) {
+   ds_idx_t index;
+
+   index = v_lower_bound(v, elem, cmp);
+
+   if(index < 0 || index == v->__size)
+      return -1;
+
+   if(__v_cmp(v, cmp)(elem, __v_elem(v, index), v->__elem_size) != 0)
+      return -1;
+
+   return index;
+}
+
+
+/**
+ * Insert an element into a sorted vector, keeping it sorted. The element goes
+ * after any elements comparing equal to it.
+ *
+ * @param v - the vector to insert into, sorted by cmp.
+ * @param elem - the element to insert.
+ * @param cmp - the comparator the vector is sorted by. If NULL, uses the cmp
+ *    callback set by v_setops(...), or bytewise order if there is none.
+ * @return the index the element was inserted at. Returns -1 if the vector is
+ *    NULL or upon allocation error.
+ **/
+ds_idx_t v_sorted_insert(vect_t* const v, void* const elem,
+                         ds_cmp_t cmp) {
+   ds_idx_t index;
+
+   index = v_upper_bound(v, elem, cmp);
+
+   if(index < 0 || !v_add(v, index, elem))
+      return -1;
+
+   return index;
 }
 
 
@@ -457,34 +2057,58 @@ void v_trim(vect_t* const v) {
 
 /**
  * A simulated constructor for a vector iterator. Returns an iterator over
- * a specified vector starting at a specified index.
+ * a specified vector starting at a specified index. Use v_itr_init(...) to
+ * set up an iterator without allocating one.
  *
  * @param v - the vector to return an iterator over.
- * @param index - the position that the iterator will start at.
+ * @param index - the position that the iterator will start at, between 0 and
+ *    the size of the vector.
  * @return an iterator over the specified vector. Returns a NULL pointer if the
- *    specified vector is NULL, (index < 0 || index >= v_size(v)), or upon
+ *    specified vector is NULL, (index < 0 || index > v_size(v)), or upon
  *    allocation error.
  **/
-v_itr_t* v_itr(vect_t* const v, int index) {
+v_itr_t* v_itr(vect_t* const v, ds_idx_t index) {
    v_itr_t *iterator;
 
-   if(!v) return NULL;
-
-   if(index < 0 || index >= v->__size)
-      return NULL;
-
    iterator = malloc(sizeof(v_itr_t));
 
    if(!iterator) return NULL;
 
-   iterator->vector = v;
-   iterator->pos = index;
+   if(!v_itr_init(iterator, v, index)) {
+      free(iterator);
+      return NULL;
+   }
 
-   /* Index not found */
    return iterator;
 }
 
 
+/**
+ * Set up a caller provided iterator, typically one declared on the stack,
+ * over a specified vector starting at a specified index. The iterator must
+ * not be passed to vi_free(...).
+ *
+ * @param itr - the iterator to set up.
+ * @param v - the vector to iterate over.
+ * @param index - the position that the iterator will start at, between 0 and
+ *    the size of the vector.
+ * @return 1 if the iterator was set up. Returns 0 if the iterator or vector
+ *    is NULL or the index is out of range.
+ **/
+int v_itr_init(v_itr_t* const itr, vect_t* const v, ds_idx_t index) {
+   if(!itr || !v) return !ADDED;
+
+   if(index < 0 || index > v->__size)
+      return !ADDED;
+
+   itr->__vector = v;
+   itr->__pos = index;
+   itr->__last = 1;
+
+   return ADDED;
+}
+
+
 /**
  * A simulated destructor for a vector iterator.
  *
@@ -507,10 +2131,7 @@ int vi_hasnext(v_itr_t* const itr) {
    if(!itr) return !EXIST;
 
    /* There exists another element */
-   if(itr->pos == itr->vector->__size)
-      return !EXIST;
-
-   return EXIST;
+   return (itr->__pos < itr->__vector->__size ? EXIST : !EXIST);
 }
 
 
@@ -526,7 +2147,7 @@ int vi_hasprev(v_itr_t* const itr) {
    if(!itr) return !EXIST;
 
    /* There exists a previous element */
-   return (itr->pos ? EXIST : !EXIST);
+   return (itr->__pos > 0 ? EXIST : !EXIST);
 }
 
 
@@ -538,17 +2159,12 @@ int vi_hasprev(v_itr_t* const itr) {
  *    NULL or there are no more elements in the iterator.
  **/
 void* vi_next(v_itr_t* const itr) {
-   void *target;
-
-   if(!itr) return NULL;
-
    /* If there are more elements */
    if(!vi_hasnext(itr)) return NULL;
 
-   target = itr->vector->__elements[itr->pos];
-   itr->pos++;
+   itr->__last = -1;
 
-   return target;
+   return __v_elem(itr->__vector, itr->__pos++);
 }
 
 
@@ -560,16 +2176,57 @@ void* vi_next(v_itr_t* const itr) {
  *    is NULL or there are no previous elements in the iterator.
  **/
 void* vi_prev(v_itr_t* const itr) {
-   void *target;
+   /* If there are previous elements */
+   if(!vi_hasprev(itr)) return NULL;
 
-   if(!itr) return NULL;
+   itr->__last = 0;
 
-   /* If there are more elements */
-   if(!vi_hasprev(itr)) return NULL;
+   return __v_elem(itr->__vector, --itr->__pos);
+}
 
-   target = itr->vector->__elements[itr->pos];
-   itr->pos--;
 
-   return target;
+/**
+ * Inserts an element at the iterator's cursor, shifting the elements after
+ * it right. A following vi_next(...) is unaffected, while vi_prev(...) would
+ * return the new element.
+ *
+ * @param itr - the iterator to insert at.
+ * @param elem - the element to insert.
+ * @return 1 if the element was added. Returns 0 if the iterator is NULL or
+ *    upon allocation error.
+ **/
+int vi_add(v_itr_t* const itr, void* const elem) {
+   if(!itr) return !ADDED;
+
+   if(!v_add(itr->__vector, itr->__pos, elem))
+      return !ADDED;
+
+   itr->__pos++;
+   itr->__last = 1;
+
+   return ADDED;
 }
 
+
+/**
+ * Removes the element most recently returned by vi_next(...) or vi_prev(...),
+ * shifting the elements after it left. May be called once per call to either.
+ * For inline vectors the returned element is only valid until the vector is
+ * next modified, as with v_rem(...).
+ *
+ * @param itr - the iterator to remove through.
+ * @return the removed element. Returns NULL if the iterator is NULL or there
+ *    is no element to remove.
+ **/
+void* vi_rem(v_itr_t* const itr) {
+   ds_idx_t index;
+
+   if(!itr || itr->__last > 0) return NULL;
+
+   index = itr->__pos + itr->__last;
+
+   itr->__pos = index;
+   itr->__last = 1;
+
+   return v_rem(itr->__vector, index);
+}
@@ -0,0 +1,315 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+#include <stdlib.h>     /* For malloc(...), free(...) */
+#include <stddef.h>     /* For ptrdiff_t */
+#include <stdatomic.h>  /* For atomic_ptrdiff_t, atomic_*(...) */
+#include "wsdeque.h"
+
+
+#define ADDED 1
+#define CACHE_LINE 64
+#define INIT_SIZE 32    /* Initial capacity; must be a power of two */
+
+
+/**
+ * Internal buffer type. Only used in this file.
+ *
+ * A circular buffer of __mask + 1 slots; position i of the deque lives in
+ * slot (i & __mask). When the owner grows the deque it copies the elements
+ * into a buffer twice the size, but a thief may still be reading the old
+ * one, so old buffers are chained through __prev and only freed along with
+ * the deque.
+ **/
+typedef struct __wsd_buf_s {
+   struct __wsd_buf_s *__prev;
+   ptrdiff_t __mask;
+   _Atomic(void*) __slots[];
+} __wsd_buf_t;
+
+
+/**
+ * Internal work-stealing deque definition. The deque holds the positions
+ * from __top up to (but not including) __bottom. Thieves advance __top; only
+ * the owner writes __bottom. Each is kept on its own cache line.
+ **/
+struct __wsd_s {
+   _Atomic(__wsd_buf_t*) __buf;
+   size_t __elem_size;
+   char __pad0[CACHE_LINE];
+   atomic_ptrdiff_t __top;
+   char __pad1[CACHE_LINE - sizeof(atomic_ptrdiff_t)];
+   atomic_ptrdiff_t __bottom;
+   char __pad2[CACHE_LINE - sizeof(atomic_ptrdiff_t)];
+};
+
+
+/* Local functions */
+static __wsd_buf_t* __wsd_buf(ptrdiff_t size, __wsd_buf_t* const prev);
+static __wsd_buf_t* __wsd_grow(wsd_t* const d, __wsd_buf_t* const buf,
+                               ptrdiff_t top, ptrdiff_t bottom);
+
+
+/**
+ * Allocate a buffer.
+ *
+ * @param size - the number of slots; a power of two.
+ * @param prev - the buffer this one replaces, or NULL.
+ * @return a pointer to the buffer. Returns NULL upon allocation error.
+ **/
+static __wsd_buf_t* __wsd_buf(ptrdiff_t size, __wsd_buf_t* const prev) {
+   __wsd_buf_t *buf;
+
+   buf = malloc(sizeof(__wsd_buf_t) + sizeof(_Atomic(void*)) * (size_t) size);
+
+   if(!buf) return NULL;
+
+   buf->__prev = prev;
+   buf->__mask = size - 1;
+
+   return buf;
+}
+
+
+/**
+ * A simulated constructor for a work-stealing deque. The thread that pushes
+ * the first element becomes the deque's owner.
+ *
+ * NOTE: This is a function that is not intended for use by the user. The user
+ * should instead use the macro wsd_init(type), where type is the type that
+ * the user wishes to restrict the deque to.
+ *
+ * @param __elem_size - the size of an element in the deque.
+ * @return a pointer to an empty deque. Returns a NULL pointer upon allocation
+ *    error.
+ **/
+wsd_t* __wsd_init(size_t __elem_size) {
+   wsd_t *deque;
+   __wsd_buf_t *buf;
+
+   deque = malloc(sizeof(wsd_t));
+
+   if(!deque) return NULL;
+
+   buf = __wsd_buf(INIT_SIZE, NULL);
+
+   if(!buf) {
+      free(deque);
+      return NULL;
+   }
+
+   atomic_init(&deque->__buf, buf);
+   deque->__elem_size = __elem_size;
+   atomic_init(&deque->__top, 0);
+   atomic_init(&deque->__bottom, 0);
+
+   return deque;
+}
+
+
+/**
+ * A simulated destructor for a work-stealing deque. Frees any elements
+ * remaining in the deque. Must not be called while other threads use the
+ * deque.
+ *
+ * @param d - the deque to destroy.
+ **/
+void wsd_free(wsd_t* const d) {
+   __wsd_buf_t *buf, *prev;
+
+   if(!d) return;
+
+   while(wsd_size(d) > 0)
+      free(wsd_pop(d));
+
+   for(buf = atomic_load_explicit(&d->__buf, memory_order_relaxed); buf;
+       buf = prev) {
+      prev = buf->__prev;
+      free(buf);
+   }
+
+   free(d);
+}
+
+
+/**
+ * Retrieve the size of a work-stealing deque. While other threads are
+ * stealing, the result is only a snapshot.
+ *
+ * @param d - the deque to retrieve the size of.
+ * @return the number of elements in the deque. Returns -1 if the deque is
+ *    NULL.
+ **/
+ds_idx_t wsd_size(wsd_t* const d) {
+   ptrdiff_t top, bottom;
+
+   if(!d) return -1;
+
+   top = atomic_load_explicit(&d->__top, memory_order_acquire);
+   bottom = atomic_load_explicit(&d->__bottom, memory_order_acquire);
+
+   /* The owner may have claimed the last element with a pop in progress */
+   return (bottom > top ? (ds_idx_t) (bottom - top) : 0);
+}
+
+
+/**
+ * Move the deque into a buffer twice the size of the current one. Called by
+ * the owner only; thieves keep working on the old buffer until they see the
+ * new one, and see the same elements in either.
+ *
+ * @param d - the deque to grow.
+ * @param buf - the current buffer.
+ * @param top - the top position read by the owner.
+ * @param bottom - the bottom position.
+ * @return the new buffer. Returns NULL upon allocation error, in which case
+ *    the deque is left unchanged.
+ **/
+static __wsd_buf_t* __wsd_grow(wsd_t* const d, __wsd_buf_t* const buf,
+                               ptrdiff_t top, ptrdiff_t bottom) {
+   __wsd_buf_t *grown;
+   ptrdiff_t i;
+
+   grown = __wsd_buf(2 * (buf->__mask + 1), buf);
+
+   if(!grown) return NULL;
+
+   for(i = top; i < bottom; i++)
+      atomic_store_explicit(&grown->__slots[i & grown->__mask],
+                            atomic_load_explicit(&buf->__slots[i & buf->__mask],
+                                                 memory_order_relaxed),
+                            memory_order_relaxed);
+
+   atomic_store_explicit(&d->__buf, grown, memory_order_release);
+
+   return grown;
+}
+
+
+/**
+ * Push an element onto the bottom of the deque. Owner only.
+ *
+ * @param d - the deque to push the element onto.
+ * @param elem - the element to push.
+ * @return 1 if the element was pushed. Returns 0 if either parameter is NULL
+ *    or upon allocation error.
+ **/
+int wsd_push(wsd_t* const d, void* const elem) {
+   __wsd_buf_t *buf;
+   ptrdiff_t top, bottom;
+
+   if(!d || !elem) return !ADDED;
+
+   bottom = atomic_load_explicit(&d->__bottom, memory_order_relaxed);
+   top = atomic_load_explicit(&d->__top, memory_order_acquire);
+   buf = atomic_load_explicit(&d->__buf, memory_order_relaxed);
+
+   if(bottom - top > buf->__mask &&
+      !(buf = __wsd_grow(d, buf, top, bottom)))
+      return !ADDED;
+
+   atomic_store_explicit(&buf->__slots[bottom & buf->__mask], elem,
+                         memory_order_relaxed);
+
+   /* Publish the element along with the new bottom */
+   atomic_store_explicit(&d->__bottom, bottom + 1, memory_order_release);
+
+   return ADDED;
+}
+
+
+/**
+ * Remove and return the element at the bottom of the deque, the one pushed
+ * most recently. Owner only.
+ *
+ * @param d - the deque to pop the element from.
+ * @return the element at the bottom of the deque. Returns NULL if the deque
+ *    is empty or NULL, or if thieves took its last element first.
+ **/
+void* wsd_pop(wsd_t* const d) {
+   __wsd_buf_t *buf;
+   ptrdiff_t top, bottom;
+   void *elem;
+
+   if(!d) return NULL;
+
+   bottom = atomic_load_explicit(&d->__bottom, memory_order_relaxed) - 1;
+   buf = atomic_load_explicit(&d->__buf, memory_order_relaxed);
+
+   /* Claim the bottom element before looking at the top */
+   atomic_store_explicit(&d->__bottom, bottom, memory_order_relaxed);
+   atomic_thread_fence(memory_order_seq_cst);
+
+   top = atomic_load_explicit(&d->__top, memory_order_relaxed);
+
+   if(top > bottom) {
+      atomic_store_explicit(&d->__bottom, bottom + 1, memory_order_relaxed);
+      return NULL;
+   }
+
+   elem = atomic_load_explicit(&buf->__slots[bottom & buf->__mask],
+                              memory_order_relaxed);
+
+   /* The last element; race thieves for it by advancing the top */
+   if(top == bottom) {
+      if(!atomic_compare_exchange_strong_explicit(&d->__top, &top, top + 1,
+                                                  memory_order_seq_cst,
+                                                  memory_order_relaxed))
+         elem = NULL;
+
+      atomic_store_explicit(&d->__bottom, bottom + 1, memory_order_relaxed);
+   }
+
+   return elem;
+}
+
+
+/**
+ * Remove and return the element at the top of the deque, the oldest one.
+ * Safe to call from any thread, concurrently with the owner and other
+ * thieves.
+ *
+ * @param d - the deque to steal the element from.
+ * @return the element at the top of the deque. Returns NULL if the deque is
+ *    empty or NULL, or if another thread took the element first; a thief
+ *    would then usually move on to another deque.
+ **/
+void* wsd_steal(wsd_t* const d) {
+   __wsd_buf_t *buf;
+   ptrdiff_t top, bottom;
+   void *elem;
+
+   if(!d) return NULL;
+
+   top = atomic_load_explicit(&d->__top, memory_order_acquire);
+   atomic_thread_fence(memory_order_seq_cst);
+   bottom = atomic_load_explicit(&d->__bottom, memory_order_acquire);
+
+   if(top >= bottom) return NULL;
+
+   buf = atomic_load_explicit(&d->__buf, memory_order_acquire);
+   elem = atomic_load_explicit(&buf->__slots[top & buf->__mask],
+                              memory_order_relaxed);
+
+   if(!atomic_compare_exchange_strong_explicit(&d->__top, &top, top + 1,
+                                               memory_order_seq_cst,
+                                               memory_order_relaxed))
+      return NULL;
+
+   return elem;
+}
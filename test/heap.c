@@ -0,0 +1,133 @@
+/**
+ * libdstructs: a simple, generic data structures library written in ANSI C.
+ *
+ * Copyright (C) 2013, 2014 Evan Bezeredi <bezeredi.dev@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see {http://www.gnu.org/licenses/}.
+ **/
+/**
+ * Regression tests for the heap, run by make check. Exits with the number of
+ * failed checks.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include "heap.h"
+#include "vector.h"
+
+
+static int failed = 0;
+
+#define CHECK(cond) \
+   ((cond) ? (void) 0 : \
+    (void) (fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond), \
+            failed++))
+
+
+static int cmp_int(const void* a, const void* b, size_t size) {
+   (void) size;
+
+   return (*(const int*) a > *(const int*) b) -
+          (*(const int*) a < *(const int*) b);
+}
+
+
+static int* new_int(int val) {
+   int *elem;
+
+   elem = malloc(sizeof(int));
+
+   if(elem) *elem = val;
+
+   return elem;
+}
+
+
+/* hp_heapify(...) moves the elements over, so each is freed exactly once */
+static void test_heapify_ownership(void) {
+   heap_t *heap;
+   vect_t *v;
+   int i;
+
+   heap = hp_init(int, cmp_int);
+   v = v_init(int);
+
+   for(i = 0; i < 100; i++)
+      v_push(v, new_int(99 - i));
+
+   CHECK(hp_heapify(heap, v) == 0);
+   CHECK(v_size(v) == 0);
+   CHECK(hp_size(heap) == 100);
+   CHECK(*(int*) hp_top(heap) == 0);
+
+   v_free(v);
+   hp_free(heap);
+}
+
+
+/* Inline vectors keep their elements' storage and are rejected */
+static void test_heapify_inline(void) {
+   heap_t *heap;
+   vect_t *v;
+   int i;
+
+   heap = hp_init(int, cmp_int);
+   v = v_init_inline(int);
+
+   for(i = 0; i < 10; i++)
+      v_push(v, &i);
+
+   CHECK(hp_heapify(heap, v) == -1);
+   CHECK(v_size(v) == 10);
+   CHECK(hp_size(heap) == 0);
+
+   v_free(v);
+   hp_free(heap);
+}
+
+
+/* An empty vector leaves the heap, and its parked handles, untouched */
+static void test_heapify_empty(void) {
+   heap_t *heap;
+   vect_t *v;
+   int hdl;
+
+   heap = hp_init(int, cmp_int);
+   v = v_init(int);
+
+   CHECK(hp_heapify(heap, v) == 0);
+   CHECK(hp_size(heap) == 0);
+   CHECK(hp_top(heap) == NULL);
+
+   hp_push(heap, new_int(3));
+   hdl = hp_push(heap, new_int(1));
+   hp_push(heap, new_int(2));
+   free(hp_pop(heap));
+
+   CHECK(hp_heapify(heap, v) == 3);
+   CHECK(hp_size(heap) == 2);
+   CHECK(*(int*) hp_top(heap) == 2);
+   CHECK(hp_get(heap, hdl) == NULL);
+
+   v_free(v);
+   hp_free(heap);
+}
+
+
+int main(void) {
+   test_heapify_ownership();
+   test_heapify_inline();
+   test_heapify_empty();
+
+   return failed;
+}